@@ -0,0 +1,120 @@
+/*
+*   Benchmark32bitI2S
+*
+*   Created: 2026
+*   Purpose: Measure the extra CPU cost of moving the audio over I2S as 32-bit words (for 24-bit or
+*      32-bit codec data) instead of as 16-bit words.  For each block size, it times the pieces of
+*      the I2S classes that depend on the word size:
+*         * Input: the de-interleaving and int-to-float conversion (2 and 4 channels)
+*         * Output: the float-to-int conversion (arm_scale_f32 for 16-bit, arm_float_to_q31 for 32-bit)
+*         * DMA: the copy of each raw block out of the DMA buffer (twice as many bytes for 32-bit)
+*      It reports the CPU cycles per sample for each.
+*
+*      To actually use 32-bit transfers in your own sketch, give the word length to AudioSettings_F32:
+*          AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples, 24);  //or 32
+*
+*   No audio is processed.  Just open the Serial Monitor to see the results.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+#define MAX_N_CHAN 4
+#define MAX_BLOCK_SAMPLES 128
+#define N_REPEAT 100                //number of times to repeat each test (to average out the timing)
+
+int16_t raw_i16[MAX_N_CHAN*MAX_BLOCK_SAMPLES];  //like the DMA buffer for 16-bit transfers
+int32_t raw_i32[MAX_N_CHAN*MAX_BLOCK_SAMPLES];  //like the DMA buffer for 32-bit transfers
+int32_t raw_copy[MAX_N_CHAN*MAX_BLOCK_SAMPLES]; //like the staging buffer that the raw data is copied into
+float32_t chan_data[MAX_N_CHAN][MAX_BLOCK_SAMPLES], out_data[MAX_BLOCK_SAMPLES];
+
+// Fill the raw buffers with test values
+void fillRawBuffers(void) {
+  for (int i=0; i < MAX_N_CHAN*MAX_BLOCK_SAMPLES; i++) {
+    raw_i32[i] = (int32_t)(random(-1000000,1000000)) * 1000;
+    raw_i16[i] = (int16_t)(raw_i32[i] >> 16);
+  }
+  for (int i=0; i < MAX_BLOCK_SAMPLES; i++) chan_data[0][i] = ((float32_t)random(-1000,1000))/1000.0f;
+}
+
+// Print one result as cycles per sample
+void printResult(const char *name, uint32_t cycles, int n_samples) {
+  Serial.print("    "); Serial.print(name); Serial.print(" = ");
+  Serial.print(((float)cycles)/((float)(N_REPEAT*n_samples)),2);
+  Serial.println(" cycles/sample");
+}
+
+// Time the input de-interleaving for the given number of channels
+template <int N_CHAN>
+void benchmarkInput(int block_samples) {
+  float32_t *dest[N_CHAN];
+  for (int c=0; c < N_CHAN; c++) dest[c] = chan_data[c];
+
+  uint32_t start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) AudioInputI2SBase_F32::deinterleave_i16_to_f32<N_CHAN>(raw_i16, dest, block_samples);
+  uint32_t cycles_i16 = ARM_DWT_CYCCNT - start_cycles;
+
+  start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) AudioInputI2SBase_F32::deinterleave_i32_to_f32<N_CHAN>(raw_i32, dest, block_samples);
+  uint32_t cycles_i32 = ARM_DWT_CYCCNT - start_cycles;
+
+  Serial.print("  Input, "); Serial.print(N_CHAN); Serial.println(" channels:");
+  printResult("16-bit", cycles_i16, N_CHAN*block_samples);
+  printResult("32-bit", cycles_i32, N_CHAN*block_samples);
+}
+
+// Time the output conversion for one channel
+void benchmarkOutput(int block_samples) {
+  uint32_t start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) AudioOutputI2S_F32::scale_f32_to_i16(chan_data[0], out_data, block_samples);
+  uint32_t cycles_i16 = ARM_DWT_CYCCNT - start_cycles;
+
+  start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) AudioOutputI2S_F32::convert_f32_to_q31(chan_data[0], out_data, block_samples);
+  uint32_t cycles_i32 = ARM_DWT_CYCCNT - start_cycles;
+
+  Serial.println("  Output, per channel:");
+  printResult("16-bit", cycles_i16, block_samples);
+  printResult("32-bit", cycles_i32, block_samples);
+}
+
+// Time the copy of the raw (stereo) data out of the DMA buffer
+void benchmarkCopy(int block_samples) {
+  const int n_samples = 2*block_samples;
+  uint32_t start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) memcpy(raw_copy, raw_i16, n_samples*sizeof(int16_t));
+  uint32_t cycles_i16 = ARM_DWT_CYCCNT - start_cycles;
+
+  start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) memcpy(raw_copy, raw_i32, n_samples*sizeof(int32_t));
+  uint32_t cycles_i32 = ARM_DWT_CYCCNT - start_cycles;
+
+  Serial.println("  DMA buffer copy, stereo:");
+  printResult("16-bit", cycles_i16, n_samples);
+  printResult("32-bit", cycles_i32, n_samples);
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  Serial.begin(115200); delay(1000);
+  Serial.println("Benchmark32bitI2S: starting...");
+  Serial.print("  CPU (MHz) = "); Serial.println(F_CPU_ACTUAL / 1000000);
+  Serial.println();
+  fillRawBuffers();
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+  const int block_sizes[] = {16, 32, 128};
+  for (int i=0; i < 3; i++) {
+    Serial.print("Block size = "); Serial.println(block_sizes[i]);
+    benchmarkInput<2>(block_sizes[i]);
+    benchmarkInput<4>(block_sizes[i]);
+    benchmarkOutput(block_sizes[i]);
+    benchmarkCopy(block_sizes[i]);
+  }
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,146 @@
+/*
+*   BenchmarkBlockOverhead
+*
+*   Created: 2026
+*   Purpose: Measure the fixed cost that every audio object pays on every audio block (the update()
+*      dispatch, allocating and releasing the blocks, transmitting them), which is what limits very
+*      short, low-latency blocks.  For block sizes of 8, 16, 32, and 128 samples, it reports:
+*         * the overhead per object per block for an object that does no work (a pass-through)
+*         * the cost per object per block for a simple gain (AudioEffectGain_F32)
+*      each using the Teensy Audio library's normal update dispatch and using the flat dispatch
+*      (see AudioStream_F32::setFlatUpdateDispatch()), with the memory pool in small-block mode.
+*
+*      To use the small-block mode in your own low-latency sketch:
+*          AudioSettings_F32 audio_settings(sample_rate_Hz, 16);
+*          audio_settings.small_block_memory = true;          //do this before creating the audio objects
+*          ...
+*          AudioStream_F32::setFlatUpdateDispatch(true);      //in setup()
+*
+*   No audio is processed.  The audio objects are called directly, so just open the Serial Monitor to see the results.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+#define N_CHAIN 16                  //number of objects in each chain
+#define N_REPEAT 1000               //number of times to run the chain (to average out the timing)
+
+extern void software_isr(void);     //the Teensy Audio library's normal update dispatch (from the Teensy core)
+
+//an audio object that does nothing except pass the audio along
+class AudioPassThrough_F32 : public AudioStream_F32 {
+  public:
+    AudioPassThrough_F32(void) : AudioStream_F32(1, inputQueueArray_f32) {}
+    void update(void) {
+      audio_block_f32_t *block = AudioStream_F32::receiveReadOnly_f32();
+      if (!block) return;
+      AudioStream_F32::transmit(block);
+      AudioStream_F32::release(block);
+    }
+  private:
+    audio_block_f32_t *inputQueueArray_f32[1];
+};
+
+//an audio object that starts each chain with a new block of the requested length
+class AudioBlockSource_F32 : public AudioStream_F32 {
+  public:
+    AudioBlockSource_F32(void) : AudioStream_F32(0, NULL) {}
+    void update(void) {
+      audio_block_f32_t *block = AudioStream_F32::allocate_f32();
+      if (!block) return;
+      block->length = block_len;
+      arm_fill_f32(0.001f, block->data, block_len);
+      AudioStream_F32::transmit(block);
+      AudioStream_F32::release(block);
+    }
+    int block_len = 16;
+};
+
+//create the two chains of audio objects
+AudioBlockSource_F32  sourcePass, sourceGain;
+AudioPassThrough_F32  pass[N_CHAIN];
+AudioEffectGain_F32   gain[N_CHAIN];
+AudioConnection_F32   *patchCords[2*N_CHAIN];
+AudioStream_F32       *passChain[N_CHAIN], *gainChain[N_CHAIN];  //pointers to the objects in each chain
+
+void setChainActive(AudioStream_F32 &source, AudioStream_F32 **chain, bool active) {
+  source.setActive(active);
+  for (int i=0; i < N_CHAIN; i++) chain[i]->setActive(active);
+}
+
+// Time N_REPEAT updates of all of the active objects.  Returns the total cycles.
+uint32_t timeDispatch(bool use_flat) {
+  uint32_t start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) {
+    if (use_flat) {
+      AudioStream_F32::update_all_flat();
+    } else {
+      software_isr();
+    }
+  }
+  return ARM_DWT_CYCCNT - start_cycles;
+}
+
+// Measure one chain for one block size and report the cost per object per block
+void benchmarkChain(const char *name, AudioBlockSource_F32 &source, AudioStream_F32 **chain, int block_len, bool use_flat) {
+  source.block_len = block_len;
+
+  //time the source by itself, then the source plus the chain
+  setChainActive(source, chain, false);
+  source.setActive(true);
+  uint32_t source_cycles = timeDispatch(use_flat);
+  setChainActive(source, chain, true);
+  uint32_t total_cycles = timeDispatch(use_flat);
+  setChainActive(source, chain, false);
+
+  float cycles_per_obj = ((float)total_cycles - (float)source_cycles) / ((float)(N_REPEAT*N_CHAIN));
+  Serial.print("    "); Serial.print(name); Serial.print(use_flat ? ", flat dispatch   : " : ", Teensy dispatch : ");
+  Serial.print(cycles_per_obj,1); Serial.print(" cycles/object/block = ");
+  Serial.print(cycles_per_obj / ((float)block_len),2); Serial.println(" cycles/object/sample");
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  Serial.begin(115200); delay(1000);
+  Serial.println("BenchmarkBlockOverhead: starting...");
+  Serial.print("  CPU (MHz) = "); Serial.println(F_CPU_ACTUAL / 1000000);
+  Serial.print("  Objects per chain = "); Serial.println(N_CHAIN);
+  Serial.println();
+
+  //connect the chains
+  for (int i=0; i < N_CHAIN; i++) {
+    passChain[i] = &pass[i];
+    gainChain[i] = &gain[i];
+    if (i == 0) {
+      patchCords[2*i]   = new AudioConnection_F32(sourcePass, 0, pass[0], 0);
+      patchCords[2*i+1] = new AudioConnection_F32(sourceGain, 0, gain[0], 0);
+    } else {
+      patchCords[2*i]   = new AudioConnection_F32(pass[i-1], 0, pass[i], 0);
+      patchCords[2*i+1] = new AudioConnection_F32(gain[i-1], 0, gain[i], 0);
+    }
+    gain[i].setGain(1.0f);
+  }
+  setChainActive(sourcePass, passChain, false);
+  setChainActive(sourceGain, gainChain, false);
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+  const int block_sizes[] = {8, 16, 32, 128};
+  for (int i=0; i < 4; i++) {
+    //size the memory pool to exactly this block size
+    AudioSettings_F32 settings(44100.0f, block_sizes[i]);
+    settings.small_block_memory = true;
+    AudioMemory_F32(10, settings);
+
+    Serial.print("Block size = "); Serial.println(block_sizes[i]);
+    for (int flat = 0; flat < 2; flat++) {
+      benchmarkChain("Pass-through", sourcePass, passChain, block_sizes[i], flat);
+      benchmarkChain("Gain        ", sourceGain, gainChain, block_sizes[i], flat);
+    }
+  }
+  Serial.println();
+  delay(5000);
+}
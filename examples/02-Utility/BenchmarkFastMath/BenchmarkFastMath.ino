@@ -0,0 +1,95 @@
+/*
+*   BenchmarkFastMath
+*
+*   Created: 2026
+*   Purpose: Measure the speed and the accuracy of the fast dB, log, and exp conversions that are
+*      in the Tympan Library's utility/FastMath_F32.h.  For each kernel and for each precision
+*      setting, it reports the number of CPU cycles per sample and the maximum error relative to
+*      the standard math library.
+*
+*   No audio is processed.  Just open the Serial Monitor to see the results.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+#include <utility/FastMath_F32.h>   //from the Tympan Library
+
+#define N_SAMPLES 1024              //number of samples per test block
+float32_t x_buff[N_SAMPLES], y_buff[N_SAMPLES];
+
+// Fill the input buffer with test values that span the range of interest (log-spaced or linear-spaced)
+void fillLogSpaced(float32_t *x, int n, float min_val, float max_val) {
+  for (int i=0; i < n; i++) x[i] = min_val * powf(max_val/min_val, ((float)i)/((float)(n-1)));
+}
+void fillLinSpaced(float32_t *x, int n, float min_val, float max_val) {
+  for (int i=0; i < n; i++) x[i] = min_val + (max_val-min_val)*((float)i)/((float)(n-1));
+}
+
+// Time one block kernel and compare its output to the reference function.  Returns the max error.
+typedef void (*BlockKernel)(const float32_t *, float32_t *, int);
+typedef double (*RefFunction)(double);
+void benchmarkKernel(const char *name, BlockKernel kernel, RefFunction ref, bool relative_error) {
+  //time the kernel
+  uint32_t start_cycles = ARM_DWT_CYCCNT;
+  kernel(x_buff, y_buff, N_SAMPLES);
+  uint32_t elapsed_cycles = ARM_DWT_CYCCNT - start_cycles;
+
+  //assess the accuracy
+  double max_err = 0.0;
+  for (int i=0; i < N_SAMPLES; i++) {
+    double truth = ref((double)x_buff[i]);
+    double err = fabs((double)y_buff[i] - truth);
+    if (relative_error) err /= max(1.0e-30, fabs(truth));
+    max_err = max(max_err, err);
+  }
+
+  //report
+  Serial.print("  "); Serial.print(name); 
+  Serial.print(": cycles/sample = "); Serial.print(((float)elapsed_cycles)/((float)N_SAMPLES), 2);
+  Serial.print(relative_error ? ", max rel error = " : ", max abs error = "); Serial.println(max_err, 8);
+}
+
+//reference functions (in double precision)
+double ref_log2(double x)        { return log2(x); }
+double ref_exp2(double x)        { return exp2(x); }
+double ref_sqrt(double x)        { return sqrt(x); }
+double ref_tanh(double x)        { return tanh(x); }
+double ref_db_from_pow(double x) { return 10.0*log10(x); }
+double ref_db_from_amp(double x) { return 20.0*log10(x); }
+double ref_amp_from_db(double x) { return pow(10.0, x/20.0); }
+
+template <int P>
+void benchmarkAllKernels(const char *prec_name) {
+  Serial.print("Precision: "); Serial.println(prec_name);
+  fillLogSpaced(x_buff, N_SAMPLES, 1.0e-12f, 1.0e3f);
+  benchmarkKernel("log2       ", FastMath::log2<P>,        ref_log2,        false);
+  benchmarkKernel("db_from_pow", FastMath::db_from_pow<P>, ref_db_from_pow, false);
+  benchmarkKernel("db_from_amp", FastMath::db_from_amp<P>, ref_db_from_amp, false);
+  benchmarkKernel("sqrt       ", FastMath::sqrt<P>,        ref_sqrt,        true);
+  fillLinSpaced(x_buff, N_SAMPLES, -40.0f, 40.0f);
+  benchmarkKernel("exp2       ", FastMath::exp2<P>,        ref_exp2,        true);
+  fillLinSpaced(x_buff, N_SAMPLES, -120.0f, 40.0f);
+  benchmarkKernel("amp_from_db", FastMath::amp_from_db<P>, ref_amp_from_db, true);
+  fillLinSpaced(x_buff, N_SAMPLES, -6.0f, 6.0f);
+  benchmarkKernel("tanh       ", FastMath::tanh<P>,        ref_tanh,        false);
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  Serial.begin(115200); delay(1000);
+  Serial.println("BenchmarkFastMath: starting...");
+  Serial.print("  CPU (MHz) = "); Serial.println(F_CPU_ACTUAL / 1000000);
+  Serial.print("  Samples per test = "); Serial.println(N_SAMPLES);
+  Serial.println();
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+  benchmarkAllKernels<FastMath::PREC_FAST>("PREC_FAST");
+  benchmarkAllKernels<FastMath::PREC_ACCURATE>("PREC_ACCURATE");
+  benchmarkAllKernels<FastMath::PREC_EXACT>("PREC_EXACT");
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,69 @@
+/*
+*   BenchmarkOutputDither
+*
+*   Created: 2026
+*   Purpose: Measure the CPU cost of the output conversion (float to 16-bit) with and without dither
+*      and noise shaping.  For each block size, it times:
+*         * plain scaling (the default, no dither)
+*         * TPDF dither
+*         * TPDF dither with 1st-order noise shaping
+*         * TPDF dither with 2nd-order noise shaping
+*      It reports the CPU cycles per sample for each.  This conversion runs in the output's update(),
+*      not in its ISR.
+*
+*      To use dither in your own sketch (for 16-bit output only), set it on your output object:
+*          i2s_out.setDither(AudioOutputI2S_F32::DITHER_TPDF);
+*          i2s_out.setNoiseShaping(1);   //optional: 0 (off), 1, or 2
+*
+*   No audio is processed.  Just open the Serial Monitor to see the results.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+#define MAX_BLOCK_SAMPLES 128
+#define N_REPEAT 100                //number of times to repeat each test (to average out the timing)
+
+float32_t in_data[MAX_BLOCK_SAMPLES], out_data[MAX_BLOCK_SAMPLES];
+AudioOutputDither_F32 dither;       //the same dither that each output runs in its update(), but without any audio hardware
+
+// Time the output conversion with the given dither settings
+void benchmarkConversion(const char *name, int dither_type, int shaping_order, int block_samples) {
+  dither.setDither(dither_type);
+  dither.setNoiseShaping(shaping_order);
+
+  uint32_t start_cycles = ARM_DWT_CYCCNT;
+  for (int r=0; r < N_REPEAT; r++) dither.scale_f32_to_i16_auto(in_data, out_data, block_samples, 0);
+  uint32_t cycles = ARM_DWT_CYCCNT - start_cycles;
+
+  Serial.print("    "); Serial.print(name); Serial.print(" = ");
+  Serial.print(((float)cycles)/((float)(N_REPEAT*block_samples)),2);
+  Serial.println(" cycles/sample");
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  Serial.begin(115200); delay(1000);
+  Serial.println("BenchmarkOutputDither: starting...");
+  Serial.print("  CPU (MHz) = "); Serial.println(F_CPU_ACTUAL / 1000000);
+  Serial.println();
+
+  //a quiet test signal (a few LSBs), which is where the dither matters
+  for (int i=0; i < MAX_BLOCK_SAMPLES; i++) in_data[i] = 0.0001f * sinf(2.0f * 3.14159265f * ((float)i) / 32.0f);
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+  const int block_sizes[] = {16, 32, 128};
+  for (int i=0; i < 3; i++) {
+    Serial.print("Block size = "); Serial.println(block_sizes[i]);
+    benchmarkConversion("No dither              ", AudioOutputI2S_F32::DITHER_NONE, 0, block_sizes[i]);
+    benchmarkConversion("TPDF dither            ", AudioOutputI2S_F32::DITHER_TPDF, 0, block_sizes[i]);
+    benchmarkConversion("TPDF + 1st-order shaped", AudioOutputI2S_F32::DITHER_TPDF, 1, block_sizes[i]);
+    benchmarkConversion("TPDF + 2nd-order shaped", AudioOutputI2S_F32::DITHER_TPDF, 2, block_sizes[i]);
+  }
+  Serial.println();
+  delay(5000);
+}
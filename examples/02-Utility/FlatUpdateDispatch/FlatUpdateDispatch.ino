@@ -0,0 +1,102 @@
+/*
+*   FlatUpdateDispatch
+*
+*   Created: 2026
+*   Purpose: Run a short-block (16 sample) audio chain through the real I2S interrupts using the flat
+*      update dispatch (see AudioStream_F32::setFlatUpdateDispatch()).  The audio goes from the inputs,
+*      through a chain of gain blocks, to the outputs.  Over the Serial Monitor, you can switch between
+*      the flat dispatch and the Teensy Audio library's normal dispatch while the audio keeps running,
+*      and compare the CPU usage of the two.
+*
+*      Send these characters over the Serial Monitor:
+*         'f' = use the flat dispatch
+*         'F' = use the flat dispatch, but skip the per-object CPU measurement
+*         't' = use the Teensy Audio library's normal dispatch
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+#define N_GAIN 8                    //number of gain blocks in the chain
+
+//set the sample rate and block size
+const float sample_rate_Hz = 44100.0f;
+const int audio_block_samples = 16;  //short blocks, for low latency
+AudioSettings_F32 smallBlockSettings(void) {
+  AudioSettings_F32 settings(sample_rate_Hz, audio_block_samples);
+  settings.small_block_memory = true;  //size each memory block to exactly audio_block_samples
+  return settings;
+}
+AudioSettings_F32 audio_settings = smallBlockSettings();  //small-block mode must be set before the audio objects are created
+
+// define audio classes
+Tympan                    myTympan(TympanRev::F, audio_settings);   //do TympanRev::D or E or F
+AudioInputI2S_F32         i2s_in(audio_settings);       //Digital audio in *from* the Teensy Audio Board ADC.
+AudioEffectGain_F32       gain[N_GAIN];                 //a chain of simple gains
+AudioOutputI2S_F32        i2s_out(audio_settings);      //Digital audio out *to* the Teensy Audio Board DAC.  Always list last to minimize latency
+AudioConnection_F32       *patchCords[N_GAIN+2];
+
+// switch the dispatch and report what happened
+void setDispatch(bool use_flat, bool measure_each) {
+  bool is_flat = AudioStream_F32::setFlatUpdateDispatch(use_flat, measure_each);
+  audio_settings.processorUsageMaxReset();
+  myTympan.print("Dispatch: "); myTympan.print(is_flat ? "flat" : "Teensy");
+  if (is_flat && !measure_each) myTympan.print(" (no per-object CPU measurement)");
+  myTympan.println();
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup(void)
+{
+  myTympan.beginBothSerial(); delay(1000);
+  myTympan.println("FlatUpdateDispatch: Starting setup()...");
+
+  //connect the chain: left input -> gains -> both outputs
+  patchCords[0] = new AudioConnection_F32(i2s_in, 0, gain[0], 0);
+  for (int i=1; i < N_GAIN; i++) patchCords[i] = new AudioConnection_F32(gain[i-1], 0, gain[i], 0);
+  patchCords[N_GAIN]   = new AudioConnection_F32(gain[N_GAIN-1], 0, i2s_out, 0);
+  patchCords[N_GAIN+1] = new AudioConnection_F32(gain[N_GAIN-1], 0, i2s_out, 1);
+  for (int i=0; i < N_GAIN; i++) gain[i].setGain(1.0f);
+
+  //allocate the dynamic memory for audio processing blocks
+  AudioMemory_F32(40, audio_settings);
+
+  //start the audio hardware (this starts the I2S interrupts, which run the updates)
+  myTympan.enable();
+  myTympan.inputSelect(TYMPAN_INPUT_ON_BOARD_MIC);
+  myTympan.volume_dB(0);
+  myTympan.setInputGain_dB(15.0);
+
+  //now that the audio is running, switch to the flat dispatch
+  setDispatch(true, true);
+
+  myTympan.println("Setup complete.  Send 'f', 'F', or 't' to change the dispatch.");
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop(void)
+{
+  //respond to the Serial Monitor
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'f') {
+      setDispatch(true, true);
+    } else if (c == 'F') {
+      setDispatch(true, false);
+    } else if (c == 't') {
+      setDispatch(false, true);
+    }
+  }
+
+  //print the CPU and memory every few seconds
+  static unsigned long last_millis = 0;
+  if ((millis() - last_millis) > 3000) {
+    last_millis = millis();
+    myTympan.print("Dispatch: "); myTympan.print(AudioStream_F32::getFlatUpdateDispatch() ? "flat  " : "Teensy");
+    myTympan.print(", CPU (%) = "); myTympan.print(audio_settings.processorUsage(), 1);
+    myTympan.print(", CPU max (%) = "); myTympan.print(audio_settings.processorUsageMax(), 1);
+    myTympan.print(", Memory (blocks) = "); myTympan.println(AudioMemoryUsage_F32());
+  }
+}
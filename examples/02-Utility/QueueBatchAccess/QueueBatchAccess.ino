@@ -0,0 +1,100 @@
+/*
+*   QueueBatchAccess
+*
+*   Created: 2026
+*   Purpose: Show how to move audio through the main loop in bursts, like an SD card writer or a BLE link
+*      that can only be serviced every so often.  The audio from the inputs goes into an AudioRecordQueue_F32.
+*      Every SERVICE_PERIOD_MSEC, the main loop takes everything in that queue with one readBlocks() call and
+*      hands it to an AudioPlayQueue_F32 with one writeBlocks() call.  The play queue then sends it to the
+*      outputs.  So, you should hear the input, delayed by the queues.
+*
+*      Every few seconds, it prints how full the queues are and the overrun and underrun counts.  Make
+*      SERVICE_PERIOD_MSEC longer (or the queues shorter) to see the overruns and underruns start.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+#define QUEUE_DEPTH 32              //blocks held by each queue
+#define N_PRIME 16                  //blocks to collect before starting the playback (the extra latency that rides out the bursts)
+#define SERVICE_PERIOD_MSEC 20      //how often the main loop moves the audio (a slow consumer, like an SD card or BLE)
+
+//set the sample rate and block size
+const float sample_rate_Hz = 44100.0f;
+const int audio_block_samples = 128;
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+// define audio classes
+Tympan                    myTympan(TympanRev::F, audio_settings);   //do TympanRev::D or E or F
+AudioInputI2S_F32         i2s_in(audio_settings);                   //Digital audio in *from* the Teensy Audio Board ADC.
+AudioRecordQueue_F32      recordQueue(audio_settings, QUEUE_DEPTH); //the audio interrupt fills this, the main loop empties it
+AudioPlayQueue_F32        playQueue(audio_settings, QUEUE_DEPTH);   //the main loop fills this, the audio interrupt empties it
+AudioOutputI2S_F32        i2s_out(audio_settings);                  //Digital audio out *to* the Teensy Audio Board DAC.  Always list last to minimize latency
+
+// Make all of the audio connections
+AudioConnection_F32       patchCord1(i2s_in, 0, recordQueue, 0);  //left input into the record queue
+AudioConnection_F32       patchCord2(playQueue, 0, i2s_out, 0);   //play queue to both outputs
+AudioConnection_F32       patchCord3(playQueue, 0, i2s_out, 1);
+
+// move everything that has been recorded over to the play queue, in one batch each way
+bool is_primed = false;
+void serviceQueues(void) {
+  if (!is_primed) {
+    if (recordQueue.available() < N_PRIME) return;  //keep collecting
+    is_primed = true;
+  }
+
+  audio_block_f32_t *blocks[QUEUE_DEPTH];
+  int n_read = recordQueue.readBlocks(blocks, QUEUE_DEPTH); //we now own these blocks
+
+  //this is where an SD writer or a BLE link would do its work on blocks[0] to blocks[n_read-1]
+
+  playQueue.writeBlocks(blocks, n_read);             //the play queue takes its own reference to each block...
+  AudioRecordQueue_F32::releaseBlocks(blocks, n_read); //...so we still release ours
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup(void)
+{
+  myTympan.beginBothSerial(); delay(1000);
+  myTympan.println("QueueBatchAccess: Starting setup()...");
+
+  //allocate the dynamic memory for audio processing blocks (enough for both queues to be full)
+  AudioMemory_F32(2*QUEUE_DEPTH + 20, audio_settings);
+
+  //start the audio hardware
+  myTympan.enable();
+  myTympan.inputSelect(TYMPAN_INPUT_ON_BOARD_MIC);
+  myTympan.volume_dB(0);
+  myTympan.setInputGain_dB(15.0);
+
+  //start recording
+  recordQueue.begin();
+
+  myTympan.println("Setup complete.");
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop(void)
+{
+  //move the audio in bursts
+  static unsigned long last_service_millis = 0;
+  if ((millis() - last_service_millis) >= SERVICE_PERIOD_MSEC) {
+    last_service_millis = millis();
+    serviceQueues();
+  }
+
+  //print the queue status every few seconds
+  static unsigned long last_print_millis = 0;
+  if ((millis() - last_print_millis) > 3000) {
+    last_print_millis = millis();
+    myTympan.print("Record queue: "); myTympan.print(recordQueue.available());
+    myTympan.print(" blocks, overruns = "); myTympan.print(recordQueue.getOverrunCount());
+    myTympan.print(".  Play queue: "); myTympan.print(playQueue.getQueueDepth() - playQueue.availableToWrite());
+    myTympan.print(" blocks, overruns = "); myTympan.print(playQueue.getOverrunCount());
+    myTympan.print(", underruns = "); myTympan.print(playQueue.getUnderrunCount());
+    myTympan.print(".  Memory (blocks) = "); myTympan.println(AudioMemoryUsage_F32());
+  }
+}
@@ -0,0 +1,73 @@
+/*
+*   TDM_MultiChannel
+*
+*   Created: 2026
+*   Purpose: Show how to use the generic TDM classes with a multi-channel codec or mic array.  Eight
+*      TDM slots are received, but only the first four are enabled (the other four cost no CPU).  The
+*      four mics are mixed together and sent to the first two slots of an 8-slot TDM output.  The
+*      other output slots are disabled, so they send silence.
+*
+*      Change the template parameters to match your codec: AudioInputTDM_F32<N_SLOTS, BITS>, where
+*      N_SLOTS is 2, 4, 8, or 16 and BITS is 16 or 32 (use 32 for 24-bit codecs).
+*
+*   HARDWARE: Teensy 4 (Tympan RevE or later) with an external TDM codec on the Teensy's SAI1 pins:
+*      pin 23 = MCLK, pin 21 = BCLK, pin 20 = frame sync, pin 8 = data in, pin 7 = data out.
+*      The TDM classes replace the I2S classes, so the Tympan's own AIC is not used here.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+//set the sample rate and block size
+const float sample_rate_Hz = 48000.0f;
+const int audio_block_samples = 32;
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+// define audio classes
+AudioInputTDM_F32<8>      tdm_in(audio_settings);   //8 slots of 16-bit data
+AudioMixer4_F32           mixer(audio_settings);    //combine the four mics
+AudioOutputTDM_F32<8>     tdm_out(audio_settings);  //8 slots of 16-bit data.  Always list last to minimize latency
+
+// Make all of the audio connections
+AudioConnection_F32  patchCord1(tdm_in, 0, mixer, 0);
+AudioConnection_F32  patchCord2(tdm_in, 1, mixer, 1);
+AudioConnection_F32  patchCord3(tdm_in, 2, mixer, 2);
+AudioConnection_F32  patchCord4(tdm_in, 3, mixer, 3);
+AudioConnection_F32  patchCord11(mixer, 0, tdm_out, 0);
+AudioConnection_F32  patchCord12(mixer, 0, tdm_out, 1);
+
+// define the setup() function, the function that is called once when the device is booting
+void setup(void)
+{
+  Serial.begin(115200); delay(1000);
+  Serial.println("TDM_MultiChannel: Starting setup()...");
+
+  //allocate the dynamic memory for audio processing blocks
+  AudioMemory_F32(20, audio_settings);
+
+  //only process the slots that we use
+  tdm_in.setAllSlotsEnabled(false);
+  for (int i=0; i < 4; i++) tdm_in.setSlotEnabled(i, true);
+  tdm_out.setAllSlotsEnabled(false);
+  tdm_out.setSlotEnabled(0, true);
+  tdm_out.setSlotEnabled(1, true);
+
+  //average the four mics
+  for (int i=0; i < 4; i++) mixer.gain(i, 0.25f);
+
+  Serial.print("Setup complete.  Input slots enabled: "); Serial.print(tdm_in.getNumEnabledSlots());
+  Serial.print(" of "); Serial.println(tdm_in.getNumSlots());
+}
+
+void loop(void)
+{
+  //print the CPU and memory every few seconds
+  static unsigned long last_millis = 0;
+  if ((millis() - last_millis) > 3000) {
+    last_millis = millis();
+    Serial.print("CPU (%) = "); Serial.print(audio_settings.processorUsage(), 1);
+    Serial.print(", Memory (blocks) = "); Serial.println(AudioMemoryUsage_F32());
+  }
+}
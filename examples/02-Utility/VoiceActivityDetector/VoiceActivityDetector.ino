@@ -0,0 +1,89 @@
+/*
+*   VoiceActivityDetector
+*
+*   Created: 2026
+*   Purpose: Demonstrate the AudioCalcVAD_F32 voice activity detector.  The VAD watches the microphone
+*      and publishes a speech probability for every audio block.  Here, it is given to the noise
+*      reduction so that the noise estimate is frozen while you're talking.
+*
+*   Send 'v' over the Serial Monitor to toggle whether the noise reduction uses the VAD.  The speech
+*   probability, the level, and the noise floor are printed a few times per second, and the CPU is
+*   printed every few seconds, so that you can see the effect.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+//set the sample rate and block size
+const float sample_rate_Hz = 24000.0f ; //24000 or 44117 (or other frequencies in the table in AudioOutputI2S_F32)
+const int audio_block_samples = 32;     //for freq domain processing, a power of 2: 16, 32, 64, 128
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+//create audio library objects for handling the audio.  Create the VAD first so that it updates first.
+Tympan                            myTympan(TympanRev::F, audio_settings);   //do TympanRev::D or E or F
+AudioInputI2S_F32                 i2s_in(audio_settings);                   //Digital audio *from* the Tympan AIC.
+AudioCalcVAD_F32                  vad(audio_settings);                      //voice activity detector
+AudioEffectNoiseReduction_FD_F32  noiseReduction(audio_settings);           //noise reduction in the frequency domain
+AudioOutputI2S_F32                i2s_out(audio_settings);                  //Digital audio *to* the Tympan AIC.
+
+//Make all of the audio connections
+AudioConnection_F32       patchCord1(i2s_in, 0, vad, 0);               //connect the Left input to the VAD
+AudioConnection_F32       patchCord2(vad, 0, noiseReduction, 0);       //the VAD passes the audio through, unchanged
+AudioConnection_F32       patchCord11(noiseReduction, 0, i2s_out, 0);  //connect to the left output
+AudioConnection_F32       patchCord12(noiseReduction, 0, i2s_out, 1);  //connect to the right output
+
+bool use_vad = true;
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  myTympan.beginBothSerial(); delay(1000);
+  Serial.println("VoiceActivityDetector: starting setup()...");
+
+  //allocate the audio memory
+  AudioMemory_F32(40, audio_settings);
+
+  //setup the noise reduction
+  int N_FFT = 4 * audio_block_samples;
+  noiseReduction.setup(audio_settings, N_FFT);
+  noiseReduction.setVAD(&vad, 0.5);  //freeze the noise estimate when the speech probability is above 0.5
+
+  //setup the VAD
+  vad.setSNRThreshold_dB(6.0);
+  vad.setHangover_sec(0.3);
+
+  //Enable the Tympan to start the audio flowing!
+  myTympan.enable(); // activate the AIC
+  myTympan.inputSelect(TYMPAN_INPUT_ON_BOARD_MIC); // use the on board microphones
+  myTympan.setInputGain_dB(15.0);
+  myTympan.volume_dB(0.0);
+
+  Serial.println("Setup complete.  Send 'v' to toggle whether the noise reduction uses the VAD.");
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+unsigned long last_print_millis = 0;
+void loop() {
+  //respond to Serial commands
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'v') {
+      use_vad = !use_vad;
+      noiseReduction.setVAD(use_vad ? &vad : NULL, 0.5);
+      Serial.print("Noise reduction using VAD = "); Serial.println(use_vad);
+    }
+  }
+
+  //print the VAD state
+  if ((millis() - last_print_millis) > 250) {
+    last_print_millis = millis();
+    Serial.print("Speech Prob = "); Serial.print(vad.getSpeechProb(), 2);
+    Serial.print(", Level = "); Serial.print(vad.getLevel_dBFS(), 1);
+    Serial.print(" dBFS, Floor = "); Serial.print(vad.getNoiseFloor_dBFS(), 1);
+    Serial.print(" dBFS, ZCR = "); Serial.print(vad.getZeroCrossingRate_Hz(), 0); Serial.println(" Hz");
+  }
+
+  //print the CPU
+  myTympan.printCPUandMemory(millis(), 3000); //print every 3000 msec
+}
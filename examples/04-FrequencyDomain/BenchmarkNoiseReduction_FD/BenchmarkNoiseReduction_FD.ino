@@ -0,0 +1,75 @@
+/*
+*   BenchmarkNoiseReduction_FD
+*
+*   Created: 2026
+*   Purpose: Measure the CPU cost (cycles per FFT hop) of the different noise estimators and gain
+*      rules in AudioEffectNoiseReduction_FD_F32, for FFT sizes from 128 to 1024.  It times only
+*      processAudioFD() (ie, the noise-reduction algorithm itself), not the FFT and IFFT.
+*
+*   No audio is processed.  Just open the Serial Monitor to see the results.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+const float sample_rate_Hz = 24000.0f ; //24000 or 44117 (or other frequencies in the table in AudioOutputI2S_F32)
+const int audio_block_samples = 32;     //for freq domain processing, a power of 2: 16, 32, 64, 128
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+#define N_HOPS 200                      //number of hops to time for each configuration
+float32_t complex_buff[2*1024];         //holds the fake FFT data (interleaved real and imaginary)
+
+//fill the FFT bins with random-ish values
+void fillSpectrum(float32_t *buff, int N_FFT) {
+  for (int i=0; i < 2*N_FFT; i++) buff[i] = 0.001f * (float32_t)random(-1000,1000);
+}
+
+//time the algorithm for one configuration.  Returns the cycles per hop.
+float benchmarkConfig(AudioEffectNoiseReduction_FD_F32 *noiseReduction, int N_FFT, int noise_est, int gain_rule, bool band_mode) {
+  noiseReduction->setNoiseEstimator(noise_est);
+  noiseReduction->setGainRule(gain_rule);
+  noiseReduction->setBandMode(band_mode);
+
+  uint32_t total_cycles = 0;
+  for (int Ihop = 0; Ihop < N_HOPS; Ihop++) {
+    fillSpectrum(complex_buff, N_FFT);  //the algorithm modifies the data, so refresh it every time (not timed)
+    uint32_t start_cycles = ARM_DWT_CYCCNT;
+    noiseReduction->processAudioFD(complex_buff);
+    total_cycles += (ARM_DWT_CYCCNT - start_cycles);
+  }
+  return ((float)total_cycles) / ((float)N_HOPS);
+}
+
+void benchmarkFFTSize(int N_FFT) {
+  AudioEffectNoiseReduction_FD_F32 *noiseReduction = new AudioEffectNoiseReduction_FD_F32(audio_settings);
+  if (noiseReduction->setup(audio_settings, N_FFT) != N_FFT) {
+    Serial.print("  N_FFT = "); Serial.print(N_FFT); Serial.println(": *** could not set up ***");
+    delete noiseReduction; return;
+  }
+  typedef AudioEffectNoiseReduction_FD_F32 NR;
+  Serial.print("  N_FFT = "); Serial.println(N_FFT);
+  Serial.print("    Attack/release + SNR threshold (default): cycles/hop = "); Serial.println(benchmarkConfig(noiseReduction, N_FFT, NR::NOISE_EST_ATTACK_RELEASE, NR::GAIN_RULE_SNR_THRESH, false), 1);
+  Serial.print("    Min statistics + SNR threshold          : cycles/hop = "); Serial.println(benchmarkConfig(noiseReduction, N_FFT, NR::NOISE_EST_MIN_STATS,      NR::GAIN_RULE_SNR_THRESH, false), 1);
+  Serial.print("    Min statistics + Wiener (DD)            : cycles/hop = "); Serial.println(benchmarkConfig(noiseReduction, N_FFT, NR::NOISE_EST_MIN_STATS,      NR::GAIN_RULE_WIENER_DD, false), 1);
+  Serial.print("    Min statistics + MMSE-STSA (DD)         : cycles/hop = "); Serial.println(benchmarkConfig(noiseReduction, N_FFT, NR::NOISE_EST_MIN_STATS,      NR::GAIN_RULE_MMSE_STSA_DD, false), 1);
+  Serial.print("    Min statistics + MMSE-STSA, ERB bands   : cycles/hop = "); Serial.println(benchmarkConfig(noiseReduction, N_FFT, NR::NOISE_EST_MIN_STATS,      NR::GAIN_RULE_MMSE_STSA_DD, true), 1);
+  delete noiseReduction;
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  Serial.begin(115200); delay(1000);
+  Serial.println("BenchmarkNoiseReduction_FD: starting...");
+  Serial.print("  CPU (MHz) = "); Serial.println(F_CPU_ACTUAL / 1000000);
+  Serial.print("  Hops per test = "); Serial.println(N_HOPS);
+  Serial.println();
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+  for (int N_FFT = 128; N_FFT <= 1024; N_FFT *= 2) benchmarkFFTSize(N_FFT);
+  Serial.println();
+  delay(5000);
+}
@@ -57,7 +57,6 @@
  */
 
 #include <Tympan_Library.h>
-#include "AudioEffectFreqComp_FD_F32.h"
 #include "SerialManager.h"
 #include "State.h"
 
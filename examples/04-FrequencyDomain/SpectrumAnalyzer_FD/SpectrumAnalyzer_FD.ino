@@ -0,0 +1,90 @@
+// SpectrumAnalyzer_FD
+//
+// Demonstrate the AudioAnalysisSpectrum_FD_F32 real-time spectrum analyzer.  The audio is averaged
+// and combined into 1/3-octave bands by the analyzer.  The main loop simply grabs the most recent
+// results whenever new ones are published.
+//
+// Created: 2026
+//
+// Output: Each time new results are published, this prints the band levels as a compact int8 array
+//    (1 dB per step), which is the same format that you might send over BLE.  Set OUTPUT_FOR_SERIAL_PLOTTER
+//    to true to instead print the levels (and peak hold) in dB for the Arduino SerialPlotter.
+//
+// This example code is in the public domain (MIT License)
+
+#define OUTPUT_FOR_SERIAL_PLOTTER false    //set to true and then open the Arduino SerialPlotter rather than the Serial Monitor
+
+#include <Tympan_Library.h>
+
+//set the sample rate and block size
+const float sample_rate_Hz = 24000.f; //try diff values, like 16000, 24000, 32000, 44100, 48000 or 96000...slower gives more frequency resolution
+const int audio_block_samples = 128;  //choose a power of 2 (16, 32, 64, 128) but no higher than 128
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+//create audio library objects for handling the audio
+Tympan                        myTympan(TympanRev::F, audio_settings); //do TympanRev::D or E or F
+AudioInputI2S_F32             i2s_in(audio_settings);                 //Digital audio *from* the Tympan AIC.
+AudioAnalysisSpectrum_FD_F32  spectrum(audio_settings);               //computes the spectrum
+AudioOutputI2S_F32            i2s_out(audio_settings);                //Digital audio *to* the Tympan AIC.
+
+//Make all of the audio connections
+AudioConnection_F32       patchCord1(i2s_in, 0, spectrum, 0);  //connect the Left input to the analyzer
+AudioConnection_F32       patchCord2(i2s_in, 0, i2s_out, 0);   //connect the Left input to the left output
+AudioConnection_F32       patchCord3(i2s_in, 0, i2s_out, 1);   //connect the Left input to the right output
+
+// define the setup() function, the function that is called once when the device is booting
+const float input_gain_dB = 15.0f; //gain on the microphone
+void setup() {
+  //begin the serial comms (for debugging)
+  myTympan.beginBothSerial();
+  while ( (!Serial) && (millis() < 1000));  //stall for 1000 msec in case USB is attached at startup
+  #if (OUTPUT_FOR_SERIAL_PLOTTER == false)
+    Serial.println("SpectrumAnalyzer_FD: starting setup()...");
+  #endif
+
+  // Allocate working memory for audio
+  AudioMemory_F32(20, audio_settings);
+
+  // Configure the analyzer
+  int N_FFT = 4*audio_block_samples;
+  spectrum.setup(audio_settings,N_FFT); //do after AudioMemory_F32();
+  spectrum.setAveragingType(AudioAnalysisSpectrum_FD_F32::AVE_EXPONENTIAL);
+  spectrum.setTimeConstant_sec(0.125);   //"FAST"
+  spectrum.setPublishInterval_msec(100.0);
+  spectrum.setPeakHoldDecay_dBperSec(10.0);
+  spectrum.setLogFreqBands(18, 200.f, 10000.f);  //about 1/3-octave bands
+
+  //Enable the Tympan to start the audio flowing!
+  myTympan.enable(); // activate AIC
+  myTympan.inputSelect(TYMPAN_INPUT_ON_BOARD_MIC); // use the on board microphones
+  myTympan.volume_dB(0);                   // headphone amplifier.  -63.6 to +24 dB in 0.5dB steps.
+  myTympan.setInputGain_dB(input_gain_dB); // set input volume, 0-47.5dB in 0.5dB setps
+
+  #if (OUTPUT_FOR_SERIAL_PLOTTER == false)
+    Serial.println("Setup complete.");
+  #endif
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+uint32_t last_publish_count = 0;
+void loop() {
+  //has the analyzer published anything new?
+  uint32_t count = spectrum.getPublishCount();
+  if (count == last_publish_count) return;
+  last_publish_count = count;
+
+  #if (OUTPUT_FOR_SERIAL_PLOTTER == false)
+    //get the levels as a compact binary array
+    int8_t levels[64];
+    int n = spectrum.exportResult_int8(AudioAnalysisSpectrum_FD_F32::RESULT_SPECTRUM, levels, 64);
+    Serial.print("Spectrum (dB): ");
+    for (int i=0; i<n; i++) { Serial.print(levels[i]); Serial.print(" "); }
+    Serial.println();
+  #else
+    //get the levels and the peak hold
+    float32_t levels_dB[64], peak_dB[64];
+    int n = spectrum.getSpectrum_dB(levels_dB, 64);
+    spectrum.getPeakHold_dB(peak_dB, 64);
+    for (int i=0; i<n; i++) { Serial.print(levels_dB[i]); Serial.print(" "); Serial.println(peak_dB[i]); }
+  #endif
+} //end loop();
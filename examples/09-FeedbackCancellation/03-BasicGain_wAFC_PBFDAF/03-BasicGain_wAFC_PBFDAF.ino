@@ -0,0 +1,166 @@
+/*
+*   BasicGain_wAFC_PBFDAF
+*
+*   CREATED: 2026
+*   PURPOSE: Process audio by applying gain to the audio.  The processing is then
+*      wrapped in an adaptive feedback cancellation (AFC) that uses a partitioned-block
+*      frequency-domain adaptive filter (PBFDAF).  Compared to the NLMS version (see the
+*      01-BasicGain_wAFC_NLMS example), the PBFDAF does its filtering and adaptation via FFTs,
+*      so it can afford a much longer feedback model, which helps at higher sample rates.
+*
+*      * Send commands over the SerialMonitor (see printHelp() below) to change the step size,
+*        to print the estimated feedback impulse response, or to see the CPU usage.
+*
+*      * The volume wheel on the Tympan adjusts the digital gain applied to the
+*        processed audio
+*
+*   MIC AND SPEAKER: Like the NLMS example, this assumes that the mic and speaker are close
+*      together (like a behind-the-ear hearing aid).  Here, though, the default model is 512 taps
+*      (over 10 msec at 48 kHz), so it can handle a longer acoustic path.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>  //include the Tympan Library
+
+//set the sample rate and block size
+const float sample_rate_Hz = 48000.0f ; //the PBFDAF is efficient enough for higher sample rates
+const int audio_block_samples = 32;     //the PBFDAF partitions are this long.  Must be a power of 2.
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+//create audio library objects for handling the audio
+Tympan                        myTympan(TympanRev::F, audio_settings);  //do TympanRev::D or E or F
+AudioInputI2S_F32             i2s_in(audio_settings);                  //Digital audio *from* the Tympan AIC.
+AudioFeedbackCancelPBFDAF_F32 afc(audio_settings);                     //adaptive feedback cancelation (AFC), PBFDAF method
+AudioEffectGain_F32           gain1(audio_settings);                   //Applies digital gain to audio data.
+AudioOutputI2S_F32            i2s_out(audio_settings);                 //Digital audio *to* the Tympan AIC.  Always list last to minimize latency
+AudioLoopBack_F32             afc_loopback(audio_settings);            //here's how we close the loop on the AFC
+
+//Make all of the audio connections
+AudioConnection_F32       patchCord10(i2s_in, 0, afc, 0);          //connect the left input straight to the afc
+AudioConnection_F32       patchCord20(afc,    0, gain1, 0);        //connect to the AFC to your audio processing
+AudioConnection_F32       patchCord30(gain1,  0, i2s_out, 0);      //output to the Left output
+AudioConnection_F32       patchCord31(gain1,  0, i2s_out, 1);      //output to the Right output
+AudioConnection_F32       patchCord40(gain1,  0, afc_loopback, 0); //close the loop with the AFC
+
+// some functions
+void setupAFC(void) {
+  float mu = 0.005;   //AFC normalized step size (roughly 0 to 1)
+  float rho = 0.9;    //AFC forgetting factor of the per-bin power estimate.  Must be < 1.0.
+  float eps = 1.0e-6; //AFC floor on the per-sample signal power (thereby avoiding divide-by-near-zero)
+  int afl = 512;      //AFC filter (model) length.  Rounded up to a multiple of the block size.
+  afc.setParams(mu, rho, eps, afl); //you can also set invidivual values via setMu(), setRho(), etc
+}
+
+void printHelp(void) {
+  Serial.println("BasicGain_wAFC_PBFDAF: Help Menu:");
+  Serial.println("   h: Print this help");
+  Serial.println("   a/A: Disable/Enable the AFC");
+  Serial.println("   m/M: Decrease/Increase the AFC step size (mu)");
+  Serial.println("   p: Print the estimated feedback impulse response");
+  Serial.println("   c/C: Disable/Enable printing of CPU and memory usage");
+}
+
+// define the setup() function, the function that is called once when the device is booting
+const float input_gain_dB = 20.0f; //gain on the microphone
+float vol_knob_gain_dB = 0.0;      //will be overridden by volume knob
+bool enable_printCPUandMemory = false;
+void setup() {
+  //begin the serial comms (for debugging)
+  myTympan.beginBothSerial(); delay(1000); //let's use the print functions in "myTympan" so it goes to BT, too!
+  myTympan.println("BasicGain_wAFC_PBFDAF: Starting setup()...");
+
+  //allocate the dynamic memory for audio processing blocks
+  AudioMemory_F32(20,audio_settings);
+
+  //connect the afc_loopback to the afc (do this before audio starts flowing)
+  afc_loopback.setTarget(&afc);
+
+  //Enable the Tympan to start the audio flowing!
+  myTympan.enable(); // activate AIC
+
+  //setup DC-blocking highpass filter running in the ADC hardware itself.  HP filtering is very important for AFC!!!
+  float cutoff_Hz = 100.0;  //set the default cutoff frequency for the highpass filter
+  myTympan.setHPFonADC(true,cutoff_Hz,audio_settings.sample_rate_Hz); //set to false to disble
+
+  //Choose the desired input and set the volume levels
+  myTympan.inputSelect(TYMPAN_INPUT_ON_BOARD_MIC);     // use the on board microphones
+  myTympan.volume_dB(0);                   // headphone amplifier.  -63.6 to +24 dB in 0.5dB steps.
+  myTympan.setInputGain_dB(input_gain_dB); // set input volume, 0-47.5dB in 0.5dB setps
+
+  // setup the AFC
+  setupAFC();
+  afc.setEnable(true);  //set to false to disable AFC
+  afc.printAlgorithmInfo();
+
+  // check the volume knob
+  servicePotentiometer(millis(),0);  //the "0" is not relevant here.
+
+  myTympan.println("Setup complete.");
+  printHelp();
+} //end setup()
+
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+
+  //handle any in-coming serial commands
+  while (Serial.available()) respondToByte((char)Serial.read());   //USB
+
+  //periodicallly check the potentiometer
+  servicePotentiometer(millis(),100); //service the potentiometer every 100 msec
+
+  //periodically print the CPU and Memory Usage
+  if (enable_printCPUandMemory) myTympan.printCPUandMemory(millis(),3000); //print every 3000 msec
+
+  //Blink the LEDs!
+  myTympan.serviceLEDs(millis());   //defaults to a slow toggle (see Tympan.h and Tympan.cpp)
+
+} //end loop();
+
+
+// ///////////////// Servicing routines
+
+void respondToByte(char c) {
+  switch (c) {
+    case 'h': printHelp(); break;
+    case 'a': afc.setEnable(false); Serial.println("AFC disabled."); break;
+    case 'A': afc.setEnable(true);  Serial.println("AFC enabled."); break;
+    case 'm': afc.setMu(afc.getMu() / 2.0); Serial.print("AFC mu = "); Serial.println(afc.getMu(),6); break;
+    case 'M': afc.setMu(afc.getMu() * 2.0); Serial.print("AFC mu = "); Serial.println(afc.getMu(),6); break;
+    case 'p': afc.printEstimatedFeedbackImpulseResponse(); break;
+    case 'c': enable_printCPUandMemory = false; break;
+    case 'C': enable_printCPUandMemory = true; break;
+  }
+}
+
+//servicePotentiometer: listens to the blue potentiometer and sends the new pot value
+//  to the audio processing algorithm as a control parameter
+void servicePotentiometer(unsigned long curTime_millis, unsigned long updatePeriod_millis) {
+  static unsigned long lastUpdate_millis = 0;
+  static float prev_val = -1.0;
+
+  //has enough time passed to update everything?
+  if (curTime_millis < lastUpdate_millis) lastUpdate_millis = 0; //handle wrap-around of the clock
+  if ((curTime_millis - lastUpdate_millis) > updatePeriod_millis) { //is it time to update the user interface?
+
+    //read potentiometer
+    float val = float(myTympan.readPotentiometer()) / 1023.0; //0.0 to 1.0
+    val = (1.0/9.0) * (float)((int)(9.0 * val + 0.5)); //quantize so that it doesn't chatter...0 to 1.0
+
+    //send the potentiometer value to your algorithm as a control parameter
+    if (abs(val - prev_val) > 0.05) { //is it different than before?
+      prev_val = val;  //save the value for comparison for the next time around
+
+      //choose the desired gain value based on the knob setting
+      const float min_gain_dB = -10.0, max_gain_dB = 40.0; //set desired gain range
+      vol_knob_gain_dB = min_gain_dB + (max_gain_dB - min_gain_dB)*val; //computed desired gain value in dB
+
+      //command the new gain setting
+      gain1.setGain_dB(vol_knob_gain_dB);  //set the gain
+      Serial.println("servicePotentiometer: Digital Gain dB = " + String(vol_knob_gain_dB)); //print text to Serial port for debugging
+    }
+    lastUpdate_millis = curTime_millis;
+  } // end if
+} //end servicePotentiometer();
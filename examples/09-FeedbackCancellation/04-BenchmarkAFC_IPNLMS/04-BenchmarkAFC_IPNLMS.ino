@@ -0,0 +1,121 @@
+/*
+*   BenchmarkAFC_IPNLMS
+*
+*   Created: 2026
+*   Purpose: Compare the adaptation rules of AudioFeedbackCancelNLMS_F32 on a simulated sparse
+*      feedback path.  For each configuration, it reports:
+*         * the convergence time (how long until the canceller removes 20 dB of the feedback)
+*         * the echo-return loss enhancement (ERLE) after a few seconds
+*         * the CPU cycles per sample of the AFC
+*
+*      The configurations are the standard NLMS and the proportionate IPNLMS, each with and without
+*      skipping the taps that are known to be zero (see setHDel()).
+*
+*   No audio is processed.  The feedback path is simulated, so just open the Serial Monitor to see the results.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>         //include the Tympan Library
+
+//simulation settings
+const float sample_rate_Hz = 24000.0f;
+const int audio_block_samples = 16;
+const int afl = 100;                //length of the AFC model, as in the 01-BasicGain_wAFC_NLMS example
+const int path_delay = 24;          //taps of pure delay in the simulated feedback path
+const int path_len = 40;            //length of the (non-zero part) of the simulated feedback path
+const float sim_duration_sec = 4.0f;
+
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+AudioFeedbackCancelNLMS_F32 afc(audio_settings);  //not connected to anything.  We'll call it directly.
+
+float32_t fb_path[path_delay + path_len];  //the simulated feedback impulse response
+float32_t history[path_delay + path_len + audio_block_samples];  //recent reference samples, newest last
+
+// Make a sparse, decaying feedback path (like a BTE hearing aid)
+void makeFeedbackPath(void) {
+  randomSeed(1234);
+  for (int i=0; i < path_delay; i++) fb_path[i] = 0.0f;
+  for (int i=0; i < path_len; i++) {
+    float32_t rand_val = ((float32_t)random(-1000,1000))/1000.0f;
+    fb_path[path_delay + i] = 0.3f * rand_val * expf(-((float)i)/6.0f);
+  }
+}
+
+// Run one configuration of the AFC and report the results
+void runBenchmark(const char *name, int adapt_type, int hdel) {
+  //configure the AFC
+  afc.setDefaultValues();
+  afc.setAfl(afl);
+  afc.setHDel(hdel);
+  afc.setAdaptationType(adapt_type);
+  afc.setIPNLMSAlpha(0.0);
+  afc.initializeStates();
+  for (int i=0; i < path_delay + path_len + audio_block_samples; i++) history[i] = 0.0f;
+  randomSeed(5678);
+
+  //loop over the blocks
+  const int n_hist = path_delay + path_len;
+  const int n_blocks = (int)(sim_duration_sec * sample_rate_Hz / audio_block_samples);
+  float32_t ref[audio_block_samples], mic[audio_block_samples], out[audio_block_samples];
+  float32_t mic_pow = 0.0f, out_pow = 0.0f;
+  const float32_t alpha = expf(-1.0f / (0.05f * sample_rate_Hz / audio_block_samples));  //50 msec smoothing of the powers
+  float converge_msec = -1.0f, erle_dB = 0.0f;
+  uint32_t total_cycles = 0;
+  for (int b=0; b < n_blocks; b++) {
+    //make the next block of reference (loopback) audio...white noise
+    for (int i=0; i < audio_block_samples; i++) ref[i] = 0.1f * ((float32_t)random(-1000,1000))/1000.0f;
+
+    //simulate the mic signal (the reference through the feedback path)
+    for (int i=0; i < n_hist; i++) history[i] = history[i + audio_block_samples];
+    for (int i=0; i < audio_block_samples; i++) history[n_hist + i] = ref[i];
+    for (int i=0; i < audio_block_samples; i++) {
+      float32_t acc = 0.0f;
+      for (int j=0; j < n_hist; j++) acc += fb_path[j] * history[n_hist + i - j];
+      mic[i] = acc;
+    }
+
+    //run the AFC (and time it)
+    uint32_t start_cycles = ARM_DWT_CYCCNT;
+    afc.receiveLoopBackAudio(ref, audio_block_samples);
+    afc.cha_afc(mic, out, audio_block_samples);
+    total_cycles += (ARM_DWT_CYCCNT - start_cycles);
+
+    //track the ERLE
+    float32_t p_mic = 0.0f, p_out = 0.0f;
+    for (int i=0; i < audio_block_samples; i++) { p_mic += mic[i]*mic[i];  p_out += out[i]*out[i]; }
+    mic_pow = alpha*mic_pow + (1.0f-alpha)*p_mic;
+    out_pow = alpha*out_pow + (1.0f-alpha)*p_out;
+    erle_dB = 10.0f*log10f(mic_pow / max(out_pow, 1.0e-20f));
+    if ((converge_msec < 0.0f) && (b > 10) && (erle_dB > 20.0f)) converge_msec = 1000.0f * ((float)(b*audio_block_samples)) / sample_rate_Hz;
+  }
+
+  //report
+  Serial.print("  "); Serial.print(name);
+  Serial.print(": time to 20 dB ERLE (msec) = "); if (converge_msec < 0.0f) { Serial.print("never"); } else { Serial.print(converge_msec,0); }
+  Serial.print(", final ERLE (dB) = "); Serial.print(erle_dB,1);
+  Serial.print(", cycles/sample = "); Serial.println(((float)total_cycles)/((float)(n_blocks*audio_block_samples)), 1);
+}
+
+// define the setup() function, the function that is called once when the device is booting
+void setup() {
+  Serial.begin(115200); delay(1000);
+  Serial.println("BenchmarkAFC_IPNLMS: starting...");
+  Serial.print("  CPU (MHz) = "); Serial.println(F_CPU_ACTUAL / 1000000);
+  Serial.print("  Sample rate (Hz) = "); Serial.print(sample_rate_Hz,0); Serial.print(", block size = "); Serial.println(audio_block_samples);
+  Serial.print("  AFC length = "); Serial.print(afl); Serial.print(", simulated path delay = "); Serial.println(path_delay);
+  Serial.println();
+  makeFeedbackPath();
+}
+
+// define the loop() function, the function that is repeated over and over for the life of the device
+void loop() {
+  const int hdel = path_delay - 4;  //stay a little conservative relative to the true delay
+  runBenchmark("NLMS          ", AudioFeedbackCancelNLMS_F32::ADAPT_NLMS,   0);
+  runBenchmark("NLMS   + hdel ", AudioFeedbackCancelNLMS_F32::ADAPT_NLMS,   hdel);
+  runBenchmark("IPNLMS        ", AudioFeedbackCancelNLMS_F32::ADAPT_IPNLMS, 0);
+  runBenchmark("IPNLMS + hdel ", AudioFeedbackCancelNLMS_F32::ADAPT_IPNLMS, hdel);
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,121 @@
+/*
+*   EarpieceAFC_MultiMic
+*
+*   Created: 2026
+*   Purpose: Cancel the feedback at each of the four earpiece microphones (front and rear, left and right)
+*      *before* the front and rear mics are combined.  Each earpiece has one receiver (speaker) that
+*      both of its mics hear, so each earpiece gets one AudioFeedbackCancelMultiNLMS_F32 with two channels.
+*      The two mics share the receiver's reference signal, which is much cheaper than running an
+*      AudioFeedbackCancelNLMS_F32 for each mic.
+*
+*      After the AFC, the front and rear mics are mixed (a simple stand-in for a beamformer), gain
+*      is applied, and the result is sent to the earpiece.  The output is also looped back to the AFC.
+*
+*      Send 'a'/'A' over the Serial Monitor to disable/enable the AFC, or 'p' to print the estimated
+*      feedback paths.  The CPU usage is printed every few seconds.
+*
+*   HARDWARE: Tympan RevE or RevF with the Tympan Earpiece Shield and the Tympan Earpieces.
+*
+*   MIT License.  use at your own risk.
+*/
+
+//here are the libraries that we need
+#include <Tympan_Library.h>  //include the Tympan Library
+
+//set the sample rate and block size
+const float sample_rate_Hz = 24000.0f ; //the default AFC length is suitable for 24kHz
+const int audio_block_samples = 16;     //Shorter results in less latency.  Longer is more CPU efficient.
+AudioSettings_F32 audio_settings(sample_rate_Hz, audio_block_samples);
+
+// define classes to control the Tympan and the Earpiece shield
+Tympan                            myTympan(TympanRev::F, audio_settings);   //do TympanRev::D or E or F
+EarpieceShield                    earpieceShield(TympanRev::F, AICShieldRev::A);
+
+// define audio classes
+AudioInputI2SQuad_F32             i2s_in(audio_settings);        //Digital audio *from* the Tympan AIC.
+AudioFeedbackCancelMultiNLMS_F32  afcLeft(2, audio_settings);    //AFC for the two mics of the left earpiece
+AudioFeedbackCancelMultiNLMS_F32  afcRight(2, audio_settings);   //AFC for the two mics of the right earpiece
+AudioMixer4_F32                   mixerLeft(audio_settings);     //combine the front and rear mics
+AudioMixer4_F32                   mixerRight(audio_settings);    //combine the front and rear mics
+AudioEffectGain_F32               gainLeft(audio_settings);      //Applies digital gain to audio data.
+AudioEffectGain_F32               gainRight(audio_settings);     //Applies digital gain to audio data.
+AudioOutputI2SQuad_F32            i2s_out(audio_settings);       //Digital audio *to* the Tympan AIC.  Always list last to minimize latency
+AudioLoopBack_F32                 loopbackLeft(audio_settings);  //here's how we close the loop on the AFC
+AudioLoopBack_F32                 loopbackRight(audio_settings); //here's how we close the loop on the AFC
+
+// Make all of the audio connections: the mics to the AFCs
+AudioConnection_F32  patchCord1(i2s_in, EarpieceShield::PDM_LEFT_FRONT,  afcLeft,  0);
+AudioConnection_F32  patchCord2(i2s_in, EarpieceShield::PDM_LEFT_REAR,   afcLeft,  1);
+AudioConnection_F32  patchCord3(i2s_in, EarpieceShield::PDM_RIGHT_FRONT, afcRight, 0);
+AudioConnection_F32  patchCord4(i2s_in, EarpieceShield::PDM_RIGHT_REAR,  afcRight, 1);
+
+// ...the AFCs to the mixers
+AudioConnection_F32  patchCord11(afcLeft,  0, mixerLeft,  0);
+AudioConnection_F32  patchCord12(afcLeft,  1, mixerLeft,  1);
+AudioConnection_F32  patchCord13(afcRight, 0, mixerRight, 0);
+AudioConnection_F32  patchCord14(afcRight, 1, mixerRight, 1);
+
+// ...the mixers to the gains to the outputs
+AudioConnection_F32  patchCord21(mixerLeft,  0, gainLeft,  0);
+AudioConnection_F32  patchCord22(mixerRight, 0, gainRight, 0);
+AudioConnection_F32  patchCord31(gainLeft,  0, i2s_out, EarpieceShield::OUTPUT_LEFT_EARPIECE);
+AudioConnection_F32  patchCord32(gainRight, 0, i2s_out, EarpieceShield::OUTPUT_RIGHT_EARPIECE);
+
+// ...and close the loops
+AudioConnection_F32  patchCord41(gainLeft,  0, loopbackLeft,  0);
+AudioConnection_F32  patchCord42(gainRight, 0, loopbackRight, 0);
+
+// define the setup() function, the function that is called once when the device is booting
+const float gain_dB = 15.0f;  //digital gain...be careful!
+void setup(void)
+{
+  //begin the serial comms (for debugging)
+  myTympan.beginBothSerial();   delay(1000);
+  Serial.println("EarpieceAFC_MultiMic: Starting setup()...");
+
+  //allocate the dynamic memory for audio processing blocks
+  AudioMemory_F32(40,audio_settings);
+
+  //connect the loopbacks to the AFCs (do this before audio starts flowing)
+  loopbackLeft.setTarget(&afcLeft);
+  loopbackRight.setTarget(&afcRight);
+
+  //setup the AFCs
+  float mu = 0.005;   //NLMS step size
+  float eps = 1.0e-4; //floor on the reference energy
+  int afl = 100;      //AFC filter (model) length.  Suitable for 24kHz.
+  afcLeft.setParams(mu, eps, afl);
+  afcRight.setParams(mu, eps, afl);
+  afcLeft.printAlgorithmInfo();
+
+  //setup the mixers (average the front and rear mics) and the gains
+  for (int i=0; i < 2; i++) { mixerLeft.gain(i, 0.5); mixerRight.gain(i, 0.5); }
+  gainLeft.setGain_dB(gain_dB);
+  gainRight.setGain_dB(gain_dB);
+
+  //Enable the Tympan and the Earpiece Shield to start the audio flowing!
+  myTympan.enable();
+  earpieceShield.enable();
+  myTympan.enableDigitalMicInputs(true);
+  earpieceShield.enableDigitalMicInputs(true);
+
+  //Set the desired volume levels
+  myTympan.volume_dB(0.0);        // headphone amplifier.  -63.6 to +24 dB in 0.5dB steps.
+  earpieceShield.volume_dB(0.0);  // headphone amplifier.  -63.6 to +24 dB in 0.5dB steps.
+
+  Serial.println("Setup complete.  Send 'a'/'A' to disable/enable the AFC or 'p' to print the feedback paths.");
+}
+
+void loop(void)
+{
+  //respond to Serial commands
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == 'a') { afcLeft.setEnable(false); afcRight.setEnable(false); Serial.println("AFC disabled."); }
+    if (c == 'A') { afcLeft.setEnable(true);  afcRight.setEnable(true);  Serial.println("AFC enabled."); }
+    if (c == 'p') { for (int i=0; i < 2; i++) { afcLeft.printEstimatedFeedbackImpulseResponse(i); afcRight.printEstimatedFeedbackImpulseResponse(i); } }
+  }
+
+  //print the CPU and memory
+  myTympan.printCPUandMemory(millis(), 3000); //print every 3000 msec
+}
@@ -206,7 +206,7 @@ class AICShieldBase : public AudioControlAIC3206
 		}
 
 		void setupPins(const AICShieldPins &_pins);
-		void setAudioSettings(const AudioSettings_F32 &_aud_set) { audio_settings = _aud_set; }  //shallow copy
+		void setAudioSettings(const AudioSettings_F32 &_aud_set) { audio_settings = _aud_set; setI2SWordLength(_aud_set.i2s_bits); }  //shallow copy
 		virtual bool enable(void) {
 			bool foo = AudioControlAIC3206::enable();
 			if (pins.defaultInput != NOT_A_FEATURE)	inputSelect(pins.defaultInput);
@@ -0,0 +1,214 @@
+
+#include "AudioAnalysisSpectrum_FD_F32.h"
+
+int AudioAnalysisSpectrum_FD_F32::setup(const AudioSettings_F32 &settings, const int _N_FFT) {
+	int ret_val = AudioFreqDomainBase_FD_F32::setup(settings, _N_FFT, _N_FFT);
+	if (ret_val < 0) return ret_val; //it failed, so simply return now
+
+	//setup the FFT for the cepstrum.  No windowing!
+	const int N_FFT = getNFFT();
+	if (cepsFFT.setup(N_FFT) < 0) return -1;
+	cepsFFT.useRectangularWindow();
+
+	//allocate all of the memory that we'll need (so that nothing is allocated during update())
+	freeBuffers();
+	N_2 = N_FFT / 2 + 1;
+	pow_buff = new float32_t[N_2];
+	ave_pow = new float32_t[N_2];
+	peak_dB = new float32_t[N_2];
+	ceps_buffer = new float32_t[2*N_FFT];
+	band_start_bin = new uint16_t[N_2+1];
+	snap_memory = new float32_t[2*3*N_2];
+	if ((pow_buff == NULL) || (ave_pow == NULL) || (peak_dB == NULL) || (ceps_buffer == NULL) || (band_start_bin == NULL) || (snap_memory == NULL)) {
+		Serial.println(F("AudioAnalysisSpectrum_FD_F32: setup: *** ERROR ***: could not allocate memory."));
+		freeBuffers();  enabled = 0;
+		return -1;
+	}
+	for (int i=0; i < 2; i++) {
+		snap[i].n_out = 0;
+		snap[i].spectrum_dB = snap_memory + (3*i+0)*N_2;
+		snap[i].peak_dB     = snap_memory + (3*i+1)*N_2;
+		snap[i].cepstrum_dB = snap_memory + (3*i+2)*N_2;
+	}
+	for (int i=0; i < 2*3*N_2; i++) snap_memory[i] = -200.0f;
+	for (int i=0; i < N_2; i++) ave_pow[i] = 0.0f;
+	frame_count = 0;
+
+	//With the Hanning window, a sine wave of amplitude A gives a peak bin magnitude of A*N_FFT/4
+	pow_scale = 16.0f / ((float32_t)N_FFT * (float32_t)N_FFT);
+
+	//compute the things that depend upon the sample rate and N_FFT
+	computeAveCoeff();
+	rebuildBands();  flag_rebuild_bands = false;
+	flag_reset_peaks = true;
+	return ret_val;
+}
+
+void AudioAnalysisSpectrum_FD_F32::computeAveCoeff(void) {
+	const float32_t fft_rate_Hz = getOverlappedFFTRate_Hz();
+	if (fft_rate_Hz <= 0.0f) return;
+	frames_per_publish = max(1, (int)(0.001f * publish_interval_msec * fft_rate_Hz + 0.5f));
+	ave_coeff = (time_const_sec > 0.0f) ? expf(-1.0f / (time_const_sec * fft_rate_Hz)) : 0.0f;
+	peak_decay_dB_per_publish = peak_decay_dB_per_sec * ((float32_t)frames_per_publish) / fft_rate_Hz;
+}
+
+int AudioAnalysisSpectrum_FD_F32::setLogFreqBands(int _n_bands, float min_freq_Hz, float max_freq_Hz) {
+	band_min_Hz = max(1.0f, min(min_freq_Hz, max_freq_Hz));
+	band_max_Hz = max(band_min_Hz, max_freq_Hz);
+	n_bands_target = max(0, _n_bands);
+	flag_rebuild_bands = true;  //the audio side will rebuild the bands at the next publication
+	return n_bands_target;
+}
+
+//compute the first bin of each log-spaced band.  Every band gets at least one bin.
+void AudioAnalysisSpectrum_FD_F32::rebuildBands(void) {
+	if (band_start_bin == NULL) return;  //not set up yet
+	if (n_bands_target < 1) { n_bands = 0; return; }  //use the raw FFT bins
+
+	const float Hz_per_bin = getSampleRate_Hz() / ((float)getNFFT());
+	const float log2_ratio = FastMath::log2(band_max_Hz / band_min_Hz);
+	int n = 0, bin = max(0, min(N_2-1, (int)(band_min_Hz / Hz_per_bin + 0.5f)));
+	band_start_bin[0] = bin;
+	while ((n < n_bands_target) && (bin < N_2)) {
+		float edge_Hz = band_min_Hz * FastMath::exp2(log2_ratio * ((float)(n+1)) / ((float)n_bands_target));
+		bin = max(bin+1, min(N_2, (int)(edge_Hz / Hz_per_bin + 0.5f)));
+		band_start_bin[++n] = bin;
+	}
+	n_bands = n;
+	flag_reset_peaks = true;
+}
+
+float AudioAnalysisSpectrum_FD_F32::getOutputBinFreq_Hz(int ind) const {
+	const float Hz_per_bin = getSampleRate_Hz() / ((float)max(1, N_FFT));
+	if ((n_bands > 0) && (band_start_bin != NULL)) {
+		ind = max(0, min(n_bands-1, ind));
+		return Hz_per_bin * 0.5f * ((float)(band_start_bin[ind] + band_start_bin[ind+1] - 1));  //center of the band's bins
+	}
+	return Hz_per_bin * (float)ind;
+}
+
+//Same as the parent's update() except that there is no IFFT and no output
+void AudioAnalysisSpectrum_FD_F32::update(void)
+{
+	//get a pointer to the latest data
+	audio_block_f32_t *in_audio_block = AudioStream_F32::receiveReadOnly_f32();
+	if (!in_audio_block) return;
+
+	//if not enabled, simply release the audio
+	if ((!enabled) || (pow_buff == NULL)) { AudioStream_F32::release(in_audio_block); return; }
+
+	//convert to frequency domain (myFFT already knows its N_FFT size)
+	myFFT.execute(in_audio_block, complex_2N_buffer); //FFT is in complex_2N_buffer, interleaved real, imaginary, real, imaginary, etc
+	AudioStream_F32::release(in_audio_block);
+
+	//do the analysis
+	processAudioFD(complex_2N_buffer);
+}
+
+void AudioAnalysisSpectrum_FD_F32::processAudioFD(float32_t *complex_2N_buffer) {
+	//get the power in each bin
+	arm_cmplx_mag_squared_f32(complex_2N_buffer, pow_buff, N_2);
+
+	//average
+	if (ave_type == AVE_LINEAR) {
+		arm_add_f32(ave_pow, pow_buff, ave_pow, N_2);  //accumulate.  We'll divide at publication.
+	} else {
+		const float32_t a = ave_coeff, b = 1.0f - ave_coeff;
+		for (int k=0; k < N_2; k++) ave_pow[k] = a*ave_pow[k] + b*pow_buff[k];
+	}
+
+	//publish?
+	frame_count++;
+	if (frame_count >= frames_per_publish) { publish(); frame_count = 0; }
+}
+
+//compute the results into the back snapshot and then swap it to the front
+void AudioAnalysisSpectrum_FD_F32::publish(void) {
+	if (flag_rebuild_bands) { rebuildBands(); flag_rebuild_bands = false; }
+	snapshot_t *s = &(snap[1 - front]);
+
+	//scale the average so that a full-scale sine is 0 dB
+	float32_t scale = pow_scale;
+	if (ave_type == AVE_LINEAR) scale /= (float32_t)max(1, frame_count);
+
+	//combine into bands (if requested) and convert to dB
+	int n_out = N_2;
+	if (n_bands > 0) {
+		n_out = n_bands;
+		for (int b=0; b < n_bands; b++) {
+			const int start = band_start_bin[b], end = band_start_bin[b+1];
+			float32_t sum = 0.0f;
+			for (int k=start; k < end; k++) sum += ave_pow[k];
+			pow_buff[b] = sum * (scale / ((float32_t)(end - start)));
+		}
+	} else {
+		arm_scale_f32(ave_pow, scale, pow_buff, N_2);
+	}
+	FastMath::db_from_pow(pow_buff, s->spectrum_dB, n_out);
+
+	//peak hold
+	if (flag_reset_peaks) {
+		for (int i=0; i < n_out; i++) peak_dB[i] = s->spectrum_dB[i];
+		flag_reset_peaks = false;
+	} else {
+		const float32_t decay = peak_decay_dB_per_publish;
+		for (int i=0; i < n_out; i++) peak_dB[i] = max(peak_dB[i] - decay, s->spectrum_dB[i]);
+	}
+	for (int i=0; i < n_out; i++) s->peak_dB[i] = peak_dB[i];
+
+	//cepstrum
+	if (flag_enable_cepstrum) calcCepstrum_dB(ave_pow, s->cepstrum_dB);
+
+	//start the next linear average
+	if (ave_type == AVE_LINEAR) for (int k=0; k < N_2; k++) ave_pow[k] = 0.0f;
+
+	//swap
+	s->n_out = n_out;
+	__asm__ volatile ("" ::: "memory");  //finish writing the snapshot before publishing it
+	front = 1 - front;
+	publish_count = publish_count + 1;
+}
+
+//the cepstrum is the FFT of the log of the power spectrum (which is real and even)
+void AudioAnalysisSpectrum_FD_F32::calcCepstrum_dB(const float32_t *spec_pow, float32_t *out_dB) {
+	const int N_FFT = getNFFT();
+	const float32_t min_pow = 1.0e-20f;  //avoid the log of zero
+
+	//log of the power, with the negative frequencies mirrored
+	for (int k=0; k < N_2; k++) pow_buff[k] = max(min_pow, spec_pow[k]);
+	FastMath::log2(pow_buff, pow_buff, N_2);
+	for (int k=0; k < N_2; k++) { ceps_buffer[2*k] = pow_buff[k];  ceps_buffer[2*k+1] = 0.0f; }
+	for (int k=1; k < N_2-1; k++) { ceps_buffer[2*(N_FFT-k)] = pow_buff[k];  ceps_buffer[2*(N_FFT-k)+1] = 0.0f; }
+
+	//take the FFT and then the magnitude, in dB
+	cepsFFT.execute(ceps_buffer);
+	arm_cmplx_mag_squared_f32(ceps_buffer, out_dB, N_2);
+	FastMath::db_from_pow(out_dB, out_dB, N_2);
+}
+
+const float32_t* AudioAnalysisSpectrum_FD_F32::resultArray(const snapshot_t *s, int which) const {
+	switch (which) {
+		case RESULT_SPECTRUM:  return s->spectrum_dB;
+		case RESULT_PEAK_HOLD: return s->peak_dB;
+		case RESULT_CEPSTRUM:  return flag_enable_cepstrum ? s->cepstrum_dB : NULL;
+	}
+	return NULL;
+}
+
+int AudioAnalysisSpectrum_FD_F32::getResult_dB(int which, float32_t *out, int max_n) const {
+	return readResult(which, out, max_n, [](float32_t val) { return val; });
+}
+
+int AudioAnalysisSpectrum_FD_F32::exportResult_int8(int which, int8_t *out, int max_n, float offset_dB) const {
+	return readResult(which, out, max_n, [offset_dB](float32_t val_dB) {
+		float32_t v = floorf(val_dB - offset_dB + 0.5f);
+		return (int8_t)max(-128.0f, min(127.0f, v));
+	});
+}
+
+int AudioAnalysisSpectrum_FD_F32::exportResult_int16(int which, int16_t *out, int max_n) const {
+	return readResult(which, out, max_n, [](float32_t val_dB) {
+		float32_t v = floorf(100.0f*val_dB + 0.5f);
+		return (int16_t)max(-32768.0f, min(32767.0f, v));
+	});
+}
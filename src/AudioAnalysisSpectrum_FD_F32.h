@@ -0,0 +1,174 @@
+
+/*
+ * AudioAnalysisSpectrum_FD_F32
+ *
+ * Created: 2026
+ * Purpose: Real-time spectrum (and, optionally, cepstrum) analyzer.  It computes the power spectrum of
+ *     every (overlapped) FFT, averages it, and periodically publishes the result in dB so that the main
+ *     loop (or the BLE code) can grab it.
+ *
+ *     Averaging:  AVE_EXPONENTIAL is a running average with the time constant that you set.  AVE_LINEAR
+ *         is a plain average of all the FFTs since the previous publication.
+ *     Log-Frequency Bands:  Optionally, the FFT bins can be combined into log-spaced bands (such as for
+ *         an octave-style display), which also reduces the amount of data to send.
+ *     Peak Hold:  The highest level seen for each output bin, which then decays at the rate you set.
+ *     Cepstrum:  Optionally, the cepstrum of the averaged spectrum (like the SpectrumAndCepstrum_FD example).
+ *
+ *     Publication:  The results are computed only every getPublishInterval_msec(), not every FFT.  The
+ *         audio side writes into one of two snapshot buffers while the main loop reads from the other.
+ *         The main loop doesn't lock anything.  Instead, the read methods check whether the audio side
+ *         overwrote the snapshot while it was being copied (and, if so, they try again).
+ *     Binary Export:  The results can be exported as int8 (1 dB per step) or int16 (0.01 dB per step) to
+ *         keep the size small for BLE.
+ *
+ * This is an analysis node.  It has no audio output, which saves the CPU of the IFFT.
+ *
+ * MIT License.  use at your own risk.
+*/
+
+#ifndef _AudioAnalysisSpectrum_FD_F32_h
+#define _AudioAnalysisSpectrum_FD_F32_h
+
+#include "AudioStream_F32.h"
+#include "AudioFreqDomainBase_FD_F32.h"
+#include "FFT_F32.h"
+#include "utility/FastMath_F32.h"
+#include <arm_math.h>
+#include <Arduino.h>
+
+class AudioAnalysisSpectrum_FD_F32 : public AudioFreqDomainBase_FD_F32
+{
+//GUI: inputs:1, outputs:0  //this line used for automatic generation of GUI node
+//GUI: shortName:spectrum
+  public:
+    //constructors...a few different options.  The usual one should be: AudioAnalysisSpectrum_FD_F32(const AudioSettings_F32 &settings, const int _N_FFT)
+    AudioAnalysisSpectrum_FD_F32(void) : AudioFreqDomainBase_FD_F32() { setInstanceName(); };
+    AudioAnalysisSpectrum_FD_F32(const AudioSettings_F32 &settings) :  AudioFreqDomainBase_FD_F32(settings)  { setInstanceName(); }
+    AudioAnalysisSpectrum_FD_F32(const AudioSettings_F32 &settings, const int _N_FFT) :  AudioFreqDomainBase_FD_F32(settings)  { setInstanceName(); setup(settings, _N_FFT); }
+    void setInstanceName(void) { instanceName = "AudioAnalysisSpectrum_FD_F32"; }
+
+    //destructor...release all of the memory that has been allocated
+    virtual ~AudioAnalysisSpectrum_FD_F32(void) { freeBuffers(); }
+
+    int setup(const AudioSettings_F32 &settings, const int _N_FFT) override;
+
+    void update(void) override;  //replaces the parent's update() so that there is no IFFT and no output
+    void processAudioFD(float32_t *complex_2N_buffer) override;  //this is where we put all the processing.
+
+    enum AVE_TYPE { AVE_EXPONENTIAL=0, AVE_LINEAR=1 };
+    enum RESULT_TYPE { RESULT_SPECTRUM=0, RESULT_PEAK_HOLD=1, RESULT_CEPSTRUM=2 };
+
+    // ////////////////////////////////////// configuration (call from the main loop)
+    int setAveragingType(int val) { ave_type = (val == AVE_LINEAR) ? AVE_LINEAR : AVE_EXPONENTIAL; return ave_type; }
+    int getAveragingType(void) const { return ave_type; }
+    float setTimeConstant_sec(float val_sec) { time_const_sec = max(0.0f, val_sec); computeAveCoeff(); return time_const_sec; } //for AVE_EXPONENTIAL
+    float getTimeConstant_sec(void) const { return time_const_sec; }
+    float setPublishInterval_msec(float val_msec) { publish_interval_msec = max(0.0f, val_msec); computeAveCoeff(); return publish_interval_msec; }
+    float getPublishInterval_msec(void) const { return publish_interval_msec; }
+    float setPeakHoldDecay_dBperSec(float val) { peak_decay_dB_per_sec = max(0.0f, val); computeAveCoeff(); return peak_decay_dB_per_sec; } //zero holds forever
+    float getPeakHoldDecay_dBperSec(void) const { return peak_decay_dB_per_sec; }
+    void resetPeakHold(void) { flag_reset_peaks = true; }  //takes effect at the next publication
+    bool enableCepstrum(bool val = true) { return flag_enable_cepstrum = val; }
+    bool getEnableCepstrum(void) const { return flag_enable_cepstrum; }
+
+    //combine the FFT bins into log-spaced bands.  Set n_bands to zero to go back to the raw FFT bins.
+    int setLogFreqBands(int n_bands, float min_freq_Hz, float max_freq_Hz);
+    int getNLogFreqBands(void) const { return n_bands_target; }
+
+    // ////////////////////////////////////// results (call from the main loop)
+    int getNOutputBins(void) const { return snap[front].n_out; }  //number of spectrum (and peak hold) values
+    int getNCepstrumBins(void) const { return N_2; }              //number of cepstrum values (DC through N_FFT/2)
+    float getOutputBinFreq_Hz(int ind) const;                     //center frequency of each spectrum value
+    float getCepstrumQuef_Hz(int ind) const { return getSampleRate_Hz() / (float)max(1, ind); }
+    uint32_t getPublishCount(void) const { return publish_count; } //increments every time that new results are published
+
+    //Copy the most recent results.  Returns the number of values copied (zero if the copy kept getting overwritten).
+    //Spectrum and peak hold are in dB re: a full-scale sine wave.  Cepstrum is in dB, too.
+    int getResult_dB(int which, float32_t *out, int max_n) const;
+    int getSpectrum_dB(float32_t *out, int max_n) const { return getResult_dB(RESULT_SPECTRUM, out, max_n); }
+    int getPeakHold_dB(float32_t *out, int max_n) const { return getResult_dB(RESULT_PEAK_HOLD, out, max_n); }
+    int getCepstrum_dB(float32_t *out, int max_n) const { return getResult_dB(RESULT_CEPSTRUM, out, max_n); }
+
+    //Compact binary export of the most recent results
+    //   int8:  round(dB - offset_dB), clipped to -128 to +127.  Use offset_dB to center the range of interest.
+    //   int16: round(100*dB), which is 0.01 dB per step
+    int exportResult_int8(int which, int8_t *out, int max_n, float offset_dB = 0.0f) const;
+    int exportResult_int16(int which, int16_t *out, int max_n) const;
+
+  protected:
+    static const int N_READ_TRIES = 4;
+    int ave_type = AVE_EXPONENTIAL;
+    float time_const_sec = 0.125;             //for AVE_EXPONENTIAL ("FAST")
+    float publish_interval_msec = 100.0;
+    float peak_decay_dB_per_sec = 20.0;
+    bool flag_enable_cepstrum = false;
+    volatile bool flag_reset_peaks = true;
+    volatile bool flag_rebuild_bands = true;
+    int n_bands_target = 0;                   //zero means to use the raw FFT bins
+    float band_min_Hz = 125.0, band_max_Hz = 8000.0;
+
+    int N_2 = 0;                              //number of bins from DC through Nyquist
+    float32_t ave_coeff = 0.0f;               //for AVE_EXPONENTIAL, the weight given to the old average
+    int frames_per_publish = 1;
+    float32_t peak_decay_dB_per_publish = 0.0f;
+    float32_t pow_scale = 1.0f;               //so that a full-scale sine is 0 dB
+    int frame_count = 0;
+
+    float32_t *pow_buff = NULL;               //power of the current FFT (and scratch)
+    float32_t *ave_pow = NULL;                //averaged power, DC through Nyquist
+    float32_t *peak_dB = NULL;                //peak-hold state, getNOutputBins() long
+    float32_t *ceps_buffer = NULL;            //complex, N_FFT long, for computing the cepstrum
+    uint16_t *band_start_bin = NULL;          //first bin of each band (plus one extra for the end of the last band)
+    int n_bands = 0;                          //the bands currently in use by the audio side
+    FFT_F32 cepsFFT;
+
+    typedef struct {
+      int n_out;
+      float32_t *spectrum_dB;
+      float32_t *peak_dB;
+      float32_t *cepstrum_dB;
+    } snapshot_t;
+    snapshot_t snap[2] = { {0, NULL, NULL, NULL}, {0, NULL, NULL, NULL} };
+    float32_t *snap_memory = NULL;
+    volatile int front = 0;                   //which snapshot the main loop should read
+    volatile uint32_t publish_count = 0;
+
+    void freeBuffers(void) {
+      if (pow_buff != NULL) delete[] pow_buff;
+      if (ave_pow != NULL) delete[] ave_pow;
+      if (peak_dB != NULL) delete[] peak_dB;
+      if (ceps_buffer != NULL) delete[] ceps_buffer;
+      if (band_start_bin != NULL) delete[] band_start_bin;
+      if (snap_memory != NULL) delete[] snap_memory;
+      pow_buff = ave_pow = peak_dB = ceps_buffer = snap_memory = NULL;  band_start_bin = NULL;
+      for (int i=0; i < 2; i++) { snap[i].n_out = 0;  snap[i].spectrum_dB = snap[i].peak_dB = snap[i].cepstrum_dB = NULL; }
+    }
+    void computeAveCoeff(void);
+    virtual void rebuildBands(void);
+    virtual void publish(void);
+    virtual void calcCepstrum_dB(const float32_t *ave_pow, float32_t *out_dB);
+    const float32_t* resultArray(const snapshot_t *s, int which) const;
+
+    //copy from the front snapshot, converting each value along the way.  If the audio side published twice
+    //during the copy (so the snapshot that we were reading got overwritten), try again.
+    template <typename T, typename CONVERT>
+    int readResult(int which, T *out, int max_n, CONVERT convert) const {
+      if ((out == NULL) || (max_n < 1)) return 0;
+      for (int i_try = 0; i_try < N_READ_TRIES; i_try++) {
+        uint32_t count = publish_count;
+        __asm__ volatile ("" ::: "memory");  //read the count before reading the snapshot
+        const snapshot_t *s = &(snap[front]);
+        const float32_t *src = resultArray(s, which);
+        if (src == NULL) return 0;
+        int n = (which == RESULT_CEPSTRUM) ? N_2 : s->n_out;
+        n = min(n, max_n);
+        for (int i=0; i < n; i++) out[i] = convert(src[i]);
+        __asm__ volatile ("" ::: "memory");  //finish reading the snapshot before checking the count again
+        if ((publish_count - count) < 2) return n;  //the snapshot that we read was not overwritten
+      }
+      return 0;
+    }
+};
+
+
+#endif
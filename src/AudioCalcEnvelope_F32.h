@@ -7,7 +7,9 @@
  *     WDRC_circuit from CHAPRO from BTNRC: https://github.com/BTNRH/chapro
  *     As of Feb 2017, CHAPRO license is listed as "Creative Commons?"
  *          
- * This processes a single stream of audio data (ie, it is mono)       
+ * This processes a single stream of audio data (ie, it is mono).  But, if you have many channels
+ * (such as the bands of a multiband compressor), see smooth_env_multi(), which computes the envelopes
+ * of many channels (each with its own instance of this class) in lockstep.
  *          
  * MIT License.  use at your own risk.
 */
@@ -82,6 +84,25 @@ class AudioCalcEnvelope_F32 : public AudioStream_F32
 		state_ppk = xpk;
 	}
 	
+	//Compute the smoothed envelopes of several independent channels at once.  Each channel has its own
+	//instance of AudioCalcEnvelope_F32 (so it has its own attack, release, and state).  The envelope
+	//recursion is serial in time, so it cannot be vectorized along time.  Instead, this steps groups of 
+	//channels through time together, which keeps each group's states and constants in registers and lets the
+	//processor overlap the channels' otherwise-serial calculations.  The results are identical to calling
+	//smooth_env() on each channel.
+	//
+	//  envs = input, array of pointers to the envelope calculators, one per channel
+	//  x = input, array of pointers to the audio for each channel
+	//  y = output, array of pointers for the envelope of each channel (can be the same as x, if you'd like)
+	//  n_chan = input, the number of channels (any number is allowed)
+	//  n = input, the number of samples in each channel
+	static void smooth_env_multi(AudioCalcEnvelope_F32 *envs[], float *x[], float *y[], const int n_chan, const int n) {
+		int Ichan = 0;
+		for ( ; Ichan <= n_chan - N_LOCKSTEP; Ichan += N_LOCKSTEP) smooth_env_lockstep(&(envs[Ichan]), &(x[Ichan]), &(y[Ichan]), n);
+		for ( ; Ichan < n_chan; Ichan++) envs[Ichan]->smooth_env(x[Ichan], y[Ichan], n);  //any remaining channels
+	}
+	static const int N_LOCKSTEP = 4;  //number of channels stepped together.  Four keeps all the states and constants within the FPU's registers
+	
 	//convert time constants from seconds to unitless parameters, from CHAPRO, agc_prepare.c
 	void setAttackRelease_msec(const float atk_msec, const float rel_msec) {
 		//given_attack_msec = atk_msec;
@@ -135,6 +156,26 @@ class AudioCalcEnvelope_F32 : public AudioStream_F32
 	float getCurrentLevel(void) { return state_ppk; } 
 
   private:
+	//the core of smooth_env_multi().  Processes exactly N_LOCKSTEP channels
+	static void smooth_env_lockstep(AudioCalcEnvelope_F32 *envs[], float *x[], float *y[], const int n) {
+		float32_t alfa[N_LOCKSTEP], one_minus_alfa[N_LOCKSTEP], beta[N_LOCKSTEP], xpk[N_LOCKSTEP];
+		float *xc[N_LOCKSTEP], *yc[N_LOCKSTEP];
+		for (int c=0; c < N_LOCKSTEP; c++) {  //gather
+			alfa[c] = envs[c]->alfa; one_minus_alfa[c] = envs[c]->one_minus_alfa; beta[c] = envs[c]->beta;
+			xpk[c] = envs[c]->state_ppk; xc[c] = x[c]; yc[c] = y[c];
+		}
+		for (int k = 0; k < n; k++) {
+			for (int c=0; c < N_LOCKSTEP; c++) {  //fixed count, so the compiler fully unrolls this loop
+				float32_t xab = fabsf(xc[c][k]);                             //rectify the current sample
+				float32_t xpk_attack = alfa[c] * xpk[c] + one_minus_alfa[c] * xab;
+				float32_t xpk_release = beta[c] * xpk[c];                     //this is what BTNRH uses (see smooth_env())
+				xpk[c] = (xab >= xpk[c]) ? xpk_attack : xpk_release;          //select without branching
+				yc[c][k] = xpk[c];
+			}
+		}
+		for (int c=0; c < N_LOCKSTEP; c++) envs[c]->state_ppk = xpk[c]; //scatter the states back for next time
+	}
+	
     audio_block_f32_t *inputQueueArray_f32[1]; //memory pointer for the input to this module
 	float32_t sample_rate_Hz;
 	float32_t given_attack_msec, given_release_msec;
@@ -21,6 +21,7 @@
 #include <arm_math.h> //ARM DSP extensions.  for speed!
 #include "AudioStream_F32.h"
 #include "BTNRH_WDRC_Types.h"
+#include "utility/FastMath_F32.h"
 
 class AudioCalcGainDecWDRC_F32 : public AudioStream_F32
 {
@@ -217,8 +218,8 @@ class AudioCalcGainDecWDRC_F32 : public AudioStream_F32
 	float getKneeLimiter_dBSPL(void) { return bolt; }
 
     //dB functions.  Feed it the envelope amplitude (not squared) and it computes 20*log10(x) or it does 10.^(x/20)
-    static float undb2(const float &x)  { return expf(0.11512925464970228420089957273422f*x); } //faster:  exp(log(10.0f)*x/20);  this is exact
-    static float db2(const float &x)  { return 6.020599913279623f*log2f_approx(x); } //faster: 20*log2_approx(x)/log2(10);  this is approximate
+    static float undb2(const float &x)  { return FastMath::amp_from_db(x); } //see utility/FastMath_F32.h for the accuracy
+    static float db2(const float &x)  { return FastMath::db_from_amp(x); }   //see utility/FastMath_F32.h for the accuracy
 
     /* ----------------------------------------------------------------------
     ** Fast approximation to the log2() function.  It uses a two step
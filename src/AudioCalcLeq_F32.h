@@ -5,6 +5,7 @@
 #include "Arduino.h"
 #include "AudioStream_F32.h"
 #include <arm_math.h>
+#include "utility/FastMath_F32.h"
 
 
 /*
@@ -42,9 +43,9 @@ class AudioCalcLeq_F32 : public AudioStream_F32
 		
 		virtual void update(void);
 		virtual float getCurrentLevel(void) { return cur_value; } 
-		virtual float getCurrentLevel_dB(void) { return 10.0f*log10f(cur_value); } 
+		virtual float getCurrentLevel_dB(void) { return FastMath::db_from_pow(cur_value); } 
 		virtual float getMaxLevel(void) { return max_value; }
-		virtual float getMaxLevel_dB(void) { return 10.0f*log10f(max_value); }
+		virtual float getMaxLevel_dB(void) { return FastMath::db_from_pow(max_value); }
 		virtual void  resetMaxLevel(void) { max_value = cur_value; }
 	
 		
@@ -4,6 +4,7 @@
 
 #include <Arduino.h>
 #include "AudioFilterTimeWeighting_F32.h"
+#include "utility/FastMath_F32.h"
 
 /*
  AudioCalcLeq_F32.h
@@ -25,9 +26,9 @@ class AudioCalcLevel_F32 : public AudioFilterTimeWeighting_F32
 		AudioCalcLevel_F32(const AudioSettings_F32 &settings) : AudioFilterTimeWeighting_F32(settings) {}
 		void update(void) override;
 		virtual float getCurrentLevel(void) { return cur_value; } 
-		virtual float getCurrentLevel_dB(void) { return 10.0f*log10f(cur_value); } 
+		virtual float getCurrentLevel_dB(void) { return FastMath::db_from_pow(cur_value); } 
 		virtual float getMaxLevel(void) { return max_value; }
-		virtual float getMaxLevel_dB(void) { return 10.0f*log10f(max_value); }
+		virtual float getMaxLevel_dB(void) { return FastMath::db_from_pow(max_value); }
 		virtual void  resetMaxLevel(void) { max_value = cur_value; }
 		
 	protected:
@@ -0,0 +1,72 @@
+/*
+ * AudioCalcVAD_F32.cpp
+ *
+ * Created: 2026
+ *
+ * MIT License,  Use at your own risk.
+ *
+*/
+
+#include "AudioCalcVAD_F32.h"
+
+void AudioCalcVAD_F32::update(void)
+{
+  audio_block_f32_t *block = AudioStream_F32::receiveReadOnly_f32();
+  if (!block) return;
+
+  //if the block size changed, update the per-block coefficients
+  if ((block->length > 0) && (block->length != block_len)) { block_len = block->length; computeCoefficients(); }
+
+  //analyze the audio
+  processBlock(block->data, block->length);
+
+  //pass the audio through, unchanged
+  AudioStream_F32::transmit(block);
+  AudioStream_F32::release(block);
+}
+
+void AudioCalcVAD_F32::processBlock(const float32_t *x, const int n) {
+  if (n < 1) return;
+
+  //power and zero crossings, unrolled by two
+  float32_t acc0 = 0.0f, acc1 = 0.0f, prev = prev_sample;
+  int n_zc = 0, i = 0;
+  for ( ; i <= n-2; i += 2) {
+    const float32_t x0 = x[i], x1 = x[i+1];
+    acc0 += x0*x0;  acc1 += x1*x1;
+    n_zc += ((prev < 0.0f) != (x0 < 0.0f)) + ((x0 < 0.0f) != (x1 < 0.0f));
+    prev = x1;
+  }
+  for ( ; i < n; i++) { acc0 += x[i]*x[i];  n_zc += ((prev < 0.0f) != (x[i] < 0.0f));  prev = x[i]; }
+  prev_sample = prev;
+  const float32_t block_pow = (acc0 + acc1) / ((float32_t)n);
+  zc_rate_Hz = 0.5f * ((float32_t)n_zc) * sample_rate_Hz / ((float32_t)n);  //two crossings per cycle
+
+  //smooth the level
+  if (is_first_block) level_pow = block_pow;
+  level_pow = level_alpha * level_pow + (1.0f - level_alpha) * block_pow;
+  level_dB = FastMath::db_from_pow(level_pow);
+
+  //track the noise floor: fall quickly, rise slowly
+  if (is_first_block) floor_dB = level_dB;
+  if (level_dB < floor_dB) {
+    floor_dB = floor_fall_alpha * floor_dB + (1.0f - floor_fall_alpha) * level_dB;
+  } else {
+    floor_dB = min(level_dB, floor_dB + floor_rise_dB);
+  }
+  is_first_block = false;
+
+  //combine the features into an instantaneous probability
+  float32_t inst_prob = 0.0f;
+  if (level_dB > min_level_dB) {
+    float32_t z = (level_dB - floor_dB - snr_thresh_dB) / snr_width_dB;
+    if (zc_rate_Hz > zc_knee_Hz) z -= 2.0f * (zc_rate_Hz - zc_knee_Hz) / zc_knee_Hz;  //penalize hiss
+    z = max(-20.0f, min(20.0f, z));
+    inst_prob = 1.0f / (1.0f + FastMath::exp2(-FastMath::LOG2_E * z));
+  }
+
+  //smooth with a fast attack and a slow release
+  const float32_t alpha = (inst_prob > speech_prob) ? attack_alpha : release_alpha;
+  speech_prob = alpha * speech_prob + (1.0f - alpha) * inst_prob;
+  block_count = block_count + 1;
+}
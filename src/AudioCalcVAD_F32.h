@@ -0,0 +1,140 @@
+
+/*
+ * AudioCalcVAD_F32
+ *
+ * Created: 2026
+ * Purpose: Low-cost voice activity detector (VAD).  Once per audio block, it estimates the probability
+ *     that speech (or, really, any non-steady sound) is present.  Other audio processing classes can be
+ *     given a pointer to this VAD so that they can skip work when it isn't needed, such as freezing the
+ *     noise estimate of AudioEffectNoiseReduction_FD_F32 during speech or (if asked) gating the adaptation
+ *     of AudioFeedbackCancelNLMS_F32.
+ *
+ * Features (all computed in the time domain, so no FFT is needed):
+ *     Level vs Noise Floor: The block's power is smoothed (exponential time weighting, like
+ *         AudioCalcLevel_F32) and compared to a noise floor that falls quickly but rises only slowly.
+ *         Steady background noise pulls the floor up to itself, so it doesn't count as speech.
+ *     Zero-Crossing Rate: Speech (even with its fricatives) has most of its energy at lower frequencies
+ *         than hiss does.  A high zero-crossing rate reduces the probability.
+ *     Minimum Level: Blocks quieter than the minimum level are always treated as silence.
+ *
+ * The features are combined via a logistic function into an instantaneous probability, which is then
+ * smoothed with a fast attack and a slow release (the "hangover") so that the gaps between words
+ * don't count as silence.
+ *
+ * Timing: The VAD updates when its update() is called.  Classes that use it will see the value from
+ * the current block if the VAD is updated first (ie, it was created first), otherwise from the previous block.
+ *
+ * The audio is passed through unchanged, so this can be inserted in-line.
+ *
+ * MIT License.  Use at your own risk.
+ */
+
+#ifndef _AudioCalcVAD_F32_h
+#define _AudioCalcVAD_F32_h
+
+#include <Arduino.h>
+#include <arm_math.h>
+#include "AudioStream_F32.h"
+#include "utility/FastMath_F32.h"
+
+class AudioCalcVAD_F32 : public AudioStream_F32
+{
+//GUI: inputs:1, outputs:1  //this line used for automatic generation of GUI node
+//GUI: shortName:VAD
+	public:
+		AudioCalcVAD_F32(void) : AudioStream_F32(1,inputQueueArray) { setInstanceName(); computeCoefficients(); }
+		AudioCalcVAD_F32(const AudioSettings_F32 &settings) : AudioStream_F32(1,inputQueueArray) {
+			setInstanceName();
+			sample_rate_Hz = settings.sample_rate_Hz;
+			block_len = settings.audio_block_samples;
+			computeCoefficients();
+		}
+		void setInstanceName(void) { instanceName = "AudioCalcVAD_F32"; }
+		void update(void) override;
+
+		// ///////////////////////////// results
+		float32_t getSpeechProb(void) const { return speech_prob; }   //0.0 to 1.0, smoothed
+		bool isSpeech(const float32_t thresh = 0.5f) const { return speech_prob > thresh; }
+		float32_t getLevel_dBFS(void) const { return level_dB; }
+		float32_t getNoiseFloor_dBFS(void) const { return floor_dB; }
+		float32_t getSNR_dB(void) const { return level_dB - floor_dB; }
+		float32_t getZeroCrossingRate_Hz(void) const { return zc_rate_Hz; }
+		uint32_t getBlockCount(void) const { return block_count; }
+		void reset(void) { is_first_block = true; speech_prob = 0.0f; }
+
+		// ///////////////////////////// gating the work of other classes
+		//Classes that offer a VAD gate use this to decide whether to do their optional work for this block.
+		//The polarity is always chosen explicitly by the user:
+		//   GATE_OFF:                 always do the work (the VAD is ignored)
+		//   GATE_OPEN_DURING_SPEECH:  only do the work when the speech probability is at least the threshold
+		//   GATE_OPEN_DURING_SILENCE: only do the work when the speech probability is below the threshold
+		enum GATE { GATE_OFF=0, GATE_OPEN_DURING_SPEECH, GATE_OPEN_DURING_SILENCE };
+		static bool isGateOpen(const AudioCalcVAD_F32 *vad, const int gate, const float32_t thresh) {
+			if ((vad == NULL) || (gate == GATE_OFF)) return true;
+			const bool speech = (vad->getSpeechProb() >= thresh);
+			return (gate == GATE_OPEN_DURING_SPEECH) ? speech : !speech;
+		}
+
+		// ///////////////////////////// parameters
+		float32_t setSNRThreshold_dB(float32_t val) { return snr_thresh_dB = val; }   //SNR that gives a probability of 0.5
+		float32_t getSNRThreshold_dB(void) const { return snr_thresh_dB; }
+		float32_t setSNRWidth_dB(float32_t val) { return snr_width_dB = max(0.1f, val); } //how sharply the probability changes around the threshold
+		float32_t getSNRWidth_dB(void) const { return snr_width_dB; }
+		float32_t setMinLevel_dBFS(float32_t val) { return min_level_dB = val; }
+		float32_t getMinLevel_dBFS(void) const { return min_level_dB; }
+		float32_t setZeroCrossingKnee_Hz(float32_t val) { return zc_knee_Hz = max(1.0f, val); }
+		float32_t getZeroCrossingKnee_Hz(void) const { return zc_knee_Hz; }
+		float32_t setLevelTimeConst_sec(float32_t val) { level_tau_sec = max(0.0f, val); computeCoefficients(); return level_tau_sec; }
+		float32_t getLevelTimeConst_sec(void) const { return level_tau_sec; }
+		float32_t setFloorRise_dBperSec(float32_t val) { floor_rise_dB_per_sec = max(0.0f, val); computeCoefficients(); return floor_rise_dB_per_sec; }
+		float32_t getFloorRise_dBperSec(void) const { return floor_rise_dB_per_sec; }
+		float32_t setAttack_sec(float32_t val) { attack_sec = max(0.0f, val); computeCoefficients(); return attack_sec; }
+		float32_t getAttack_sec(void) const { return attack_sec; }
+		float32_t setHangover_sec(float32_t val) { hangover_sec = max(0.0f, val); computeCoefficients(); return hangover_sec; } //release time constant
+		float32_t getHangover_sec(void) const { return hangover_sec; }
+
+	protected:
+		audio_block_f32_t *inputQueueArray[1];
+		float32_t sample_rate_Hz = AUDIO_SAMPLE_RATE_EXACT;
+		int block_len = AUDIO_BLOCK_SAMPLES;
+
+		//parameters
+		float32_t snr_thresh_dB = 6.0f;
+		float32_t snr_width_dB = 2.0f;
+		float32_t min_level_dB = -75.0f;
+		float32_t zc_knee_Hz = 2500.0f;
+		float32_t level_tau_sec = 0.020f;
+		float32_t floor_fall_tau_sec = 0.100f;
+		float32_t floor_rise_dB_per_sec = 3.0f;
+		float32_t attack_sec = 0.010f;
+		float32_t hangover_sec = 0.300f;
+
+		//per-block coefficients (computed from the parameters)
+		float32_t level_alpha = 0.0f, floor_fall_alpha = 0.0f, floor_rise_dB = 0.0f, attack_alpha = 0.0f, release_alpha = 0.0f;
+
+		//states
+		bool is_first_block = true;
+		float32_t level_pow = 0.0f;
+		float32_t level_dB = -200.0f;
+		float32_t floor_dB = -200.0f;
+		float32_t zc_rate_Hz = 0.0f;
+		float32_t prev_sample = 0.0f;
+		volatile float32_t speech_prob = 0.0f;
+		volatile uint32_t block_count = 0;
+
+		//same form as AudioFilterTimeWeighting_F32, but evaluated once per block
+		float32_t blockAlpha(const float32_t tau_sec) const {
+			const float32_t block_rate_Hz = sample_rate_Hz / ((float32_t)max(1, block_len));
+			return (tau_sec > 0.0f) ? expf(-1.0f / (block_rate_Hz * tau_sec)) : 0.0f;
+		}
+		virtual void computeCoefficients(void) {
+			level_alpha = blockAlpha(level_tau_sec);
+			floor_fall_alpha = blockAlpha(floor_fall_tau_sec);
+			floor_rise_dB = floor_rise_dB_per_sec * ((float32_t)block_len) / sample_rate_Hz;
+			attack_alpha = blockAlpha(attack_sec);
+			release_alpha = blockAlpha(hangover_sec);
+		}
+		virtual void processBlock(const float32_t *x, const int n);
+};
+
+#endif
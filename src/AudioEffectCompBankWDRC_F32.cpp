@@ -160,32 +160,54 @@ void AudioEffectCompBankWDRC_F32::update(void) {
 	//return if not enabled
 	if (!is_enabled) return;
 	
-	//loop over each channel...but only those up to the active channel limit
+	//loop over each channel...but only those up to the active channel limit.  The channels are gathered into
+	//small groups so that their envelopes can be computed together, while only holding a few output blocks
+	//from the memory pool at any one time.
+	const int N_GROUP = AudioCalcEnvelope_F32::N_LOCKSTEP;
 	int n_chan = state.get_n_chan();
-	for (int Ichan=0; Ichan < n_chan; Ichan++) {
-		
-		 //request the in-coming data block
-		audio_block_f32_t *block = AudioStream_F32::receiveReadOnly_f32(Ichan);
-		
-		if (block != NULL) { //did we get a block of data?
-		
-			//request a data block to hold th processed data
-			audio_block_f32_t *out_block = AudioStream_F32::allocate_f32();
+	int Ichan = 0;
+	while (Ichan < n_chan) {
+		audio_block_f32_t *in_blocks[N_GROUP], *out_blocks[N_GROUP];
+		AudioCalcEnvelope_F32 *envs[N_GROUP];
+		float *x[N_GROUP], *y[N_GROUP];
+		int Ichans[N_GROUP], n_ready = 0;
+		for ( ; (Ichan < n_chan) && (n_ready < N_GROUP); Ichan++) {
+			
+			 //request the in-coming data block
+			audio_block_f32_t *block = AudioStream_F32::receiveReadOnly_f32(Ichan);
+			
+			if (block != NULL) { //did we get a block of data?
 			
-			if (out_block != NULL) { //did we get a valid memory handle?
-				//do the algorithm
-				int is_error = compressors[Ichan].processAudioBlock(block,out_block); //anything other than a zero is an error
+				//request a data block to hold th processed data
+				audio_block_f32_t *out_block = AudioStream_F32::allocate_f32();
 				
-				//if we had no error, transmit the processed data
-				if (!is_error) AudioStream_F32::transmit(out_block, Ichan);
-
-			} else {
-				//Serial.println(F("AudioEffectCompBankWDRC_F32: update: could not allocate out_block ") + String(Ichan));
-			}
-			AudioStream_F32::release(out_block);  //release the memory block that we requested 
+				if (out_block != NULL) { //did we get a valid memory handle?
+					//remember this channel so that the group's envelopes can be computed together
+					in_blocks[n_ready] = block;  out_blocks[n_ready] = out_block;  Ichans[n_ready] = Ichan;
+					envs[n_ready] = &(compressors[Ichan].calcEnvelope);
+					x[n_ready] = block->data;  y[n_ready] = out_block->data;
+					n_ready++;
+				} else {
+					//Serial.println(F("AudioEffectCompBankWDRC_F32: update: could not allocate out_block ") + String(Ichan));
+					AudioStream_F32::release(block); //release the memory block that we requested
+				}
+			} 
 		} 
-		AudioStream_F32::release(block); //release the memory block that we requested
-	} 
+		if (n_ready == 0) continue;
+		
+		//compute the envelopes of this group of channels together (into the output blocks)
+		int n = in_blocks[0]->length;
+		AudioCalcEnvelope_F32::smooth_env_multi(envs, x, y, n_ready, n);
+		
+		//compute and apply each channel's gain, then transmit
+		for (int i=0; i < n_ready; i++) {
+			compressors[Ichans[i]].compress_givenEnvelope(x[i], y[i], y[i], n); //output block holds the envelope, then the gain, then the output
+			out_blocks[i]->id = in_blocks[i]->id;  out_blocks[i]->length = n;
+			AudioStream_F32::transmit(out_blocks[i], Ichans[i]);
+			AudioStream_F32::release(out_blocks[i]);  //release the memory block that we requested 
+			AudioStream_F32::release(in_blocks[i]);   //release the memory block that we requested
+		}
+	}
 }
 
 int AudioEffectCompBankWDRC_F32::set_n_chan(int val) {
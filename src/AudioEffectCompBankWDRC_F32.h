@@ -117,6 +117,11 @@ class AudioEffectCompBankWDRC_F32 : public AudioStream_F32 {
 		float getScaleFactor_dBSPL_at_dBFS(int i=0) { return getMaxdB(i);   }  //another name for getMaxdB
 		float getLinearGain_dB(int i=0)             { return getGain_dB(i); }   //another name for getGain_dB
 
+		//log each channel's level and gain at the given rate.  Read channel i's log via getTelemetry(i)->read()
+		void enableTelemetry(float rate_Hz = 100.0f) { for (int i=0; i < get_max_n_chan(); i++) compressors[i].enableTelemetry(rate_Hz); }
+		void disableTelemetry(void)                  { for (int i=0; i < get_max_n_chan(); i++) compressors[i].disableTelemetry(); }
+		GainTelemetry_F32* getTelemetry(int i=0)     { if (i < get_max_n_chan()) { return &(compressors[i].telemetry); } else { return NULL; }};
+
 		
 		// set parameter values to the all the compressors (ie, parameters that you might want to set globally)
 		float setAttack_msec_all(float val)  { for (int i=0; i < get_max_n_chan(); i++) setAttack_msec(val,i);  return getAttack_msec(); }
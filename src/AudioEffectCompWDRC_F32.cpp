@@ -130,20 +130,107 @@ void AudioEffectCompWDRC_F32::compress(float *x, float *y, int n)
 	calcEnvelope.smooth_env(x, envelope_block->data, n);
 	//float *xpk = envelope_block->data; //get pointer to the array of (empty) data values
 
-	//calculate gain
-	audio_block_f32_t *gain_block = AudioStream_F32::allocate_f32();
-	if (gain_block == NULL) return;  //failed to allocate
-	calcGain.calcGainFromEnvelope(envelope_block->data, gain_block->data, n);
+	//calculate gain and apply it
+	compress_givenEnvelope(x, envelope_block->data, y, n);
+
+	// release memory
+	AudioStream_F32::release(envelope_block);
+}
+
+void AudioEffectCompWDRC_F32::compress_givenEnvelope(float *x, float *env, float *y, int n)    
+//x, input, audio waveform data
+//env, input, the smoothed envelope of x.  It gets overwritten with the gain.
+//y, output, audio waveform data after compression
+//n, input, number of samples in this audio block
+{
+	//calculate gain (in place...it's OK because the envelope is converted to dB before the gain is written).
+	//If logging the telemetry, the envelope values to be logged are grabbed before they are overwritten.  This
+	//is done in segments so that the scratch array never overflows, no matter the block size.
+	const int SEG_LEN = GainTelemetry_F32::MIN_DECIMATION * GainTelemetry_F32::MAX_PER_BLOCK;
+	const int decim = telemetry.getDecimation();
+	float32_t env_log[GainTelemetry_F32::MAX_PER_BLOCK];
+	int k_log = telemetry.firstIndex();
+	for (int start = 0; start < n; start += SEG_LEN) {
+		const int seg_n = min(SEG_LEN, n - start);
+		const int k_first = k_log;
+		int n_log = 0;
+		for ( ; k_log < start + seg_n; k_log += decim) env_log[n_log++] = env[k_log];
+		
+		calcGain.calcGainFromEnvelope(env + start, env + start, seg_n);
+		
+		//log the telemetry (input level in dB SPL and gain in dB)
+		for (int i = 0; i < n_log; i++) {
+			int k = k_first + i*decim;
+			telemetry.push(k, calcGain.getMaxdB() + AudioCalcGainWDRC_F32::db2(env_log[i]), AudioCalcGainWDRC_F32::db2(env[k]));
+		}
+	}
+	telemetry.advance(n);
 	
 	//apply gain
-	arm_mult_f32(x, gain_block->data, y, n);
+	arm_mult_f32(x, env, y, n);
+}
+
+int AudioEffectCompWDRC_F32::processAudioBlock_linked(AudioEffectCompWDRC_F32 *other, audio_block_f32_t *block, audio_block_f32_t *block_other, 
+		audio_block_f32_t *out_block, audio_block_f32_t *out_block_other, int link_type, float weight)
+{
+	if ((other == NULL) || (block == NULL) || (block_other == NULL) || (out_block == NULL) || (out_block_other == NULL)) return -1;  //-1 is error
+	if (block->length != block_other->length) return -1;  //-1 is error
+	
+	if (compress_linked(other, block->data, block_other->data, out_block->data, out_block_other->data, block->length, link_type, weight) < 0) {
+		return -1;  //not compressed, so the caller must not send this audio
+	}
+	
+	//copy the audio_block info
+	out_block->id = block->id;              out_block->length = block->length;
+	out_block_other->id = block_other->id;  out_block_other->length = block_other->length;
+	
+	return 0;  //0 is OK
+}
+
+int AudioEffectCompWDRC_F32::compress_linked(AudioEffectCompWDRC_F32 *other, float *x, float *x_other, float *y, float *y_other, int n, int link_type, float weight)
+//other, input, the compressor for the other ear (its envelope state, gain curve, and telemetry are used)
+//x, x_other, input, audio waveform data for this ear and for the other ear
+//y, y_other, output, audio waveform data after compression
+//n, input, number of samples in this audio block
+{
+	// find the smoothed envelope of each ear (each ear keeps its own envelope state)
+	audio_block_f32_t *envelope_block = AudioStream_F32::allocate_f32();
+	if (envelope_block == NULL) return -1;  //failed to allocate
+	audio_block_f32_t *envelope_block_other = AudioStream_F32::allocate_f32();
+	if (envelope_block_other == NULL) { AudioStream_F32::release(envelope_block); return -1; }  //failed to allocate
+	calcEnvelope.smooth_env(x, envelope_block->data, n);
+	other->calcEnvelope.smooth_env(x_other, envelope_block_other->data, n);
+	
+	// combine the two envelopes into one (in place, in envelope_block)
+	float *env = envelope_block->data, *env_other = envelope_block_other->data;
+	switch (link_type) {
+		case LINK_MEAN:
+			arm_add_f32(env, env_other, env, n);
+			arm_scale_f32(env, 0.5f, env, n);
+			break;
+		case LINK_WEIGHTED:
+			weight = max(0.0f, min(1.0f, weight));
+			arm_scale_f32(env, weight, env, n);
+			arm_scale_f32(env_other, 1.0f - weight, env_other, n);
+			arm_add_f32(env, env_other, env, n);
+			break;
+		default: //LINK_MAX
+			for (int i=0; i < n; i++) if (env_other[i] > env[i]) env[i] = env_other[i];
+			break;
+	}
+	
+	//give the shared envelope to each ear's own gain curve (so that each ear keeps its own knee, CR, bolt, and
+	//limiter).  compress_givenEnvelope() also logs each ear's telemetry.
+	arm_copy_f32(env, env_other, n);
+	compress_givenEnvelope(x, env, y, n);
+	other->compress_givenEnvelope(x_other, env_other, y_other, n);
 
 	// release memory
 	AudioStream_F32::release(envelope_block);
-	AudioStream_F32::release(gain_block);
+	AudioStream_F32::release(envelope_block_other);
+	return 0;
 }
 
-
 //set all of the parameters for the compressor using the CHA_WDRC "GHA" structure
 void AudioEffectCompWDRC_F32::setParams_from_CHA_WDRC(const BTNRH_WDRC::CHA_WDRC *gha) {  //assumes that the sample rate has already been set!!!
 	//configure the envelope calculator...assumes that the sample rate has already been set!
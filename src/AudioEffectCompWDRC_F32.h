@@ -20,6 +20,7 @@ class AudioCalcGainWDRC_F32;  //forward declared.  Actually defined in later hea
 #include "AudioCalcEnvelope_F32.h"	//from Tympan_Library
 #include "AudioCalcGainWDRC_F32.h"  //has definition of CHA_WDRC
 #include "BTNRH_WDRC_Types.h"		//from Tympan_Library
+#include "utility/GainTelemetry_F32.h"  //from Tympan_Library
 #include <SerialManager_UI.h>       //from Tympan_Library
 #include <TympanRemoteFormatter.h> 	//from Tympan_Library
 
@@ -118,6 +119,23 @@ class AudioEffectCompWDRC_F32 : public AudioStream_F32
 		//with other ways of using this class.
 		virtual void compress(float *x, float *y, int n);
 
+		//Same as compress() but for when the envelope has already been computed (such as by 
+		//AudioCalcEnvelope_F32::smooth_env_multi() for a whole bank of compressors).  Note that
+		//the contents of env are overwritten (they become the gain).  env and y can be the same.
+		virtual void compress_givenEnvelope(float *x, float *env, float *y, int n);
+
+		//Binaural (stereo-linked) processing.  Here, this compressor is paired with the compressor for the
+		//other ear.  Each ear still tracks its own envelope, but the two envelopes are combined (per "link_type")
+		//and the combined envelope is fed through each ear's own gain curve.  So, both ears respond to the same
+		//level (which preserves the interaural level differences), while each ear still gets its own knee, CR,
+		//linear gain, and bolt/limiter.
+		enum LINK_TYPE { LINK_MAX=0, LINK_MEAN, LINK_WEIGHTED };
+		virtual int processAudioBlock_linked(AudioEffectCompWDRC_F32 *other, audio_block_f32_t *block, audio_block_f32_t *block_other, 
+			audio_block_f32_t *out_block, audio_block_f32_t *out_block_other, int link_type = LINK_MAX, float weight = 0.5f);
+		virtual int compress_linked(AudioEffectCompWDRC_F32 *other, float *x, float *x_other, float *y, float *y_other, int n, 
+			int link_type = LINK_MAX, float weight = 0.5f);  //weight is only used for LINK_WEIGHTED.  It is the weight given to *this* ear's envelope.
+			                                                 //Returns -1 (and leaves y and y_other untouched) if it could not get its working memory.
+
 		//You can bypass this algorithm (it'll pass the input directly to the output)
 		//As a way to save CPU if you don't actually want any compression or level monitoring.
 		//You can also use "setActive(false)" (from AudioStream_F32) which will stop the algorithm
@@ -150,6 +168,10 @@ class AudioEffectCompWDRC_F32 : public AudioStream_F32
 		virtual float getGain_dB(void) { return calcGain.getGain_dB(); }
 		virtual float getCurrentGain_dB(void) { return calcGain.getCurrentGain_dB(); }
 		virtual float getCurrentLevel_dB(void) { return AudioCalcGainWDRC_F32::db2(calcEnvelope.getCurrentLevel()); }  //this is 20*log10(abs(signal)) after the envelope smoothing
+
+		//log the input level (dB SPL), gain (dB), and output level (dB SPL) at the given rate.  Read the log via telemetry.read()
+		virtual void enableTelemetry(float rate_Hz = 100.0f) { telemetry.enable(rate_Hz, getSampleRate_Hz()); }
+		virtual void disableTelemetry(void) { telemetry.disable(); }
 	
 		//set or get the other parameters
 		virtual void setAttackRelease_msec(float32_t attack_ms, float32_t release_ms) {
@@ -188,6 +210,7 @@ class AudioEffectCompWDRC_F32 : public AudioStream_F32
 		AudioCalcEnvelope_F32 calcEnvelope;
 		AudioCalcGainWDRC_F32 calcGain;
 		AudioCompWDRCState state;
+		GainTelemetry_F32 telemetry;
 		
 			
 	private:
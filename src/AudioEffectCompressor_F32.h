@@ -15,6 +15,8 @@
 
 #include <arm_math.h> //ARM DSP extensions.  https://www.keil.com/pack/doc/CMSIS/DSP/html/index.html
 #include "AudioStream_F32.h"
+#include "utility/FastMath_F32.h"
+#include "utility/GainTelemetry_F32.h"
 
 class AudioEffectCompressor_F32 : public AudioStream_F32
 {
@@ -23,12 +25,14 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
     //constructor
     AudioEffectCompressor_F32(void) : AudioStream_F32(1, inputQueueArray_f32) {
 			setInstanceName();
-			setDefaultValues(AUDIO_SAMPLE_RATE);   resetStates();
+			sample_rate_Hz = AUDIO_SAMPLE_RATE;
+			setDefaultValues(sample_rate_Hz);   resetStates();
     };
 	
     AudioEffectCompressor_F32(const AudioSettings_F32 &settings) : AudioStream_F32(1, inputQueueArray_f32) {
 			setInstanceName();
-			setDefaultValues(settings.sample_rate_Hz);   resetStates();
+			sample_rate_Hz = settings.sample_rate_Hz;
+			setDefaultValues(sample_rate_Hz);   resetStates();
     };
 		void setInstanceName(void) { instanceName = "AudioEffectCompressor_F32"; }
 	
@@ -49,25 +53,69 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
       //apply a high-pass filter to get rid of the DC offset
       if (use_HP_prefilter) arm_biquad_cascade_df1_f32(&hp_filt_struct, audio_block->data, audio_block->data, audio_block->length);
       
-      //apply the pre-gain...a negative gain value will disable
-      if (pre_gain > 0.0f) arm_scale_f32(audio_block->data, pre_gain, audio_block->data, audio_block->length); //use ARM DSP for speed!
-
-      //calculate the level of the audio (ie, calculate a smoothed version of the signal power)
-      audio_block_f32_t *audio_level_dB_block = AudioStream_F32::allocate_f32();
-      calcAudioLevel_dB(audio_block, audio_level_dB_block); //returns through audio_level_dB_block
-
-      //compute the desired gain based on the observed audio level
-      audio_block_f32_t *gain_block = AudioStream_F32::allocate_f32();
-      calcGain(audio_level_dB_block, gain_block);  //returns through gain_block
-
-      //apply the desired gain...store the processed audio back into audio_block
-      arm_mult_f32(audio_block->data, gain_block->data, audio_block->data, audio_block->length);
+      //apply the pre-gain, estimate the level, compute the gain, and apply the gain...all in one pass
+      compress_fused(audio_block->data, audio_block->data, audio_block->length);
 
       //transmit the block and release memory
       AudioStream_F32::transmit(audio_block);
       AudioStream_F32::release(audio_block);
-      AudioStream_F32::release(gain_block);
-      AudioStream_F32::release(audio_level_dB_block);
+    }
+
+    // Here is the whole compressor (after the HP filter) in a single pass through the data.  It gives
+    // the same results as the step-by-step approach (the pre-gain, then calcAudioLevel_dB(), then calcGain(),
+    // then multiplying by the gain) but it keeps the level and gains in registers instead of writing each 
+    // step out to its own audio block.  So, it needs no extra audio blocks and is much lighter on memory.
+    // In-place operation (x == y) is fine.
+    void compress_fused(float32_t *x, float32_t *y, int n) {
+      //prepare constants
+      const float32_t c1 = level_lp_const, c2 = 1.0f - c1;                //for smoothing the level
+      const float32_t neg_thresh_dBFS = -thresh_dBFS, inv_comp_ratio = 1.0f / comp_ratio;  //for the target gain
+      const float32_t one_minus_attack_const = 1.0f - attack_const;       //for smoothing the gain
+      const float32_t one_minus_release_const = 1.0f - release_const;
+      const bool apply_pre_gain = (pre_gain > 0.0f);  //a negative gain value will disable
+      float32_t level_lp_pow = prev_level_lp_pow, gain_dB = prev_gain_dB;  //local copies of the states
+      float32_t above_thresh_dB = 0.0f;
+      
+      //if logging the telemetry, the loop is broken into segments that each end on a sample to be logged.
+      //This way, there is no per-sample cost to the logging.
+      int k_log = telemetry.firstIndex();
+      const int decim = telemetry.getDecimation();
+      int i = 0;
+      while (i < n) {
+       int i_end = (k_log < n) ? (k_log+1) : n;
+       for ( ; i < i_end; i++) {
+        float32_t wav = x[i];
+        if (apply_pre_gain) wav *= pre_gain;
+        
+        //level: first-order low-pass filter of the signal power, then convert to dB (same as calcAudioLevel_dB())
+        level_lp_pow = c1*level_lp_pow + c2*(wav*wav);
+        above_thresh_dB = FastMath::db_from_pow(level_lp_pow) + neg_thresh_dBFS;
+        
+        //instantaneous target gain, attenuation only (same as calcInstantaneousTargetGain())
+        float32_t targ_gain_dB = above_thresh_dB*inv_comp_ratio - above_thresh_dB;
+        if (targ_gain_dB > 0.0f) targ_gain_dB = 0.0f;
+        
+        //smooth the gain using the attack or release constants (same as calcSmoothedGain_dB())
+        if (targ_gain_dB < gain_dB) {  //are we in the attack phase?
+          gain_dB = attack_const*gain_dB + one_minus_attack_const*targ_gain_dB;
+        } else {   //or, we're in the release phase
+          gain_dB = release_const*gain_dB + one_minus_release_const*targ_gain_dB;
+        }
+
+        //convert from dB to linear gain and apply
+        y[i] = wav * FastMath::amp_from_db(gain_dB);
+       }
+       
+       //log the telemetry (input level in dBFS and gain in dB)
+       if (k_log < i) { telemetry.push(k_log, above_thresh_dB + thresh_dBFS, gain_dB);  k_log += decim; }
+      }
+      telemetry.advance(n);
+
+      //save the states for next time
+      prev_level_lp_pow = level_lp_pow;  prev_gain_dB = gain_dB;
+      
+      //limit the amount that the state of the smoothing filter can go toward negative infinity
+      if (prev_level_lp_pow < (1.0E-13)) prev_level_lp_pow = 1.0E-13;  //never go less than -130 dBFS 
     }
 
     // Here's the method that estimates the level of the audio (in dB)
@@ -87,16 +135,13 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
         
         // save the state of the first-order low-pass filter
         prev_level_lp_pow = wav_pow_block->data[i]; 
-
-        //now convert the signal power to dB (but not yet multiplied by 10.0)
-        level_dB_block->data[i] = log10f_approx(wav_pow_block->data[i]);
       }
 
       //limit the amount that the state of the smoothing filter can go toward negative infinity
       if (prev_level_lp_pow < (1.0E-13)) prev_level_lp_pow = 1.0E-13;  //never go less than -130 dBFS 
 
-      //scale the wav_pow_block by 10.0 to complete the conversion to dB
-      arm_scale_f32(level_dB_block->data, 10.0f, level_dB_block->data, level_dB_block->length); //use ARM DSP for speed!
+      //now convert the signal power to dB (ie, 10*log10(x))
+      FastMath::db_from_pow(wav_pow_block->data, level_dB_block->data, wav_pow_block->length);
 
       //release memory and return
       AudioStream_F32::release(wav_pow_block);
@@ -116,9 +161,7 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
       calcSmoothedGain_dB(inst_targ_gain_dB_block,gain_dB_block);
 
       //finally, convert from dB to linear gain: gain = 10^(gain_dB/20);  (ie this takes care of the sqrt, too!)
-      arm_scale_f32(gain_dB_block->data, 1.0f/20.0f, gain_dB_block->data, gain_dB_block->length);  //divide by 20 
-      for (int i = 0; i < gain_dB_block->length; i++) gain_block->data[i] = pow10f(gain_dB_block->data[i]); //do the 10^(x)
-      
+      FastMath::amp_from_db(gain_dB_block->data, gain_block->data, gain_dB_block->length);
 
       //release memory and return
       AudioStream_F32::release(gain_dB_block);
@@ -233,6 +276,11 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
     float32_t getCurrentLevel_dBFS(void) { return 10.0* log10f_approx(prev_level_lp_pow); }
     float32_t getCurrentGain_dB(void) { return prev_gain_dB; }
 
+    //log the input level (dBFS), gain (dB), and output level (dBFS) at the given rate.  Read the log via telemetry.read()
+    void enableTelemetry(float rate_Hz = 100.0f) { telemetry.enable(rate_Hz, sample_rate_Hz); }
+    void disableTelemetry(void) { telemetry.disable(); }
+    GainTelemetry_F32 telemetry;
+
     void setHPFilterCoeff_N2IIR_Matlab(float32_t b[], float32_t a[]){
       //https://www.keil.com/pack/doc/CMSIS/DSP/html/group__BiquadCascadeDF1.html#ga8e73b69a788e681a61bccc8959d823c5
       //Use matlab to compute the coeff for HP at 20Hz: [b,a]=butter(2,20/(44100/2),'high'); %assumes fs_Hz = 44100
@@ -245,6 +293,7 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
     audio_block_f32_t *inputQueueArray_f32[1]; //memory pointer for the input to this module
     float32_t prev_level_lp_pow = 1.0;
     float32_t prev_gain_dB = 0.0; //last gain^2 used
+    float32_t sample_rate_Hz = AUDIO_SAMPLE_RATE;  //only used for the telemetry rate
 
     //HP filter state-related variables
     arm_biquad_casd_df1_inst_f32 hp_filt_struct;
@@ -286,13 +335,13 @@ class AudioEffectCompressor_F32 : public AudioStream_F32
     // Accelerate the powf(10.0,x) function
     static float32_t pow10f(float x) {
       //return powf(10.0f,x)   //standard, but slower
-      return expf(2.302585092994f*x);  //faster:  exp(log(10.0f)*x)
+      return FastMath::pow_from_db(10.0f*x);  //faster.  see utility/FastMath_F32.h
     }
 
     // Accelerate the log10f(x)  function?
     static float32_t log10f_approx(float x) {
       //return log10f(x);   //standard, but slower
-      return log2f_approx(x)*0.3010299956639812f; //faster:  log2(x)/log2(10)
+      return FastMath::log2(x)*0.3010299956639812f; //faster:  log2(x)/log2(10).  see utility/FastMath_F32.h
     }
     
     /* ----------------------------------------------------------------------
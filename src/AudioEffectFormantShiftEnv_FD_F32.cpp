@@ -0,0 +1,125 @@
+
+#include "AudioEffectFormantShiftEnv_FD_F32.h"
+
+int AudioEffectFormantShiftEnv_FD_F32::setup(const AudioSettings_F32 &settings, const int _N_FFT) {
+	int ret_val = AudioFreqDomainBase_FD_F32::setup(settings, _N_FFT, _N_FFT);
+	if (ret_val < 0) return ret_val; //it failed, so simply return now
+
+	//setup the FFT and IFFT for the cepstrum.  No windowing!
+	const int N_FFT = getNFFT();
+	if (cepsFFT.setup(N_FFT) < 0) return -1;
+	cepsFFT.useRectangularWindow();
+	if (cepsIFFT.setup(N_FFT) < 0) return -1;
+
+	//allocate all of the memory that we'll need (so that nothing is allocated during update())
+	freeBuffers();
+	N_2 = N_FFT / 2 + 1;
+	bool ok = true;
+	for (int i=0; i < 2; i++) {
+		warp_tables[i].ind = new int16_t[N_2];
+		warp_tables[i].frac = new float32_t[N_2];
+		ok = ok && (warp_tables[i].ind != NULL) && (warp_tables[i].frac != NULL);
+	}
+	env_log2 = new float32_t[N_2];
+	gain = new float32_t[N_2];
+	ceps_buffer = new float32_t[2*N_FFT];
+	if ((!ok) || (env_log2 == NULL) || (gain == NULL) || (ceps_buffer == NULL)) {
+		Serial.println(F("AudioEffectFormantShiftEnv_FD_F32: setup: *** ERROR ***: could not allocate memory."));
+		freeBuffers();  enabled = 0;
+		return -1;
+	}
+	for (int i=0; i < N_2; i++) env_log2[i] = 0.0f;
+	for (int i=0; i < N_2; i++) { warp_tables[0].ind[i] = -1;  warp_tables[0].frac[i] = 0.0f; } //in use until the first rebuild
+
+	//build the tables that depend upon the sample rate and N_FFT
+	computeNCeps();
+	rebuildWarpTable();
+	return ret_val;
+}
+
+//convert the lifter cutoff (msec) into a number of cepstral coefficients
+void AudioEffectFormantShiftEnv_FD_F32::computeNCeps(void) {
+	if (N_2 < 2) return;  //not set up yet
+	int n = (int)(lifter_cutoff_msec * 0.001f * getSampleRate_Hz() + 0.5f);
+	n_ceps = max(1, min(N_2-1, n));
+}
+
+//For each destination bin, find the (fractional) source bin.  Only called when the parameters change.  The
+//new table is built in the spare, and then swapped in, so processAudioFD() never uses a half-built table.
+void AudioEffectFormantShiftEnv_FD_F32::rebuildWarpTable(void) {
+	WarpTable *spare = (warp == &warp_tables[0]) ? &warp_tables[1] : &warp_tables[0];
+	int16_t *warp_ind = spare->ind;
+	float32_t *warp_frac = spare->frac;
+	if ((warp_ind == NULL) || (warp_frac == NULL)) return;  //not set up yet
+	const float inv_scale_fac = 1.0f / shift_scale_fac;
+	const int max_source_ind = min((int)(max_source_Hz / getSampleRate_Hz() * getNFFT() + 0.5f), N_2);
+
+	warp_ind[0] = -1;  warp_frac[0] = 0.0f;  //zero out the lowest bin
+	for (int dest_ind = 1; dest_ind < N_2; dest_ind++) {
+		float source_ind_float = ((float)dest_ind) * inv_scale_fac;
+		int ind = min(max(1, (int)source_ind_float), N_2 - 2);  //use -2 (not -1) so that the +1 for the interpolation stays within nyquist
+		if ((source_ind_float < (float)max_source_ind) && (ind < max_source_ind)) {
+			warp_ind[dest_ind] = (int16_t)ind;
+			warp_frac[dest_ind] = max(0.0f, min(1.0f, source_ind_float - (float)ind));
+		} else {
+			warp_ind[dest_ind] = -1;  warp_frac[dest_ind] = 0.0f;  //source is too high, so zero the bin
+		}
+	}
+	__disable_irq(); warp = spare; __enable_irq();
+}
+
+//Estimate the spectral envelope (as log2(power)) by liftering the cepstrum
+void AudioEffectFormantShiftEnv_FD_F32::calcEnvelope(float32_t *complex_2N_buffer) {
+	const int N_FFT = getNFFT();
+
+	//log power spectrum.  It is real and even, so fill in the negative frequencies by mirroring
+	arm_cmplx_mag_squared_f32(complex_2N_buffer, gain, N_2);
+	FastMath::log2(gain, gain, N_2);
+	for (int k=0; k < N_2; k++) { ceps_buffer[2*k] = gain[k]; ceps_buffer[2*k+1] = 0.0f; }
+	for (int k=1; k < N_2-1; k++) { ceps_buffer[2*(N_FFT-k)] = gain[k]; ceps_buffer[2*(N_FFT-k)+1] = 0.0f; }
+
+	//to the cepstrum (scaled by N_FFT, which the IFFT will undo)
+	cepsFFT.execute(ceps_buffer);
+
+	//lifter: zero all quefrencies from n_ceps through N_FFT-n_ceps
+	for (int i = 2*n_ceps; i <= 2*(N_FFT-n_ceps)+1; i++) ceps_buffer[i] = 0.0f;
+
+	//back to the (now smoothed) log power spectrum
+	cepsIFFT.execute(ceps_buffer);
+	for (int k=0; k < N_2; k++) env_log2[k] = ceps_buffer[2*k];
+}
+
+//Here is the method that is the starting point
+//
+//  Argument 1: complex_2N_buffer is the float32_t array that holds the FFT results that we are going to
+//     manipulate.  It is 2*NFFT in length because it contains the real and imaginary data values
+//     for each FFT bin.  Real and imaginary are interleaved.  We only need to worry about the bins
+//     up to Nyquist because AudioFreqDomainBase will reconstruct the freuqency bins above Nyquist for us.
+//
+//  We get our data from complex_2N_buffer and we put our results back into complex_2N_buffer
+void AudioEffectFormantShiftEnv_FD_F32::processAudioFD(float32_t *complex_2N_buffer) {
+	if (ceps_buffer == NULL) return;  //not set up yet
+
+	//get the spectral envelope of the original audio
+	calcEnvelope(complex_2N_buffer);
+
+	//for each bin, the warped envelope minus the original envelope is the gain, as log2(power)
+	const WarpTable *cur_warp = warp;  //the main loop might swap in a new table, but only between calls to this method
+	const int16_t *warp_ind = cur_warp->ind;
+	const float32_t *warp_frac = cur_warp->frac;
+	const float32_t max_log2 = max_gain_log2_pow;
+	for (int k=0; k < N_2; k++) {
+		const int s = warp_ind[k];
+		if (s < 0) {
+			gain[k] = -126.0f;  //zero the bin (well, 2^-126, which is the smallest normal float)
+		} else {
+			float32_t g = env_log2[s] + warp_frac[k]*(env_log2[s+1] - env_log2[s]) - env_log2[k];
+			g = max(-max_log2, min(max_log2, g));
+			gain[k] = 0.5f*g;  //from power to amplitude
+		}
+	}
+	FastMath::exp2(gain, gain, N_2);
+
+	//apply the gain to each bin (both real and imaginary)
+	arm_cmplx_mult_real_f32(complex_2N_buffer, gain, complex_2N_buffer, N_2);
+}
@@ -0,0 +1,118 @@
+
+/*
+ * AudioEffectFormantShiftEnv_FD_F32
+ *
+ * Created: 2026
+ * Purpose: Shift the formants of the audio up or down (like AudioEffectFormantShift_FD_F32) while leaving
+ *          the pitch alone.  Instead of moving the raw FFT magnitudes, this estimates a smoothed spectral
+ *          envelope (via cepstral liftering) and then moves that envelope.  Each bin is scaled by the ratio
+ *          of the warped envelope to the original envelope, so the fine (harmonic) structure stays put.
+ *
+ *          Spectral Envelope: The log power spectrum is turned into a cepstrum (via an FFT), everything
+ *          above the lifter's cutoff quefrency is zeroed (ie, the pitch harmonics are removed), and then
+ *          it is turned back into a log power spectrum (via an IFFT).  The cost is two N_FFT-point FFTs
+ *          per hop, regardless of the audio content.
+ *
+ *          Warping Table: The source bin (and interpolation weight) for each destination bin only depends
+ *          upon the scale factor.  So, the table is built only when the scale factor (or the maximum source
+ *          frequency) is changed, not every hop.
+ *
+ *          No Divides: Since the envelope is kept as log2(power), the envelope ratio is simply a subtraction
+ *          followed by one exp2() per bin.  The ratio is limited by setMaxGain_dB() so that a bin can't blow
+ *          up where the envelope is near zero.
+ *
+ *          Source Limit: Destination bins whose source is above getMaxSourceFreq_Hz() are zeroed.  This is
+ *          set in Hz and is converted to bins using the actual sample rate and N_FFT.
+ *
+ * This processes a single stream of audio data (ie, it is mono)
+ *
+ * MIT License.  use at your own risk.
+*/
+
+#ifndef _AudioEffectFormantShiftEnv_FD_F32_h
+#define _AudioEffectFormantShiftEnv_FD_F32_h
+
+#include "AudioStream_F32.h"
+#include "AudioFreqDomainBase_FD_F32.h"
+#include "FFT_F32.h"
+#include "utility/FastMath_F32.h"
+#include <arm_math.h>
+#include <Arduino.h>
+
+class AudioEffectFormantShiftEnv_FD_F32 : public AudioFreqDomainBase_FD_F32
+{
+//GUI: inputs:1, outputs:1  //this line used for automatic generation of GUI node
+//GUI: shortName:formant_env
+  public:
+    //constructors...a few different options.  The usual one should be: AudioEffectFormantShiftEnv_FD_F32(const AudioSettings_F32 &settings, const int _N_FFT)
+    AudioEffectFormantShiftEnv_FD_F32(void) : AudioFreqDomainBase_FD_F32() { setInstanceName(); };
+    AudioEffectFormantShiftEnv_FD_F32(const AudioSettings_F32 &settings) :  AudioFreqDomainBase_FD_F32(settings)  { setInstanceName(); }
+    AudioEffectFormantShiftEnv_FD_F32(const AudioSettings_F32 &settings, const int _N_FFT) :  AudioFreqDomainBase_FD_F32(settings)  { setInstanceName(); setup(settings, _N_FFT); }
+    void setInstanceName(void) { instanceName = "AudioEffectFormantShiftEnv_FD_F32"; }
+
+    //destructor...release all of the memory that has been allocated
+    virtual ~AudioEffectFormantShiftEnv_FD_F32(void) { freeBuffers(); }
+
+    int setup(const AudioSettings_F32 &settings, const int _N_FFT) override;
+
+    //void update(void) override;  // we'll use the one from the parent class
+    void processAudioFD(float32_t *complex_2N_buffer) override;  //this is where we put all the processing.  It'll get called by the parent's update()
+
+    // set and get methods for parameters specific to the formant shifting
+    float setScaleFactor(float scale_fac) {
+      if (scale_fac < 0.00001) scale_fac = 0.00001;
+      shift_scale_fac = scale_fac;
+      rebuildWarpTable();
+      return shift_scale_fac;
+    }
+    float getScaleFactor(void) const { return shift_scale_fac; }
+    float setScaleFac(float scale_fac) { return setScaleFactor(scale_fac); }
+    float getScaleFac(void) const { return getScaleFactor(); }
+    float setMaxSourceFreq_Hz(float freq_Hz) { max_source_Hz = max(0.0f, freq_Hz); rebuildWarpTable(); return max_source_Hz; } //highest frequency to use as source data
+    float getMaxSourceFreq_Hz(void) const { return max_source_Hz; }
+    float setLifterCutoff_msec(float val_msec) { lifter_cutoff_msec = max(0.0f, val_msec); computeNCeps(); return lifter_cutoff_msec; } //shorter is a smoother envelope.  Keep it below the pitch period.
+    float getLifterCutoff_msec(void) const { return lifter_cutoff_msec; }
+    int getNCepstralCoeff(void) const { return n_ceps; }
+    float setMaxGain_dB(float val_dB) { max_gain_log2_pow = max(0.0f, val_dB) * FastMath::LOG2_PER_DB10; return getMaxGain_dB(); } //limit on how much the envelope ratio can boost (or cut) a bin
+    float getMaxGain_dB(void) const { return max_gain_log2_pow / FastMath::LOG2_PER_DB10; }
+    const float32_t* getEnvelope_log2Pow(void) const { return env_log2; } //the most recent spectral envelope, log2(power), DC through Nyquist
+
+  protected:
+    float shift_scale_fac = 1.0;            //how much to shift formants (frequency multiplier).  1.0 is no shift
+    float max_source_Hz = 10000.0;          //highest frequency to use as source data
+    float lifter_cutoff_msec = 1.5;         //keep the cepstral coefficients below this quefrency
+    float32_t max_gain_log2_pow = 30.0f * FastMath::LOG2_PER_DB10;   //limit on the envelope ratio, expressed as log2(power)
+    int N_2 = 0;                            //number of bins from DC through Nyquist
+    int n_ceps = 0;                         //number of cepstral coefficients to keep (including c[0])
+
+    struct WarpTable {
+      int16_t *ind = NULL;                  //for each destination bin, the lower of the two source bins.  Negative means to zero the bin.
+      float32_t *frac = NULL;               //for each destination bin, the weight given to the upper of the two source bins
+    };
+    WarpTable warp_tables[2];               //the table in use plus a spare, for rebuilding while the audio is running
+    const WarpTable * volatile warp = &warp_tables[0];
+    float32_t *env_log2 = NULL;             //smoothed spectral envelope, log2(power), DC through Nyquist
+    float32_t *gain = NULL;                 //per-bin gain (also used as scratch)
+    float32_t *ceps_buffer = NULL;          //complex, N_FFT long, for computing the cepstrum
+    FFT_F32 cepsFFT;
+    IFFT_F32 cepsIFFT;
+
+    void freeBuffers(void) {
+      for (int i=0; i < 2; i++) {
+        if (warp_tables[i].ind != NULL) delete[] warp_tables[i].ind;
+        if (warp_tables[i].frac != NULL) delete[] warp_tables[i].frac;
+        warp_tables[i].ind = NULL;  warp_tables[i].frac = NULL;
+      }
+      warp = &warp_tables[0];
+      if (env_log2 != NULL) delete[] env_log2;
+      if (gain != NULL) delete[] gain;
+      if (ceps_buffer != NULL) delete[] ceps_buffer;
+      env_log2 = gain = ceps_buffer = NULL;
+    }
+    void computeNCeps(void);
+    virtual void rebuildWarpTable(void);  //builds the spare table, then swaps it in
+    virtual void calcEnvelope(float32_t *complex_2N_buffer);
+};
+
+
+#endif
@@ -0,0 +1,148 @@
+
+#include "AudioEffectFreqComp_FD_F32.h"
+
+// ///////////////////////////////////////////////////////////////// FreqCompMap_F32
+
+int FreqCompMap_F32::allocate(const int _N_FFT) {
+  if ((_N_FFT == N_FFT) && (source_ind != NULL)) return N_FFT;  //already allocated
+  freeMemory();
+  N_2 = _N_FFT / 2 + 1;
+  source_ind = new int16_t[N_2];
+  interp_fac = new float32_t[N_2];
+  if ((source_ind == NULL) || (interp_fac == NULL)) {
+    Serial.println(F("FreqCompMap_F32: allocate: *** ERROR ***: could not allocate memory."));
+    freeMemory();
+    return -1;
+  }
+  N_FFT = _N_FFT;
+  for (int i=0; i < N_2; i++) { source_ind[i] = -1; interp_fac[i] = 0.0f; } //default to leaving everything unchanged
+  return N_FFT;
+}
+
+//For each destination bin, find the (fractional) source bin using S = T + (D - T - dF) / R
+void FreqCompMap_F32::rebuild(const float sample_rate_Hz, const float start_freq_Hz, const float shift_Hz, const float scale_fac) {
+  if (source_ind == NULL) return;
+  const float Hz_per_bin = sample_rate_Hz / ((float)N_FFT);
+  const float inv_scale_fac = 1.0f / scale_fac;
+
+  first_bin = N_2;
+  source_ind[0] = -1;  interp_fac[0] = 0.0f; //don't change the zero bin, keep it at its original
+  for (int dest_ind = 1; dest_ind < N_2; dest_ind++) {
+    //what is the source frequency for the new magnitude for this current destination bin
+    float dest_freq_Hz = dest_ind * Hz_per_bin;  //convert from bin # to frequency
+    float source_freq_Hz = start_freq_Hz + (dest_freq_Hz - start_freq_Hz - shift_Hz) * inv_scale_fac;
+    float source_ind_float = source_freq_Hz / Hz_per_bin;
+
+    //is the source high enough to be above the start frequency for the shifting?
+    if (source_freq_Hz >= start_freq_Hz) {
+      //get the source index for the interpolation.  Use -2 (not -1) so that the +1 for the interpolation stays within nyquist.
+      //Sources above nyquist are clamped to the nyquist bin (ie, interp_fac of 1.0 on the top pair of bins).
+      int ind = min(max(0, (int)(source_ind_float+0.001f)), N_2 - 2);
+      source_ind[dest_ind] = (int16_t)ind;
+      interp_fac[dest_ind] = max(0.0f, min(1.0f, source_ind_float - (float)ind));
+      if (dest_ind < first_bin) first_bin = dest_ind;
+    } else {
+      //leave the original audio in that bin unchanged
+      source_ind[dest_ind] = -1;  interp_fac[dest_ind] = 0.0f;
+    }
+  }
+}
+
+// ///////////////////////////////////////////////////////////////// AudioEffectFreqComp_FD_F32
+
+int AudioEffectFreqComp_FD_F32::setup(const AudioSettings_F32 &settings, const int target_N_FFT) {
+  int actual_N_FFT = AudioFreqDomainBase_FD_F32::setup(settings, target_N_FFT);
+  if (actual_N_FFT < 0) return actual_N_FFT;  //it failed
+
+  //allocate the scratch memory and the maps (a shared map is allocated by its stereo object instead)
+  if (scratch != NULL) delete[] scratch;
+  scratch = new float32_t[2*(actual_N_FFT / 2 + 1)];
+  bool ok = (scratch != NULL);
+  if (ok && !isMapShared()) ok = (maps[0].allocate(actual_N_FFT) >= 0) && (maps[1].allocate(actual_N_FFT) >= 0);
+  if (!ok) {
+    Serial.println(F("AudioEffectFreqComp_FD_F32: setup: *** ERROR ***: could not allocate memory."));
+    enabled = 0;
+    return -1;
+  }
+
+  //the bin quantization of the knee and shift depend on N_FFT, so re-apply them and rebuild the map
+  start_freq_Hz = roundToBin_Hz(start_freq_Hz);
+  shift_Hz = roundToBin_Hz(shift_Hz);
+  rebuildMap();
+  return actual_N_FFT;
+}
+
+void AudioEffectFreqComp_FD_F32::processAudioFD(float32_t *complex_2N_buffer)
+{
+  const FreqCompMap_F32 *cur_map = *live_map;  //the main loop might swap in a new map, but only between calls to this method
+  if ((scratch == NULL) || (cur_map->N_FFT != getNFFT())) return;  //not set up yet
+  if (shiftOnlyTheMagnitude) {
+    remapMagnitudes(complex_2N_buffer, scratch, cur_map);
+  } else {
+    remapComplex(complex_2N_buffer, scratch, cur_map);
+  }
+}
+
+//shift the audio by vocoding, which is the shifting of the FFT amplitudes but leaving the FFT phases in place.
+//All of the work of deciding where each bin comes from was done already by the map.
+void AudioEffectFreqComp_FD_F32::remapMagnitudes(float32_t *complex_2N_buffer, float32_t *orig_mag, const FreqCompMap_F32 *map) {
+  const int N_2 = map->N_2;
+
+  //get the magnitude for each FFT bin and store somewhere safe
+  arm_cmplx_mag_f32(complex_2N_buffer, orig_mag, N_2);
+
+  //now, loop over each bin and scale it to have the new magnitude (interpolated from the source bins)
+  const int16_t *source_ind = map->source_ind;
+  const float32_t *interp_fac = map->interp_fac;
+  for (int dest_ind = map->first_bin; dest_ind < N_2; dest_ind++) {
+    const int src = source_ind[dest_ind];
+    if (src < 0) continue;  //leave the original audio in that bin unchanged
+
+    //interpolate in the original magnitude vector to find the new magnitude that we want, then scale
+    float32_t new_mag = orig_mag[src] + interp_fac[dest_ind] * (orig_mag[src + 1] - orig_mag[src]);
+    float32_t scale = (orig_mag[dest_ind] > 1.0e-20f) ? (new_mag / orig_mag[dest_ind]) : 0.0f;
+    complex_2N_buffer[2 * dest_ind] *= scale; //real
+    complex_2N_buffer[2 * dest_ind + 1] *= scale; //imaginary
+  }
+}
+
+//move the complex values (magnitude and phase).  Work from a copy of the original values so that it
+//doesn't matter whether the sources are above or below their destinations.
+void AudioEffectFreqComp_FD_F32::remapComplex(float32_t *complex_2N_buffer, float32_t *orig_complex, const FreqCompMap_F32 *map) {
+  const int N_2 = map->N_2;
+  const int16_t *source_ind = map->source_ind;
+  const float32_t *interp_fac = map->interp_fac;
+  for (int i = 0; i < 2*N_2; i++) orig_complex[i] = complex_2N_buffer[i];
+
+  for (int dest_ind = map->first_bin; dest_ind < N_2; dest_ind++) {
+    const int src = source_ind[dest_ind];
+    if (src < 0) continue;  //leave the original audio in that bin unchanged
+    const float32_t f = interp_fac[dest_ind];
+    const float32_t *s = &(orig_complex[2*src]);
+    complex_2N_buffer[2 * dest_ind]     = s[0] + f * (s[2] - s[0]); //real
+    complex_2N_buffer[2 * dest_ind + 1] = s[1] + f * (s[3] - s[1]); //imaginary
+  }
+}
+
+// ///////////////////////////////////////////////////////////////// AudioEffectFreqCompStereo_FD_F32
+
+int AudioEffectFreqCompStereo_FD_F32::setup(const AudioSettings_F32 &settings, const int target_N_FFT) {
+  int N_FFT = left.setup(settings, target_N_FFT);
+  if (N_FFT < 0) return N_FFT;  //it failed
+  if ((right.setup(settings, target_N_FFT) < 0) || (maps[0].allocate(N_FFT) < 0) || (maps[1].allocate(N_FFT) < 0)) {
+    Serial.println(F("AudioEffectFreqCompStereo_FD_F32: setup: *** ERROR ***: could not allocate memory."));
+    left.enabled = 0;  right.enabled = 0;
+    return -1;
+  }
+
+  //the channels re-quantized their knee and shift for this N_FFT, so build the shared map to match
+  rebuildMap();
+  return N_FFT;
+}
+
+void AudioEffectFreqCompStereo_FD_F32::rebuildMap(void) {
+  FreqCompMap_F32 *spare = (map == &maps[0]) ? &maps[1] : &maps[0];
+  if (spare->N_FFT <= 0) return;  //not set up yet
+  spare->rebuild(left.getSampleRate_Hz(), left.start_freq_Hz, left.shift_Hz, left.shift_scale_fac);
+  __disable_irq(); map = spare; __enable_irq();  //both channels read the map through this one pointer
+}
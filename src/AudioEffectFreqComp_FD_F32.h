@@ -0,0 +1,213 @@
+
+/*
+ * AudioEffectFreqComp_FD_F32
+ *
+ * Created: Chip Audette, Open Audio, October 2020 (updated June 2021).  Moved into the library 2026.
+ * Purpose: Non-linear frequency compression (ie, frequency lowering), performed in the frequency domain.
+ *     Frequencies below the knee (the "start" frequency) are untouched.  Frequencies above the knee
+ *     are squeezed down (or shifted) toward the knee, which is typically used to move high-frequency
+ *     content into a region where the listener can still hear.
+ *
+ *     Only the FFT magnitudes are moved (ie, a vocoder), while the FFT phases stay at their original
+ *     frequencies.  Optionally, the whole complex values can be moved instead.
+ *
+ * The frequency remapping follows this relationship:
+ *   D = Destiation Frequeny (ie, the new frequency, Hz)
+ *   S = Source Frequency (ie, the original frequency, Hz)
+ *   T = The starting frequency for the lowering (Hz)
+ *   dF = The amount of frequency shifting (Hz)
+ *   R = This is the frequency shift ratio (values below 1.0 compress; above 1.0 expand.  THIS IS ALSO 1.0/CompRatio!!!)
+ *
+ *   D = T + dF + (S - T) * R    or    S = T + (D - T - dF) / R
+ *
+ * Bin Map: The mapping from each destination bin back to its source bins (and the interpolation weight
+ *     between them) only depends upon the knee, the ratio, and the shift.  So, it is computed once
+ *     (via FreqCompMap_F32) whenever one of those changes, rather than every FFT.  Each instance keeps
+ *     two maps: a new map is built in the one that isn't in use and then swapped in, so the settings
+ *     can be changed while the audio is running.  For stereo, AudioEffectFreqCompStereo_FD_F32 owns
+ *     one such pair of maps, and its left and right channels both read whichever map is live.  So,
+ *     each setting change builds one map (not two), and both ears switch to it on the same FFT.
+ *
+ * Sources above Nyquist: when a destination bin's source frequency would be above Nyquist (such as
+ *     when expanding, or when shifting down), the destination bin gets the magnitude of the highest
+ *     (Nyquist) bin, as in the original example.
+ *
+ * MIT License.  Use at your own risk.
+ */
+
+#ifndef _AudioEffectFreqComp_FD_F32_h
+#define _AudioEffectFreqComp_FD_F32_h
+
+#include "AudioFreqDomainBase_FD_F32.h" //from Tympan_Library: inherit all the good stuff from this!
+#include <arm_math.h>  //fast math library for our processor
+#include <Arduino.h>
+
+// Precomputed mapping from each destination bin to its source bins
+class FreqCompMap_F32 {
+  public:
+    FreqCompMap_F32(void) {};
+    ~FreqCompMap_F32(void) { freeMemory(); }
+
+    int allocate(const int _N_FFT);  //returns the N_FFT, or -1 if it failed
+    void rebuild(const float sample_rate_Hz, const float start_freq_Hz, const float shift_Hz, const float scale_fac);
+
+    int N_FFT = 0, N_2 = 0;
+    int first_bin = 0;               //bins below this are left unchanged
+    int16_t *source_ind = NULL;      //for each destination bin, the lower of the two source bins.  Negative means to leave the bin unchanged.
+    float32_t *interp_fac = NULL;    //for each destination bin, the weight given to the upper of the two source bins
+
+  protected:
+    void freeMemory(void) {
+      if (source_ind != NULL) delete[] source_ind;
+      if (interp_fac != NULL) delete[] interp_fac;
+      source_ind = NULL;  interp_fac = NULL;  N_FFT = 0;  N_2 = 0;
+    }
+};
+
+//Create an audio processing class to do the compression in the frequency domain.
+// Let's inherit from  the Tympan_Library class "AudioFreqDomainBase_FD_F32" to do all of the
+// audio buffering and FFT/IFFT operations.  That allows us to just focus on manipulating the
+// FFT bins and not all of the detailed, tricky operations of going into and out of the frequency
+// domain.
+class AudioEffectFreqComp_FD_F32 : public AudioFreqDomainBase_FD_F32
+{
+  //GUI: inputs:1, outputs:1  //this line used for automatic generation of GUI node
+  //GUI: shortName:freq_comp
+  public:
+    // constructor
+    AudioEffectFreqComp_FD_F32(const AudioSettings_F32 &settings) : AudioFreqDomainBase_FD_F32(settings) { setInstanceName(); };
+    void setInstanceName(void) { instanceName = "AudioEffectFreqComp_FD_F32"; }
+
+    //destructor...release all of the memory that has been allocated
+    virtual ~AudioEffectFreqComp_FD_F32(void) { if (scratch != NULL) delete[] scratch; }
+
+    //setup...extend the setup that is part of AudioFreqDomainBase_FD_F32
+    int setup(const AudioSettings_F32 &settings, const int target_N_FFT) override;
+
+    // get/set methods specific to this particular frequency-domain algorithm
+    // (when this is one channel of AudioEffectFreqCompStereo_FD_F32, the map is shared, so set these via the stereo object)
+    float setScaleFactor(float scale_fac) {
+      if (refuseIfMapShared("setScaleFactor")) return shift_scale_fac;
+      shift_scale_fac = limitScaleFactor(scale_fac);
+      rebuildMap();
+      return shift_scale_fac;
+    }
+    float getScaleFactor(void) const {  return shift_scale_fac; }
+    float setStartFreq_Hz(float freq_Hz) {
+      if (refuseIfMapShared("setStartFreq_Hz")) return start_freq_Hz;
+      start_freq_Hz = roundToBin_Hz(max(0.0f, freq_Hz)); //prevent negative start frequencies
+      rebuildMap();
+      return start_freq_Hz;
+    }
+    float getStartFreq_Hz(void) const { return start_freq_Hz; }
+    float setShift_Hz(const float freq_Hz) { //only allow setting to an amount equal to one FFT bin
+      if (refuseIfMapShared("setShift_Hz")) return shift_Hz;
+      shift_Hz = roundToBin_Hz(freq_Hz);
+      rebuildMap();
+      return shift_Hz;
+    }
+    float getShift_Hz(void) const { return shift_Hz; };
+    int setShift_bins(const int shift_bins) { setShift_Hz(getHzPerBin() * (float)shift_bins); return getShift_bins(); }
+    int getShift_bins(void) { return round(getShift_Hz() / getHzPerBin()); }
+    float setFreqCompRatio(const float val) {  //1.0 is no compression.  Values larger than 1.0 squeeze the frequency range (so, a scale factor less than 1.0).
+      setScaleFactor(1.0f / val);
+      return getFreqCompRatio();
+    }
+    float getFreqCompRatio(void) const { return (1.0f/shift_scale_fac); }
+
+    bool setShiftOnlyTheMagnitude(const bool _val) { return shiftOnlyTheMagnitude = _val; }; //if true, it's a vocoder.  Otherwise, the complex values are moved.
+    bool getShiftOnlyTheMagnitude(void) const { return shiftOnlyTheMagnitude; }; //if true, it's a vocoder.  Otherwise, the complex values are moved.
+
+    //the map that is in use (which is the stereo object's map, if this is one of its channels)
+    const FreqCompMap_F32* getMap(void) const { return *live_map; }
+    bool isMapShared(void) const { return live_map != &map; }
+
+    //build the map for the current settings in the spare map, and then swap it in
+    void rebuildMap(void) {
+      if (isMapShared()) return;  //the stereo object builds the shared map
+      FreqCompMap_F32 *spare = (map == &maps[0]) ? &maps[1] : &maps[0];
+      if (spare->N_FFT <= 0) return;  //not set up yet
+      spare->rebuild(getSampleRate_Hz(), start_freq_Hz, shift_Hz, shift_scale_fac);
+      __disable_irq(); map = spare; __enable_irq();
+    }
+
+    //this is the method from AudioFreqDomainBase that we are overriding where we will
+    //put our own code for manipulating the frequency data.  This is called by update()
+    //from the AudioFreqDomainBase_FD_F32.  The update() method is itself called by the
+    //Tympan (Teensy) audio system, as with every other Audio processing class.
+    virtual void processAudioFD(float32_t *complex_2N_buffer) override;
+
+    //here are the kernels that apply the map to the FFT data.  These can be used on their own, too.
+    static void remapMagnitudes(float32_t *complex_2N_buffer, float32_t *orig_mag, const FreqCompMap_F32 *map);  //orig_mag is scratch, N_2 long
+    static void remapComplex(float32_t *complex_2N_buffer, float32_t *orig_complex, const FreqCompMap_F32 *map); //orig_complex is scratch, 2*N_2 long
+
+  protected:
+    //create some data members specific to our processing
+    float shift_scale_fac = 1.0; //how much to shift formants (frequency multiplier).  1.0 is no shift
+    float start_freq_Hz = 0.0f; //what (original) frequency to start the shifting?.
+    float shift_Hz = 0.0f;  //set to zero to shift all of the audio up or down
+    bool shiftOnlyTheMagnitude = true;
+    float32_t *scratch = NULL;   //scratch space for the original magnitudes (or original complex values).  2*N_2 long
+    FreqCompMap_F32 maps[2];          //the map in use plus a spare, for rebuilding while the audio is running (unused when shared)
+    const FreqCompMap_F32 * volatile map = &maps[0];
+    const FreqCompMap_F32 * const volatile *live_map = &map;  //where processAudioFD() finds the live map: our own, or the stereo object's
+    float getHzPerBin(void) { return getSampleRate_Hz() / ((float)max(1,getNFFT())); }
+    float roundToBin_Hz(const float freq_Hz) { return getHzPerBin() * (float)round(freq_Hz / getHzPerBin()); }
+    static float limitScaleFactor(const float scale_fac) { return max(0.00001f, scale_fac); } //limit the minimum scale factor
+    bool refuseIfMapShared(const char *method_name) {
+      if (!isMapShared()) return false;
+      Serial.print(F("AudioEffectFreqComp_FD_F32: ")); Serial.print(method_name);
+      Serial.println(F(": *** ERROR ***: this channel shares its map.  Set it via AudioEffectFreqCompStereo_FD_F32."));
+      return true;
+    }
+    friend class AudioEffectFreqCompStereo_FD_F32;
+};
+
+//Stereo frequency compression.  The left and right channels are each their own audio processing object
+//(connect to them as "left" and "right"), but they share one bin map, which is owned here.  Each setting
+//change builds the spare map once and then swaps it in for both channels at the same time.  While shared,
+//the channels' own map setters are refused, so that changing one ear cannot rebuild the other ear's map.
+class AudioEffectFreqCompStereo_FD_F32 {
+  public:
+    AudioEffectFreqCompStereo_FD_F32(const AudioSettings_F32 &settings) : left(settings), right(settings) {
+      left.live_map = &map;  right.live_map = &map;
+    }
+
+    int setup(const AudioSettings_F32 &settings, const int target_N_FFT);
+
+    //set both channels
+    float setStartFreq_Hz(float freq_Hz) {
+      left.start_freq_Hz = right.start_freq_Hz = left.roundToBin_Hz(max(0.0f, freq_Hz));
+      rebuildMap();
+      return left.start_freq_Hz;
+    }
+    float getStartFreq_Hz(void) const { return left.getStartFreq_Hz(); }
+    float setFreqCompRatio(const float val) {
+      left.shift_scale_fac = right.shift_scale_fac = AudioEffectFreqComp_FD_F32::limitScaleFactor(1.0f / val);
+      rebuildMap();
+      return left.getFreqCompRatio();
+    }
+    float getFreqCompRatio(void) const { return left.getFreqCompRatio(); }
+    float setShift_Hz(const float freq_Hz) {
+      left.shift_Hz = right.shift_Hz = left.roundToBin_Hz(freq_Hz);
+      rebuildMap();
+      return left.shift_Hz;
+    }
+    float getShift_Hz(void) const { return left.getShift_Hz(); }
+    bool setShiftOnlyTheMagnitude(const bool val) { right.setShiftOnlyTheMagnitude(val); return left.setShiftOnlyTheMagnitude(val); }
+    bool getShiftOnlyTheMagnitude(void) const { return left.getShiftOnlyTheMagnitude(); }
+
+    //the shared map that is in use
+    const FreqCompMap_F32* getMap(void) const { return map; }
+
+    //build the shared map for the current settings in the spare map, and then swap it in for both channels
+    void rebuildMap(void);
+
+    AudioEffectFreqComp_FD_F32 left, right;
+
+  protected:
+    FreqCompMap_F32 maps[2];          //the shared map in use plus a spare
+    const FreqCompMap_F32 * volatile map = &maps[0];
+};
+
+#endif
@@ -9,25 +9,8 @@ int AudioEffectFreqShift_FD_F32::setup(const AudioSettings_F32 &settings, const
 	//print_ptr->println("AudioEffectFreqShift_FD_F32: setup: return from AudioFreqDomainBase_FD_F32::setup = " + String(ret_val));
 	if (ret_val < 0) return ret_val; //it failed, so simply return now
 	
-	//decide how much overlap is happening
-	switch (myIFFT.getNBuffBlocks()) {
-	  case 0:
-		//should never happen
-		break;
-	  case 1:
-		overlap_amount = NONE;
-		break;
-	  case 2:
-		overlap_amount = HALF;
-		break;
-	  case 3:
-		//to do...need to add phase shifting logic to the update() function to support this case
-		break;
-	  case 4:
-		overlap_amount = THREE_QUARTERS;
-		//to do...need to add phase shifting logic to the update() function to support this case
-		break;
-	}
+	//decide how much overlap is happening.  Any overlap factor (N_FFT / audio_block_samples) is supported
+	setOverlapFactor(myIFFT.getNBuffBlocks());
 		
 	return ret_val;
 }
@@ -114,58 +97,51 @@ void rotate_270deg(float32_t *complex_2N_buffer, const int N_2) {
 		complex_2N_buffer[2*i] = foo;  //put the imaginary into the real
 	}
 }
+void rotate_general(float32_t *complex_2N_buffer, const int N_2, const float32_t c, const float32_t s) {
+	//general rotation: multiply every bin by the complex value (c + j*s), which has a magnitude of one
+	for (int i=0; i < N_2; i++) {
+		const float32_t re = complex_2N_buffer[2*i], im = complex_2N_buffer[2*i+1];
+		complex_2N_buffer[2*i]   = re*c - im*s;
+		complex_2N_buffer[2*i+1] = re*s + im*c;
+	}
+}
+
+void AudioEffectFreqShift_FD_F32::setOverlapFactor(const int n_buff_blocks) {
+	overlap_factor = max(1, min(MAX_N_BUFF_BLOCKS, n_buff_blocks));
+	overlap_block_counter = 0;
+	
+	//the historical names for the overlap
+	if (overlap_factor == 2) { overlap_amount = HALF; } else if (overlap_factor == 4) { overlap_amount = THREE_QUARTERS; } else { overlap_amount = NONE; }
+	
+	//precompute the rotation table: the phase steps in increments of 1/overlap_factor of a full circle
+	for (int q=0; q < overlap_factor; q++) {
+		float32_t phase_rad = 2.0f*(float32_t)M_PI*((float32_t)q)/((float32_t)overlap_factor);
+		rot_table_cos[q] = cosf(phase_rad);  rot_table_sin[q] = sinf(phase_rad);
+	}
+}
+
 void AudioEffectFreqShift_FD_F32::adjustBinPhases(float32_t *complex_2N_buffer, const int N_FFT) {
 	const int N_2 = N_FFT / 2 + 1;
-	switch (overlap_amount) {
-		case NONE:
-			//no phase change needed
-			break;
-			
-		case HALF:
-			//we only need to adjust the phase if we're shifting by an odd number of bins
-			if ((abs(shift_bins) % 2) == 1) {
-				//Alternate between adding no phase shift and adding 180 deg phase shift.
-				overlap_block_counter++; 
-				if (overlap_block_counter == 2) {
-					overlap_block_counter = 0;
-					rotate_180deg(complex_2N_buffer, N_2);
-				}
-			}
-			break;
-			
-		case THREE_QUARTERS:
-			//The cycle of phase shifting is every 4 blocks insead of every two blocks.
-			//Phase_shift = Phase_orig - Phase_new
-			//  phase_orig = (360/4) * F_orig * block_counter;  //F_orig = 0 -> Nfft/2+1
-			//  phase_new  = (360/4) * F_new * block_counter;
-			//  So, phase_shift = (360/4) * (F_new - F_orig) * block_counter;  //wrap this zero to 360 
-			//  Or, rewritten: phase_shift_deg = (360/4) * -shift_bins * block_counter //wrap this zero to 360
-			//  Or, rewritten again: phase_shift_quarters = wrap(-shift_bins * block_counter, 4); //wrapped to always be [0, 1, 2, 3]
-			overlap_block_counter++; if (overlap_block_counter >= 4) overlap_block_counter = 0; //will be [0, 1, 2, 3]
-			int phase_shift_quarters = shift_bins * overlap_block_counter;
-			while (phase_shift_quarters < 0) phase_shift_quarters += 4;  //wrap to get to zero or above
-			while (phase_shift_quarters >= 4) phase_shift_quarters -= 4; //wrap get to less than 4
-			
-			switch (phase_shift_quarters) {
-				case 0:
-					//no rotation
-					break;
-				case 1:
-					//90 deg rotation (swap real and imaginary and flip the sign when moving the imaginary to the real)
-					rotate_90deg(complex_2N_buffer, N_2);
-					break;
-				case 2:
-					//180 deg...flip the sign of both real and imaginary
-					rotate_180deg(complex_2N_buffer, N_2);
-					break;
-				case 3:
-					//270 deg rotation (swap the real and imaginary and flip the sign when moving the real to the imaginary)
-					rotate_270deg(complex_2N_buffer, N_2);
-					break;	
-			}
-			break;
-		
+	
+	//Each FFT starts one hop (N_FFT/overlap_factor samples) later than the previous one.  So, the phase
+	//of the content in any bin advances by (360/overlap_factor)*bin each FFT.  When we move content by
+	//shift_bins, we need to recreate the phase advance of its new bin:
+	//  Phase_shift = Phase_new - Phase_orig = (360/overlap_factor) * shift_bins * block_counter //wrap this zero to 360
+	//  Or, in table steps: q = wrap(shift_bins * block_counter, overlap_factor)
+	if (overlap_factor <= 1) return;  //no overlap, so no phase change needed
+	overlap_block_counter++; if (overlap_block_counter >= overlap_factor) overlap_block_counter = 0; //will be [0, overlap_factor-1]
+	int q = (shift_bins * overlap_block_counter) % overlap_factor;
+	if (q < 0) q += overlap_factor;  //wrap get to zero or above
+	if (q == 0) return;  //no rotation
+
+	//the quarter turns can be done by swapping and sign flipping, which is cheaper than the general rotation
+	const int quarter = overlap_factor / 4;
+	if ((overlap_factor % 4) == 0) {
+		if (q == quarter)   { rotate_90deg(complex_2N_buffer, N_2);  return; }
+		if (q == 3*quarter) { rotate_270deg(complex_2N_buffer, N_2); return; }
 	}
+	if ((2*q) == overlap_factor) { rotate_180deg(complex_2N_buffer, N_2); return; }
+	rotate_general(complex_2N_buffer, N_2, rot_table_cos[q], rot_table_sin[q]);
 }
 
 
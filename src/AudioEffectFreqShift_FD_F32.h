@@ -74,12 +74,16 @@ class AudioEffectFreqShift_FD_F32 : public AudioFreqDomainBase_FD_F32
     int getShift_bins(void) const                { return shift_bins; }
 		float getShift_Hz(void) const                { return getFrequencyOfBin(shift_bins);	}
 		float getFrequencyOfBin(const int bin) const { return sample_rate_input_Hz * ((float)bin) / ((float) N_FFT); } //"bin" should be zero to (N_FFT-1)
+		int getOverlapFactor(void) const             { return overlap_factor; }  //N_FFT / audio_block_samples
 		
    
   protected:
-		enum OVERLAP_OPTIONS {NONE, HALF, THREE_QUARTERS};  //evenutally extend to other overlap factors
+		enum OVERLAP_OPTIONS {NONE, HALF, THREE_QUARTERS};  //historical.  Any overlap is now handled via overlap_factor
 		int overlap_amount = NONE;
+		int overlap_factor = 1;        //N_FFT / audio_block_samples
 		int overlap_block_counter = 0;
+		float32_t rot_table_cos[MAX_N_BUFF_BLOCKS], rot_table_sin[MAX_N_BUFF_BLOCKS];  //phase rotations in steps of 1/overlap_factor of a circle
+		virtual void setOverlapFactor(const int n_buff_blocks);  //also computes the rotation table
 		
     int shift_bins = 0; //how much to shift the frequency
 
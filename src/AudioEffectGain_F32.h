@@ -32,7 +32,8 @@ class AudioEffectGain_F32 : public AudioStream_F32
 			block = AudioStream_F32::receiveReadOnly_f32();
 			if (block == NULL) return;
 
-			if (is_bypassed) {
+			//if bypassed, or if the input is silent (so that the output would be silent, too), pass the input along
+			if (is_bypassed || block->is_silent) {
 				AudioStream_F32::transmit(block); // send the IIR output
 				AudioStream_F32::release(block);
 				return;
@@ -60,6 +61,7 @@ class AudioEffectGain_F32 : public AudioStream_F32
 			
 			out_block->id = block->id;
 			out_block->length = block->length;
+			out_block->is_silent = block->is_silent || (gain == 0.0f);
 
 			return 0;
 		}
@@ -19,6 +19,31 @@ float AudioEffectMultiBandWDRC_Base_F32_UI::setSampleRate_Hz(float rate_Hz) {
 	return sample_rate_Hz;
 }
 
+bool AudioEffectMultiBandWDRC_Base_F32_UI::allocateScratch(int n_samples) {
+	if (n_samples <= scratch_len) return true;  //the current blocks are already big enough
+	
+	//build the new blocks before touching the ones that update() might be using
+	audio_block_f32_t *new_band[N_GROUP], *new_env[N_GROUP];
+	AudioSettings_F32 settings(sample_rate_Hz, n_samples);
+	for (int i=0; i < N_GROUP; i++) {
+		new_band[i] = new audio_block_f32_t(settings);
+		new_env[i] = new audio_block_f32_t(settings);
+	}
+	
+	//swap them in
+	audio_block_f32_t *old_band[N_GROUP], *old_env[N_GROUP];
+	__disable_irq();
+	for (int i=0; i < N_GROUP; i++) {
+		old_band[i] = scratch_band[i];  scratch_band[i] = new_band[i];
+		old_env[i] = scratch_env[i];    scratch_env[i] = new_env[i];
+	}
+	scratch_len = new_band[0]->full_length;
+	__enable_irq();
+	
+	for (int i=0; i < N_GROUP; i++) { delete old_band[i]; delete old_env[i]; }
+	return true;
+}
+
 void AudioEffectMultiBandWDRC_Base_F32_UI::update(void) {
      
   //get the input audio
@@ -50,60 +75,65 @@ int AudioEffectMultiBandWDRC_Base_F32_UI::processAudioBlock(audio_block_f32_t *b
   //return if not enabled
   if (!is_enabled) return -1;
 
-  //get a temporary working block for audio
-  audio_block_f32_t * block_tmp = AudioStream_F32::allocate_f32();
-  if (block_tmp == NULL) return ret_val;  //there was no memory available 
+  //use our working blocks to filter several bands and then compute their envelopes together (in lockstep)
+  if (block_in->length > scratch_len) return -1;  //our working blocks are too short
+  audio_block_f32_t **band_blocks = scratch_band, **env_blocks = scratch_env;
 
   //  /////////////////////////////////////////  loop over all the channels to do the per-band processing
   bool were_any_blocks_processed = false;
   AudioFilterbankBase_F32 *fb = getFilterbank();
   int n_filters = fb->get_n_filters();
   bool firstChannelProcessed = true;
-  for (int Ichan = 0; Ichan < n_filters; Ichan++) {
-	AudioFilterBase_F32 *filter = fb->getFilter(Ichan);
+  int Ichan = 0;
+  while (Ichan < n_filters) {
+	
+	//apply the filters for the next group of (enabled) bands
+	AudioCalcEnvelope_F32 *envs[N_GROUP];
+	float *x[N_GROUP], *env[N_GROUP];
+	int Ichans[N_GROUP], n_ready = 0;
+	for ( ; (Ichan < n_filters) && (n_ready < N_GROUP); Ichan++) {
+	  AudioFilterBase_F32 *filter = fb->getFilter(Ichan);
+	  if (filter->get_is_enabled()) {
+		int any_error = filter->processAudioBlock(block_in,band_blocks[n_ready]);
+		if (!any_error) {
+		  Ichans[n_ready] = Ichan;
+		  envs[n_ready] = &(compbank.compressors[Ichan].calcEnvelope);
+		  x[n_ready] = band_blocks[n_ready]->data;  env[n_ready] = env_blocks[n_ready]->data;
+		  n_ready++;
+		} else { // if(!any_error) for filterbank
+		  //Serial.println(F("AudioEffectMultiBandWDRC_F32_UI: update: error in filterbank chan  ") + String(Ichan));
+		}
+	  } else {  //if filter is enabled
+		//Serial.print(F("AudioEffectMultiBandWDRC_F32_UI: update: filter is not enabled: Ichan = ")); Serial.println(Ichan);
+	  }
+	}
+	if (n_ready == 0) continue;
 	
-	if (filter->get_is_enabled()) {
-	  //apply the filter
-	  int any_error = filter->processAudioBlock(block_in,block_tmp);
+	//compute the envelopes of this group of bands together
+	AudioCalcEnvelope_F32::smooth_env_multi(envs, x, env, n_ready, block_in->length);
+	
+	//apply the compressors and mix the processed signals with the other bands that have been processed
+	for (int i=0; i < n_ready; i++) {
+	  compbank.compressors[Ichans[i]].compress_givenEnvelope(x[i], env[i], x[i], block_in->length);
+	  were_any_blocks_processed = true;  //if any one channel processes OK, this whole method will return OK
 	  
-	  if (!any_error) {
-		//apply the compressor
-		any_error = compbank.compressors[Ichan].processAudioBlock(block_tmp,block_tmp);
-		
-		if (!any_error) {              
-		  //success!
-		  were_any_blocks_processed = true;  //if any one channel processes OK, this whole method will return OK
-
-		  //now we mix the processed signal with the other bands that have been processed
-		  if (firstChannelProcessed) {   
-						 
-			// First channel. Just copy it into the output
-			for (int i=0; i < block_in->length; i++) block_out->data[i] = block_tmp->data[i];
-			block_out->id = block_in->id;   block_out->length = block_in->length;
-			firstChannelProcessed=false; //next time, we can't use this branch of code and we'll use the branch below
-			
-		  } else {  
-						  
-			// Later channels.  Must sum this channel with the previous channels
-			arm_add_f32(block_out->data, block_tmp->data, block_out->data, block_out->length);  
+	  if (firstChannelProcessed) {   
+					 
+		// First channel. Just copy it into the output
+		for (int k=0; k < block_in->length; k++) block_out->data[k] = x[i][k];
+		block_out->id = block_in->id;   block_out->length = block_in->length;
+		firstChannelProcessed=false; //next time, we can't use this branch of code and we'll use the branch below
 		
-		  }
-		} else { // if(!any_error) for compbank
-		  //Serial.println(F("AudioEffectMultiBandWDRC_F32_UI: update: error in compbank chan ") + String(Ichan));
-		} 
-	  } else { // if(!any_error) for filterbank
-		//Serial.println(F("AudioEffectMultiBandWDRC_F32_UI: update: error in filterbank chan  ") + String(Ichan));
+	  } else {  
+					  
+		// Later channels.  Must sum this channel with the previous channels
+		arm_add_f32(block_out->data, x[i], block_out->data, block_out->length);  
+	
 	  }
-	} else {  //if filter is enabled
-	  //Serial.print(F("AudioEffectMultiBandWDRC_F32_UI: update: filter is not enabled: Ichan = ")); Serial.println(Ichan);
 	}
-	
   } //close the loop over channels
 	
 
-  //release the temporary memory block
-  AudioStream_F32::release(block_tmp);
-
   //  ////////////////////////////////////////////////////  now do broadband processing
   if (were_any_blocks_processed) {
 	
@@ -124,6 +154,80 @@ int AudioEffectMultiBandWDRC_Base_F32_UI::processAudioBlock(audio_block_f32_t *b
 
 
 
+int AudioEffectMultiBandWDRC_Base_F32_UI::processAudioBlock_linked(AudioEffectMultiBandWDRC_Base_F32_UI *other, audio_block_f32_t *block_in, audio_block_f32_t *block_in_other,
+        audio_block_f32_t *block_out, audio_block_f32_t *block_out_other, int link_type, float weight) {
+  //check validity of inputs
+  int ret_val = -1;
+  if ((other == NULL) || (block_in == NULL) || (block_in_other == NULL) || (block_out == NULL) || (block_out_other == NULL)) return ret_val;  //-1 is error
+
+  //return if not enabled
+  if ((!is_enabled) || (!(other->is_enabled))) return -1;
+
+  //use two of our working blocks (one for each ear)
+  if ((block_in->length > scratch_len) || (block_in_other->length > scratch_len)) return ret_val;  //our working blocks are too short
+  audio_block_f32_t * block_tmp = scratch_band[0];
+  audio_block_f32_t * block_tmp_other = scratch_band[1];
+
+  //  /////////////////////////////////////////  loop over all the channels to do the per-band processing
+  bool were_any_blocks_processed = false;
+  AudioFilterbankBase_F32 *fb = getFilterbank(), *fb_other = other->getFilterbank();
+  int n_filters = min(fb->get_n_filters(), fb_other->get_n_filters());
+  bool firstChannelProcessed = true;
+  for (int Ichan = 0; Ichan < n_filters; Ichan++) {
+    AudioFilterBase_F32 *filter = fb->getFilter(Ichan), *filter_other = fb_other->getFilter(Ichan);
+    if ((filter->get_is_enabled()) && (filter_other->get_is_enabled())) {
+      
+      //apply the filters
+      int any_error = filter->processAudioBlock(block_in,block_tmp);
+      if (!any_error) any_error = filter_other->processAudioBlock(block_in_other,block_tmp_other);
+      
+      //apply the compressors, driving each ear's own gain curve from the combined envelope.  If that fails,
+      //this band is still uncompressed, so give up on the whole block rather than send it out.
+      if (!any_error) {
+        if (compbank.compressors[Ichan].processAudioBlock_linked(&(other->compbank.compressors[Ichan]), 
+            block_tmp, block_tmp_other, block_tmp, block_tmp_other, link_type, weight) != 0) return -1;
+      }
+      
+      if (!any_error) {
+        //success!
+        were_any_blocks_processed = true;  //if any one channel processes OK, this whole method will return OK
+
+        //now we mix the processed signal with the other bands that have been processed
+        if (firstChannelProcessed) {
+          // First channel. Just copy it into the output
+          for (int i=0; i < block_in->length; i++) block_out->data[i] = block_tmp->data[i];
+          for (int i=0; i < block_in_other->length; i++) block_out_other->data[i] = block_tmp_other->data[i];
+          block_out->id = block_in->id;   block_out->length = block_in->length;
+          block_out_other->id = block_in_other->id;   block_out_other->length = block_in_other->length;
+          firstChannelProcessed=false; //next time, we can't use this branch of code and we'll use the branch below
+        } else {
+          // Later channels.  Must sum this channel with the previous channels
+          arm_add_f32(block_out->data, block_tmp->data, block_out->data, block_out->length);  
+          arm_add_f32(block_out_other->data, block_tmp_other->data, block_out_other->data, block_out_other->length);  
+        }
+      }
+    }
+  } //close the loop over channels
+
+  //  ////////////////////////////////////////////////////  now do broadband processing
+  if (were_any_blocks_processed) {
+    //apply some broadband gain (could probably be included in the compressor below
+    broadbandGain.processAudioBlock(block_out, block_out);
+    other->broadbandGain.processAudioBlock(block_out_other, block_out_other);
+
+    //apply final broadband compression, again linked across the two ears
+    int any_error = compBroadband.processAudioBlock_linked(&(other->compBroadband), block_out, block_out_other, block_out, block_out_other, link_type, weight);
+
+    //if it got this far without an error, it means that the data processed OK!!
+    if (!any_error) ret_val = 0;
+  }
+
+  //return
+  return ret_val;
+  
+} // close processAudioBlock_linked()
+
+
 void AudioEffectMultiBandWDRC_Base_F32_UI::getDSL(BTNRH_WDRC::CHA_DSL *new_dsl) {
 	//get settings from the filterbank
 	int n_filters = getFilterbank()->get_n_filters();
@@ -169,6 +273,46 @@ void AudioEffectMultiBandWDRC_IIR_F32_UI::setupFromBTNRH(BTNRH_WDRC::CHA_DSL &th
   compBroadband.configureFromGHA(sample_rate_Hz, this_bb);
 }
 
+// //////////////////////////////////////////////////////////////////////////////////////
+//
+// Here are the methods for binaural (stereo-linked) operation
+//
+// ///////////////////////////////////////////////////////////////////////////////////////
+
+void AudioEffectMultiBandWDRC_StereoLinked_F32::update(void) {
+  //get the input audio
+  audio_block_f32_t *block_in_L = AudioStream_F32::receiveReadOnly_f32(0);
+  audio_block_f32_t *block_in_R = AudioStream_F32::receiveReadOnly_f32(1);
+  if ((block_in_L == NULL) || (block_in_R == NULL) || (leftWDRC == NULL) || (rightWDRC == NULL)) {
+    AudioStream_F32::release(block_in_L); AudioStream_F32::release(block_in_R);
+    return;
+  }
+
+  //get the output audio
+  audio_block_f32_t *block_out_L = AudioStream_F32::allocate_f32();
+  audio_block_f32_t *block_out_R = AudioStream_F32::allocate_f32();
+  if ((block_out_L == NULL) || (block_out_R == NULL)) {  //there was no memory available
+    AudioStream_F32::release(block_out_L); AudioStream_F32::release(block_out_R); 
+    AudioStream_F32::release(block_in_L); AudioStream_F32::release(block_in_R);
+    return;
+  }
+
+  // process audio
+  if (link_type == LINK_NONE) {
+    //process each ear independently
+    if (!(leftWDRC->processAudioBlock(block_in_L, block_out_L))) AudioStream_F32::transmit(block_out_L, 0);
+    if (!(rightWDRC->processAudioBlock(block_in_R, block_out_R))) AudioStream_F32::transmit(block_out_R, 1);
+  } else {
+    //process both ears together, with linked envelopes
+    int any_error = leftWDRC->processAudioBlock_linked(rightWDRC, block_in_L, block_in_R, block_out_L, block_out_R, link_type, link_weight);
+    if (!any_error) { AudioStream_F32::transmit(block_out_L, 0); AudioStream_F32::transmit(block_out_R, 1); }
+  }
+
+  //release the memory blocks
+  AudioStream_F32::release(block_out_L); AudioStream_F32::release(block_out_R);
+  AudioStream_F32::release(block_in_L);  AudioStream_F32::release(block_in_R);
+}
+
 // //////////////////////////////////////////////////////////////////////////////////////
 //
 // Here are the TympanRemote App GUI related pages FOR STEREO OPERATION
@@ -40,12 +40,18 @@
 
 class AudioEffectMultiBandWDRC_Base_F32_UI : public AudioStream_F32, public SerialManager_UI {
   public:
-    AudioEffectMultiBandWDRC_Base_F32_UI(void): AudioStream_F32(1,inputQueueArray), SerialManager_UI() { setup(); } 
+    AudioEffectMultiBandWDRC_Base_F32_UI(void): AudioStream_F32(1,inputQueueArray), SerialManager_UI() { 
+		setup(); 
+		allocateScratch(audio_block_samples);
+	} 
     AudioEffectMultiBandWDRC_Base_F32_UI(const AudioSettings_F32 &settings) : AudioStream_F32(1,inputQueueArray), SerialManager_UI() { 
 		setup(); 
 		setSampleRate_Hz(settings.sample_rate_Hz);
 		setAudioBlockSize(settings.audio_block_samples);
 	}
+	virtual ~AudioEffectMultiBandWDRC_Base_F32_UI(void) { 
+		for (int i=0; i < N_GROUP; i++) { delete scratch_band[i]; delete scratch_env[i]; }
+	}
 
     // setup
     virtual void setup(void) {
@@ -58,6 +64,10 @@ class AudioEffectMultiBandWDRC_Base_F32_UI : public AudioStream_F32, public Seri
 
     virtual int processAudioBlock(audio_block_f32_t *block_in, audio_block_f32_t *block_out);
 
+    //binaural (stereo-linked) processing of this instance along with the instance for the other ear.  See AudioEffectMultiBandWDRC_StereoLinked_F32
+    virtual int processAudioBlock_linked(AudioEffectMultiBandWDRC_Base_F32_UI *other, audio_block_f32_t *block_in, audio_block_f32_t *block_in_other,
+        audio_block_f32_t *block_out, audio_block_f32_t *block_out_other, int link_type, float weight);
+
     // here are the methods required (or encouraged) for SerialManager_UI classes
     virtual void printHelp(void) {};
     //virtual bool processCharacter(char c); //not used here
@@ -71,7 +81,11 @@ class AudioEffectMultiBandWDRC_Base_F32_UI : public AudioStream_F32, public Seri
 	virtual void getWDRC(BTNRH_WDRC::CHA_WDRC *new_bb);
 
 	virtual float setSampleRate_Hz(float rate_Hz);
-	virtual int setAudioBlockSize(int samps) { return audio_block_samples = samps; } //only the filterbank cares and we'll set it when we redesign the filters
+	virtual int setAudioBlockSize(int samps) { //the filterbank also cares, but we'll set it when we redesign the filters
+		audio_block_samples = samps; 
+		allocateScratch(audio_block_samples);  //the working blocks for the per-band processing
+		return audio_block_samples;
+	}
 
 	virtual int get_n_chan(void) { return compbank.get_n_chan(); }
 
@@ -90,6 +104,14 @@ class AudioEffectMultiBandWDRC_Base_F32_UI : public AudioStream_F32, public Seri
     bool is_enabled = false;
 	float sample_rate_Hz = AUDIO_SAMPLE_RATE;
 	int audio_block_samples = AUDIO_BLOCK_SAMPLES;
+	
+	//working blocks for the per-band processing.  These are owned by this instance (rather than being taken
+	//from the audio memory pool on every update) so that a big filterbank does not eat up the pool.  There are
+	//enough to filter N_GROUP bands and compute their envelopes together (in lockstep).
+	static const int N_GROUP = AudioCalcEnvelope_F32::N_LOCKSTEP;
+	audio_block_f32_t *scratch_band[N_GROUP] = {}, *scratch_env[N_GROUP] = {};
+	int scratch_len = 0;  //length (samples) of each working block
+	bool allocateScratch(int n_samples);
   
 };
 
@@ -160,4 +182,52 @@ class StereoContainerWDRC_UI : public StereoContainer_UI {
   
 };
 
+// /////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Binaural (stereo-linked) operation of a left/right pair of MultiBandWDRC instances
+//
+// Normally, the left and right instances of AudioEffectMultiBandWDRC are independent audio nodes.  Each
+// one computes its envelopes and its gains on its own.  With this class, the left and right instances
+// are instead processed together: for each band, the left and right envelopes are combined (max, mean,
+// or weighted) and the combined envelope is fed through each ear's own gain curve.  So, both ears respond
+// to the same level, which preserves the interaural level cues.
+//
+// Usage: create your left and right AudioEffectMultiBandWDRC instances as usual (and, if you'd like,
+// hand them to StereoContainerWDRC_UI for the App GUI).  But, instead of connecting your audio to the
+// left and right instances directly, connect the audio to this class (input/output 0 is left, 1 is right).
+// Each instance keeps its own filterbank, envelope states, and compression parameters (knees, ratios,
+// linear gain, and bolt/limiter), so each ear can still be fit on its own.
+//
+// /////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AudioEffectMultiBandWDRC_StereoLinked_F32 : public AudioStream_F32 {
+//GUI: inputs:2, outputs:2  //this line used for automatic generation of GUI node  
+//GUI: shortName:MultiBandWDRC_Linked
+  public:
+    AudioEffectMultiBandWDRC_StereoLinked_F32(void): AudioStream_F32(2,inputQueueArray) { setInstanceName(); }
+    AudioEffectMultiBandWDRC_StereoLinked_F32(const AudioSettings_F32 &settings): AudioStream_F32(2,inputQueueArray) { setInstanceName(); }
+    AudioEffectMultiBandWDRC_StereoLinked_F32(AudioEffectMultiBandWDRC_Base_F32_UI *_left, AudioEffectMultiBandWDRC_Base_F32_UI *_right) : AudioStream_F32(2,inputQueueArray) { 
+      setInstanceName(); 
+      setPairMultiBandWDRC(_left, _right);
+    }
+    
+    void setInstanceName(void) { instanceName = "MultiBandWDRC_StereoLinked"; }
+    
+    virtual void setPairMultiBandWDRC(AudioEffectMultiBandWDRC_Base_F32_UI *_left, AudioEffectMultiBandWDRC_Base_F32_UI *_right) { leftWDRC = _left; rightWDRC = _right; }
+    virtual void update(void);
+    
+    //choose how the envelopes of the two ears are combined.  If not linked, the two ears are processed independently
+    enum LINK_TYPE { LINK_NONE=-1, LINK_MAX=AudioEffectCompWDRC_F32::LINK_MAX, LINK_MEAN=AudioEffectCompWDRC_F32::LINK_MEAN, LINK_WEIGHTED=AudioEffectCompWDRC_F32::LINK_WEIGHTED };
+    virtual int setLinkType(int val) { return link_type = val; }
+    virtual int getLinkType(void) { return link_type; }
+    virtual float setLinkWeight(float val) { return link_weight = max(0.0f, min(1.0f, val)); }  //weight for the left ear (used only for LINK_WEIGHTED).  The right gets 1.0-weight.
+    virtual float getLinkWeight(void) { return link_weight; }
+    
+  protected:
+    audio_block_f32_t *inputQueueArray[2];  //required as part of AudioStream_F32.  Two inputs.
+    AudioEffectMultiBandWDRC_Base_F32_UI  *leftWDRC=NULL, *rightWDRC=NULL;
+    int link_type = LINK_MAX;
+    float link_weight = 0.5f;
+};
+
 #endif
@@ -7,33 +7,56 @@
 int AudioEffectNoiseReduction_FD_F32::setup(const AudioSettings_F32 &settings, const int target_N_FFT) {
   int actual_N_FFT = AudioFreqDomainBase_FD_F32::setup(settings, target_N_FFT);
   ave_spectrum_N = actual_N_FFT / 2 + 1;  // zero bin through Nyquist bin
+  freeBuffers();  //in case setup() is being called a second time
   ave_spectrum = new float32_t[ave_spectrum_N];
   gains = new float32_t[ave_spectrum_N];
   prev_gains = new float32_t[ave_spectrum_N];
+  raw_pow = new float32_t[ave_spectrum_N];
+  gains_cumsum = new float32_t[ave_spectrum_N+1];
+  bin_band_lo = new uint8_t[ave_spectrum_N];
+  bin_weight_hi = new float32_t[ave_spectrum_N];
+  bin_band_lo_next = new uint8_t[ave_spectrum_N];
+  bin_weight_hi_next = new float32_t[ave_spectrum_N];
+  computeBands();
   resetAveSpectrumAndGains();
   setAttack_sec(attack_sec);   //computes the underlying attack filter coefficient
   setRelease_sec(release_sec); //computes the underlying release filter coefficient
   setGainSmoothing_sec(smooth_sec); //computes the underlying smoothing filter coefficient
+  setMinStatsSmoothing_sec(min_stats_smooth_sec); //computes the underlying smoothing filter coefficient
+  setMinStatsWindow_sec(min_stats_window_sec);    //computes the sub-window length
+  int est = noise_est_type, rule = gain_rule;
+  noise_est_type = NOISE_EST_ATTACK_RELEASE;  gain_rule = GAIN_RULE_SNR_THRESH;
+  setNoiseEstimator(est);  setGainRule(rule);     //allocates their memory, if they were chosen (even if chosen before setup())
   return actual_N_FFT;
 }
 
-void AudioEffectNoiseReduction_FD_F32::updateAveSpectrum(float32_t *current_pow) {
+void AudioEffectNoiseReduction_FD_F32::updateAveSpectrum_N(float32_t *current_pow, float32_t *ave, const int N) {
+    if (noise_est_type == NOISE_EST_MIN_STATS) { updateAveSpectrum_minStats(current_pow, ave, N); return; }
+    
     float32_t att_1 = 0.99999f*(1.0f - attack_coeff), att = attack_coeff;
     float32_t rel_1 = 0.99999f*(1.0f - release_coeff), rel = release_coeff;
 
-    //loop over each bin to update the average for that bin
-    for (int ind=0; ind < ave_spectrum_N; ind++) {
-      if (current_pow[ind] > ave_spectrum[ind]) {
-        //noise is increasing.  use attack time
-        ave_spectrum[ind] = att_1 * ave_spectrum[ind] + att*current_pow[ind];
-      } else {
-        //noise is decreasing.  use release time
-        ave_spectrum[ind] = rel_1 * ave_spectrum[ind] + rel*current_pow[ind];
-      }
+    //loop over each bin to update the average for that bin.  If the noise is increasing, use the attack
+    //time.  If the noise is decreasing, use the release time.  Both are computed and then one is selected,
+    //which avoids branching.  Unrolled by four so that neighboring bins are calculated together.
+    int ind=0;
+    for ( ; ind <= N-4; ind += 4) {
+      float32_t p0 = current_pow[ind],   a0 = ave[ind],   p1 = current_pow[ind+1], a1 = ave[ind+1];
+      float32_t p2 = current_pow[ind+2], a2 = ave[ind+2], p3 = current_pow[ind+3], a3 = ave[ind+3];
+      ave[ind]   = (p0 > a0) ? (att_1*a0 + att*p0) : (rel_1*a0 + rel*p0);
+      ave[ind+1] = (p1 > a1) ? (att_1*a1 + att*p1) : (rel_1*a1 + rel*p1);
+      ave[ind+2] = (p2 > a2) ? (att_1*a2 + att*p2) : (rel_1*a2 + rel*p2);
+      ave[ind+3] = (p3 > a3) ? (att_1*a3 + att*p3) : (rel_1*a3 + rel*p3);
+    }
+    for ( ; ind < N; ind++) {
+      float32_t p = current_pow[ind], a = ave[ind];
+      ave[ind] = (p > a) ? (att_1*a + att*p) : (rel_1*a + rel*p);
     }
 }
 
-void AudioEffectNoiseReduction_FD_F32::calcGainsBasedOnSpectrum(float32_t *current_pow) {
+void AudioEffectNoiseReduction_FD_F32::calcGainsBasedOnSpectrum_N(float32_t *current_pow, float32_t *ave, float32_t *gains_out, const int N) {
+  if (gain_rule != GAIN_RULE_SNR_THRESH) { calcGains_decisionDirected(current_pow, ave, gains_out, N); return; }
+  
   //loop over each bin, evaluate where the current level is relative to the average, and compute the desired gain
   float32_t SNR;
   const float32_t SNR_at_endTransition = SNR_for_max_atten*transition_width;
@@ -41,71 +64,59 @@ void AudioEffectNoiseReduction_FD_F32::calcGainsBasedOnSpectrum(float32_t *curre
 
   //loop over each frequency bin (up to Nyquist)
   const float32_t coeff = (gain_at_endTransition - max_gain)/(SNR_at_endTransition - SNR_for_max_atten);
-  for (int ind=0; ind < ave_spectrum_N; ind++) {
-    SNR = current_pow[ind] / ave_spectrum[ind]; //compute signal to noise ratio (linear, not dB)
+  for (int ind=0; ind < N; ind++) {
+    SNR = current_pow[ind] / ave[ind]; //compute signal to noise ratio (linear, not dB)
 
     //calculate gain differently based on different SNR regimes
     if (SNR <= SNR_for_max_atten) { //note SNR=1.0 is an SNR of 0 dB
       //this is definitely noise.  max attenuation
-      gains[ind] = max_gain; //linear value, not dB
+      gains_out[ind] = max_gain; //linear value, not dB
       
     } else if (SNR >=  SNR_at_endTransition) {
       //this is definitely signal.  no attenuation
-      gains[ind] = gain_at_endTransition; //linear value, not dB
+      gains_out[ind] = gain_at_endTransition; //linear value, not dB
       
     } else {
       //we're in-between, so it's a transition region.  This transition is best done in dB space, but let's try it in linear space
-      gains[ind]= (SNR - SNR_for_max_atten) * coeff + max_gain ;
+      gains_out[ind]= (SNR - SNR_for_max_atten) * coeff + max_gain ;
     }
   }
 }
 
-//smooth gain values in frequency with simple first-order filter
+//smooth gain values in frequency by averaging each bin with its neighbors.  The number of neighbors
+//grows with frequency (so that the width is constant in octaves).  Rather than summing each window
+//directly (which costs N*width), we build a running sum of the gains once and then get each window's
+//sum from the difference of two entries of the running sum.  So, the cost is N regardless of width.
 void AudioEffectNoiseReduction_FD_F32::smoothGainsInFrequency(void) {
+  if (gains_cumsum == NULL) return;
   const float32_t scale_fac_div2 = freq_smooth_octaves * 0.5f;
-  int count=0, start_ind=0, end_ind=0;
-  int n_ave_half = 0;
+  if (scale_fac_div2 <= 0.0f) return;  //no smoothing requested
   
-  //initialize
-  float32_t orig_gains[ave_spectrum_N];
-  for (int ind = 0; ind < ave_spectrum_N; ind++) orig_gains[ind] = gains[ind];
+  //running sum:  gains_cumsum[i] is the sum of gains[0] through gains[i-1]
+  float32_t acc = 0.0f;
+  gains_cumsum[0] = acc;
+  for (int ind = 0; ind < ave_spectrum_N; ind++) { acc += gains[ind]; gains_cumsum[ind+1] = acc; }
 
   //loop over gains and smooth with neighbors
   for (int ind = 1; ind < ave_spectrum_N; ind++) {
-    float32_t foo_out = orig_gains[ind]; count = 1;
-
     //how much averaging?
-    n_ave_half = (int)(ind*scale_fac_div2 + 0.5f); //round
+    int n_ave_half = (int)(ind*scale_fac_div2 + 0.5f); //round
     if (n_ave_half > 0) {
-
-      //left half
-      start_ind = max(0,ind - n_ave_half);      end_ind = ind;
-      for(int i=start_ind; i<end_ind;i++) {
-        foo_out += orig_gains[i]; count++;
-      }
-
-      if (ind < (ave_spectrum_N-1)) { //don't average to the right if we're at the last frequency bin
-        //right half
-        start_ind = ind+1;  end_ind = min(ave_spectrum_N-1, ind + n_ave_half);
-        for(int i=start_ind; i<end_ind;i++) {
-          foo_out += orig_gains[i]; count++;
-        }
-      }
-
-      //complete the averaging
-      foo_out /= ((float)count);
+      //the window is [start_ind, end_ind).  It spans from n_ave_half to the left through n_ave_half-1 to
+      //the right (but never includes the last frequency bin unless it is the center bin)
+      int start_ind = max(0, ind - n_ave_half);
+      int end_ind = max(ind+1, min(ave_spectrum_N-1, ind + n_ave_half));
+      gains[ind] = (gains_cumsum[end_ind] - gains_cumsum[start_ind]) / ((float32_t)(end_ind - start_ind));
     }
-    
-    gains[ind] = foo_out;
   }
 }
 
 
 //smooth gain values in time with simple first-order filter
-void AudioEffectNoiseReduction_FD_F32::smoothGainsInTime(void) {
+void AudioEffectNoiseReduction_FD_F32::smoothGainsInTime_N(float32_t *gains_inout, float32_t *prev, const int N) {
   float32_t coeff_1 = 0.9999f*(1.0f-smooth_coeff);
-  for (int ind = 0; ind < ave_spectrum_N; ind++) {
-    gains[ind] = prev_gains[ind] = coeff_1 * prev_gains[ind] + smooth_coeff*gains[ind];
+  for (int ind = 0; ind < N; ind++) {
+    gains_inout[ind] = prev[ind] = coeff_1 * prev[ind] + smooth_coeff*gains_inout[ind];
   }
 }
 
@@ -124,24 +135,278 @@ void AudioEffectNoiseReduction_FD_F32::processAudioFD(float32_t *complex_2N_buff
   int N_2 = NFFT / 2 + 1;
   //float Hz_per_bin = sample_rate_Hz /((float)NFFT); //sample_rate_Hz is from the base class AudioFreqDomainBase_FD_F32
   
+  if (raw_pow == NULL) return;  //if the memory for the magnitude^2 has yet to be initialized, return early
+  
   //compute the magnitude^2 of each FFT bin (up to Nyquist)
-  float raw_pow[N_2]; //create memory to hold the magnitude^2 values
   arm_cmplx_mag_squared_f32(complex_2N_buffer, raw_pow, N_2);  //get the magnitude for each FFT bin and store somewhere safes
 
-  //loop over each bin and compute the long-term average, which we assume to be the "noise" background
-  if (enableNoiseEstimationUpdates) updateAveSpectrum(raw_pow); //updates ave_spectrum, which is one of the data members of this class
- 
-  //calcluate the new gain values based on the current magnitude versus the ave magnitude
-  calcGainsBasedOnSpectrum(raw_pow);
-
-  //smooth the gains in frequency and in time (to reducting the "bubbling water" artifacts)
-  smoothGainsInFrequency();
-  smoothGainsInTime();
-
-  //Loop over each bin and apply the gain
-  for (int ind = 0; ind < ave_spectrum_N; ind++) { //only process up to Nyquist...the class will automatically rebuild the frequencies above Nyquist
-    //attenuate both the real and imaginary comoponents
-    complex_2N_buffer[2 * ind]     *= gains[ind]; //real
-    complex_2N_buffer[2 * ind + 1] *= gains[ind]; //imaginary
-  }  
+  //update the noise estimate?  Not if the VAD thinks that there is speech
+  const bool update_noise = enableNoiseEstimationUpdates && ((vad == NULL) || (vad->getSpeechProb() <= vad_freeze_prob));
+
+  if (use_band_mode) {
+    //pool the bins into bands and do the noise estimation and gain calculation on the bands
+    poolBinsIntoBands(raw_pow, band_pow);
+    if (update_noise) updateAveSpectrum_N(band_pow, band_ave, n_bands);
+    calcGainsBasedOnSpectrum_N(band_pow, band_ave, band_gains, n_bands);
+    smoothGainsInTime_N(band_gains, band_prev_gains, n_bands); //no need to smooth in frequency...the bands are already smooth
+
+    //expand the band gains back out to the FFT bins
+    expandBandGainsToBins(band_gains, gains);
+  } else {
+    //loop over each bin and compute the long-term average, which we assume to be the "noise" background
+    if (update_noise) updateAveSpectrum(raw_pow); //updates ave_spectrum, which is one of the data members of this class
+   
+    //calcluate the new gain values based on the current magnitude versus the ave magnitude
+    calcGainsBasedOnSpectrum(raw_pow);
+
+    //smooth the gains in frequency and in time (to reducting the "bubbling water" artifacts)
+    smoothGainsInFrequency();
+    smoothGainsInTime();
+  }
+
+  //Apply the gain to each bin (both the real and imaginary components).  Only process up to Nyquist...the
+  //class will automatically rebuild the frequencies above Nyquist
+  arm_cmplx_mult_real_f32(complex_2N_buffer, gains, complex_2N_buffer, ave_spectrum_N);
+}
+
+
+// ///////////////////////////////////////////////////////////////// Band mode
+
+bool AudioEffectNoiseReduction_FD_F32::setBandMode(const bool enable, const int _target_n_bands) {
+  target_n_bands = max(2, min(MAX_N_BANDS, _target_n_bands));
+  const bool was_band_mode = use_band_mode;
+  const int prev_n_bands = n_bands;
+  if (bin_band_lo != NULL) computeBands();  //if setup() hasn't been called yet, it'll call computeBands() itself
+  if (enable && !use_band_mode) {
+    //start the band states from where the per-bin states are
+    if (ave_spectrum != NULL) poolBinsIntoBands(ave_spectrum, band_ave);
+    for (int Iband=0; Iband < n_bands; Iband++) band_prev_gains[Iband] = 1.0f;
+  }
+  const bool new_band_mode = (enable && (n_bands > 1));
+
+  //The min-statistics and decision-directed states are shared by the bin and band modes, so their values
+  //at a given index mean something else after a switch (or after the bands change).  Restart them.
+  __disable_irq();
+  use_band_mode = new_band_mode;
+  if ((new_band_mode != was_band_mode) || (new_band_mode && (n_bands != prev_n_bands))) resetNoiseTrackers();
+  __enable_irq();
+  return use_band_mode;
+}
+
+//Divide the bins (from DC through Nyquist) into bands that are equally spaced on the ERB-rate scale
+//(Glasberg and Moore, 1990), which is close to how the ear's own critical bands are spaced.  Every
+//band gets at least one bin, so short FFTs might end up with fewer bands than requested.
+void AudioEffectNoiseReduction_FD_F32::computeBands(void) {
+  const int N = ave_spectrum_N;
+  if ((N < 2) || (bin_band_lo_next == NULL) || (bin_weight_hi_next == NULL)) { use_band_mode = false; n_bands = 0; return; }
+  const float32_t Hz_per_bin = getSampleRate_Hz() / ((float32_t)getNFFT());
+  const float32_t max_ERB = 21.4f * log10f(1.0f + 0.00437f * (N-1) * Hz_per_bin);  //ERB-rate at Nyquist
+
+  //The new tables are built off to the side (update() might be using the current ones) and then swapped in.
+  int start_bin[MAX_N_BANDS+1];
+  float32_t inv_n_bins[MAX_N_BANDS];
+
+  //find the band edges
+  int Iband = 0;
+  start_bin[0] = 0;
+  for (int Iedge = 1; Iedge < target_n_bands; Iedge++) {
+    float32_t edge_Hz = (powf(10.0f, (max_ERB * Iedge / target_n_bands) / 21.4f) - 1.0f) / 0.00437f;  //from ERB-rate back to Hz
+    int edge_bin = (int)(edge_Hz / Hz_per_bin + 0.5f);
+    if ((edge_bin > start_bin[Iband]) && (edge_bin < N)) start_bin[++Iband] = edge_bin;  //skip bands that would be empty
+  }
+  const int new_n_bands = Iband + 1;
+  start_bin[new_n_bands] = N;
+  for (Iband = 0; Iband < new_n_bands; Iband++) inv_n_bins[Iband] = 1.0f / ((float32_t)(start_bin[Iband+1] - start_bin[Iband]));
+
+  //build the interpolation from the band centers back to each bin.  If there are too few bands to be
+  //useful, there's no interpolation and setBandMode() won't enable band mode.
+  if (new_n_bands >= 2) {
+    Iband = 0;
+    for (int ind = 0; ind < N; ind++) {
+      //find the pair of band centers that surround this bin
+      while ((Iband < new_n_bands-2) && (ind >= 0.5f*(start_bin[Iband+1] + start_bin[Iband+2] - 1))) Iband++;
+      float32_t center_lo = 0.5f*(start_bin[Iband]   + start_bin[Iband+1] - 1);
+      float32_t center_hi = 0.5f*(start_bin[Iband+1] + start_bin[Iband+2] - 1);
+      float32_t w = (ind - center_lo) / (center_hi - center_lo);
+      bin_band_lo_next[ind] = (uint8_t)Iband;
+      bin_weight_hi_next[ind] = max(0.0f, min(1.0f, w));  //beyond the first or last center, just use that band's gain
+    }
+  }
+
+  //swap in the new tables
+  __disable_irq();
+  if (new_n_bands < 2) use_band_mode = false;
+  for (Iband = 0; Iband <= new_n_bands; Iband++) band_start_bin[Iband] = start_bin[Iband];
+  for (Iband = 0; Iband < new_n_bands; Iband++) band_inv_n_bins[Iband] = inv_n_bins[Iband];
+  n_bands = new_n_bands;
+  uint8_t *lo = bin_band_lo;  bin_band_lo = bin_band_lo_next;  bin_band_lo_next = lo;
+  float32_t *w = bin_weight_hi;  bin_weight_hi = bin_weight_hi_next;  bin_weight_hi_next = w;
+  __enable_irq();
+}
+
+//average the power of the bins within each band
+void AudioEffectNoiseReduction_FD_F32::poolBinsIntoBands(float32_t *bin_pow, float32_t *band_pow_out) {
+  for (int Iband = 0; Iband < n_bands; Iband++) {
+    float32_t acc = 0.0f;
+    for (int ind = band_start_bin[Iband]; ind < band_start_bin[Iband+1]; ind++) acc += bin_pow[ind];
+    band_pow_out[Iband] = acc * band_inv_n_bins[Iband];
+  }
+}
+
+//interpolate the band gains (which are at the band centers) to get the gain for each bin
+void AudioEffectNoiseReduction_FD_F32::expandBandGainsToBins(float32_t *band_gains_in, float32_t *bin_gains_out) {
+  for (int ind = 0; ind < ave_spectrum_N; ind++) {
+    const float32_t *g = &(band_gains_in[bin_band_lo[ind]]);
+    bin_gains_out[ind] = g[0] + bin_weight_hi[ind]*(g[1] - g[0]);
+  }
+}
+
+
+// ///////////////////////////////////////////////////////////////// Minimum statistics and decision-directed gains
+
+int AudioEffectNoiseReduction_FD_F32::setNoiseEstimator(const int type) {
+  if ((type != NOISE_EST_ATTACK_RELEASE) && (type != NOISE_EST_MIN_STATS)) return noise_est_type;  //unknown type
+  if (ave_spectrum_N <= 0) return noise_est_type = type;  //setup() hasn't been called yet.  It'll allocate the memory.
+  
+  if ((type == NOISE_EST_MIN_STATS) && (noise_est_type != NOISE_EST_MIN_STATS)) {
+    if (min_stats_pow == NULL) {
+      //allocate the memory for the tracker (only when it's first used, since it is large)
+      min_stats_pow = new float32_t[ave_spectrum_N];
+      min_stats_sub_min = new float32_t[ave_spectrum_N];
+      min_stats_win_min = new float32_t[ave_spectrum_N];
+      min_stats_ring = new float32_t[MIN_STATS_N_SUB*ave_spectrum_N];
+    }
+    if ((min_stats_pow == NULL) || (min_stats_sub_min == NULL) || (min_stats_win_min == NULL) || (min_stats_ring == NULL)) {
+      Serial.println(F("AudioEffectNoiseReduction_FD_F32: setNoiseEstimator: *** ERROR ***: could not allocate memory for minimum statistics."));
+      return noise_est_type;
+    }
+    
+    //start the tracker from the next FFT's power (see updateAveSpectrum_minStats())
+    min_stats_first_frame = true;
+    noise_est_type = NOISE_EST_MIN_STATS;
+  } else if (type == NOISE_EST_ATTACK_RELEASE) {
+    noise_est_type = NOISE_EST_ATTACK_RELEASE;
+  }
+  return noise_est_type;
+}
+
+int AudioEffectNoiseReduction_FD_F32::setGainRule(const int type) {
+  if ((type != GAIN_RULE_SNR_THRESH) && (type != GAIN_RULE_WIENER_DD) && (type != GAIN_RULE_MMSE_STSA_DD)) return gain_rule;  //unknown type
+  if (ave_spectrum_N <= 0) return gain_rule = type;  //setup() hasn't been called yet.  It'll allocate the memory.
+  
+  if ((type == GAIN_RULE_WIENER_DD) || (type == GAIN_RULE_MMSE_STSA_DD)) {
+    if (dd_prev_clean_pow == NULL) {
+      dd_prev_clean_pow = new float32_t[ave_spectrum_N];
+      if (dd_prev_clean_pow != NULL) for (int ind=0; ind < ave_spectrum_N; ind++) dd_prev_clean_pow[ind] = 0.0f;
+    }
+    if (dd_prev_clean_pow == NULL) {
+      Serial.println(F("AudioEffectNoiseReduction_FD_F32: setGainRule: *** ERROR ***: could not allocate memory for decision-directed gains."));
+      return gain_rule;
+    }
+    gain_rule = type;
+  } else if (type == GAIN_RULE_SNR_THRESH) {
+    gain_rule = GAIN_RULE_SNR_THRESH;
+  }
+  return gain_rule;
+}
+
+float32_t AudioEffectNoiseReduction_FD_F32::setMinStatsWindow_sec(const float32_t val_sec) {
+  if (val_sec >= 0.01f) min_stats_window_sec = val_sec;
+  int n_frames = (int)(min_stats_window_sec * getOverlappedFFTRate_Hz() + 0.5f);  //getOverlappedFFTRate_Hz() is in AudioFreqDomainBase_FD_F32
+  min_stats_frames_per_sub = max(1, (n_frames + MIN_STATS_N_SUB - 1) / MIN_STATS_N_SUB);
+  return min_stats_window_sec;
+}
+
+//Minimum statistics: smooth the power in each bin, and then track its minimum over the last
+//MIN_STATS_N_SUB sub-windows.  Each sub-window's minimum is tracked sample-by-sample (cheap), and the
+//minimum across the sub-windows is only recomputed when a sub-window completes.  So, the cost per
+//bin is O(1), amortized.  The noise estimate is the minimum scaled up by the bias factor.
+void AudioEffectNoiseReduction_FD_F32::updateAveSpectrum_minStats(float32_t *current_pow, float32_t *ave, const int N) {
+  if ((min_stats_pow == NULL) || (N > ave_spectrum_N)) return;
+  const float32_t c = min_stats_smooth_coeff, c_1 = 1.0f - c;
+  
+  //on the first FFT (after the tracker is chosen or reset), start all of the minima from the current power.
+  //Otherwise, there'd be no valid minimum (and no valid noise estimate) until the whole window had passed.
+  if (min_stats_first_frame) {
+    for (int ind=0; ind < N; ind++) {
+      const float32_t p = current_pow[ind];
+      min_stats_pow[ind] = min_stats_sub_min[ind] = min_stats_win_min[ind] = p;
+      for (int Isub=0; Isub < MIN_STATS_N_SUB; Isub++) min_stats_ring[Isub*ave_spectrum_N+ind] = p;
+    }
+    min_stats_frame_count = 0;  min_stats_sub_ind = 0;
+    min_stats_first_frame = false;
+  }
+  
+  //smooth the power and update the minimum for the current sub-window
+  for (int ind=0; ind < N; ind++) {
+    float32_t p = c_1 * min_stats_pow[ind] + c * current_pow[ind];
+    min_stats_pow[ind] = p;
+    float32_t m = min(min_stats_sub_min[ind], p);
+    min_stats_sub_min[ind] = m;
+    ave[ind] = min_stats_bias * min(m, min_stats_win_min[ind]);
+  }
+  
+  //is the sub-window complete?
+  if (++min_stats_frame_count >= min_stats_frames_per_sub) {
+    min_stats_frame_count = 0;
+    
+    //save the sub-window minimum (replacing the oldest) and start a new sub-window
+    float32_t *ring_now = &(min_stats_ring[min_stats_sub_ind*ave_spectrum_N]);
+    for (int ind=0; ind < N; ind++) { ring_now[ind] = min_stats_sub_min[ind];  min_stats_sub_min[ind] = min_stats_pow[ind]; }
+    min_stats_sub_ind = (min_stats_sub_ind + 1) % MIN_STATS_N_SUB;
+    
+    //recompute the minimum across all of the sub-windows
+    for (int ind=0; ind < N; ind++) min_stats_win_min[ind] = min_stats_ring[ind];
+    for (int Isub=1; Isub < MIN_STATS_N_SUB; Isub++) {
+      float32_t *ring = &(min_stats_ring[Isub*ave_spectrum_N]);
+      for (int ind=0; ind < N; ind++) min_stats_win_min[ind] = min(min_stats_win_min[ind], ring[ind]);
+    }
+  }
+}
+
+//exponentially-scaled modified Bessel functions of the first kind, ie exp(-x)*I0(x) and exp(-x)*I1(x), for x >= 0.
+//Polynomial approximations from Abramowitz and Stegun (9.8.1 through 9.8.4)
+static float32_t bessel_i0e(const float32_t x) {
+  if (x < 3.75f) {
+    float32_t t = x*x*(1.0f/(3.75f*3.75f));
+    return expf(-x)*(1.0f + t*(3.5156229f + t*(3.0899424f + t*(1.2067492f + t*(0.2659732f + t*(0.0360768f + t*0.0045813f))))));
+  }
+  float32_t t = 3.75f / x;
+  return (0.39894228f + t*(0.01328592f + t*(0.00225319f + t*(-0.00157565f + t*(0.00916281f + t*(-0.02057706f
+    + t*(0.02635537f + t*(-0.01647633f + t*0.00392377f)))))))) / sqrtf(x);
+}
+static float32_t bessel_i1e(const float32_t x) {
+  if (x < 3.75f) {
+    float32_t t = x*x*(1.0f/(3.75f*3.75f));
+    return expf(-x)*x*(0.5f + t*(0.87890594f + t*(0.51498869f + t*(0.15084934f + t*(0.02658733f + t*(0.00301532f + t*0.00032411f))))));
+  }
+  float32_t t = 3.75f / x;
+  return (0.39894228f + t*(-0.03988024f + t*(-0.00362018f + t*(0.00163801f + t*(-0.01031555f + t*(0.02282967f
+    + t*(-0.02895312f + t*(0.01787654f - t*0.00420059f)))))))) / sqrtf(x);
+}
+
+//Decision-directed gain rules.  The a-priori SNR (xi) is a blend of the previous FFT's estimated clean
+//power and the current a-posteriori SNR (gamma).  The gain is then either the Wiener gain or the
+//MMSE short-time spectral amplitude gain (Ephraim and Malah, 1984).  Either way, the gain is never
+//allowed to go below max_gain (ie, the max attenuation setting).
+void AudioEffectNoiseReduction_FD_F32::calcGains_decisionDirected(float32_t *current_pow, float32_t *ave, float32_t *gains_out, const int N) {
+  if ((dd_prev_clean_pow == NULL) || (N > ave_spectrum_N)) return;
+  const float32_t a = dd_alpha, a_1 = 1.0f - a;
+  const float32_t half_sqrt_pi = 0.88622693f;
+  for (int ind=0; ind < N; ind++) {
+    float32_t inv_noise = 1.0f / max(ave[ind], 1.0e-20f);
+    float32_t gamma = current_pow[ind] * inv_noise;                        //a-posteriori SNR
+    float32_t xi = a * dd_prev_clean_pow[ind] * inv_noise + a_1 * max(gamma - 1.0f, 0.0f);  //a-priori SNR
+    float32_t G = xi / (1.0f + xi);                                        //Wiener gain
+    if (gain_rule == GAIN_RULE_MMSE_STSA_DD) {
+      float32_t v = G * gamma;
+      if (v > 1.0e-6f) {
+        float32_t half_v = 0.5f * v;
+        G = half_sqrt_pi * sqrtf(v) / gamma * ((1.0f + v)*bessel_i0e(half_v) + v*bessel_i1e(half_v));
+      }
+    }
+    G = max(max_gain, min(1.0f, G));
+    dd_prev_clean_pow[ind] = G * G * current_pow[ind];  //for next time
+    gains_out[ind] = G;
+  }
 }
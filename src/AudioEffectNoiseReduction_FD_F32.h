@@ -28,11 +28,32 @@
       * the amount of attenuation if it's decided to be "noise"
       * the amount smoothing in both time and frequency of the amount of attenuation
 
+  Band Mode: Optionally, the noise estimate, the SNR, and the gains can be computed on critical bands
+  (ERB-spaced) rather than on every FFT bin.  The bins are pooled into ~24-32 bands, the estimator runs
+  on the bands, and the band gains are expanded back to the bins by interpolating between the band
+  centers.  This is much cheaper than running on every bin and it is naturally smooth across frequency,
+  which reduces the "musical noise" artifacts.  See setBandMode().  In band mode, the frequency smoothing
+  (setGainSmoothing_octaves) is not used and the noise estimate is in getBandAveSpectrumPtr().
+
+  Alternative Noise Estimator and Gain Rules:  The default noise estimator (the attack/release
+  average) is slow to follow changes in the environment.  As an alternative, you can choose a
+  minimum-statistics noise tracker (after Martin, 2001), which takes the noise to be the minimum of
+  the smoothed power over the last ~1.5 seconds.  You can also choose a decision-directed gain rule
+  (after Ephraim and Malah, 1984), either the Wiener gain or the MMSE-STSA gain, instead of the
+  default SNR-threshold rule.  See setNoiseEstimator() and setGainRule().  Note that the max
+  attenuation setting still applies as the floor for the gain.
+
+  Voice Activity Detector:  Optionally, give this class an AudioCalcVAD_F32 via setVAD().  While the
+  VAD's speech probability is above the freeze threshold, the noise estimate is not updated, so that
+  the speech doesn't leak into the noise estimate (and the CPU for the update is saved).
+
   MIT License, Use at your own risk.
 */
 
 #include <AudioFreqDomainBase_FD_F32.h> //from Tympan_Library: inherit all the good stuff from this!
 #include <arm_math.h>  //fast math library for our processor
+#include "utility/FastMath_F32.h"  //from Tympan_Library: fast dB conversions
+#include "AudioCalcVAD_F32.h"  //from Tympan_Library
 
 class AudioEffectNoiseReduction_FD_F32 : public AudioFreqDomainBase_FD_F32   //AudioFreqDomainBase_FD_F32 is in Tympan_Library
 {
@@ -42,9 +63,7 @@ class AudioEffectNoiseReduction_FD_F32 : public AudioFreqDomainBase_FD_F32   //A
 
     //destructor...release all of the memory that has been allocated
     ~AudioEffectNoiseReduction_FD_F32(void) {
-      if (prev_gains != NULL) delete prev_gains;
-      if (gains != NULL) delete gains;
-      if (ave_spectrum != NULL) delete ave_spectrum;
+      freeBuffers();
     }
 
     //setup...extend the setup that is part of AudioFreqDomainBase_FD_F32
@@ -67,21 +86,21 @@ class AudioEffectNoiseReduction_FD_F32 : public AudioFreqDomainBase_FD_F32   //A
     }
     virtual float32_t getRelease_sec(void) const { return release_sec; }
     virtual float32_t setMaxAttenuation_dB(const float32_t atten_dB) { 
-      max_gain = sqrtf(powf(10.0f, 0.1f*(-atten_dB))); //linear value, amplitude not power
+      max_gain = FastMath::amp_from_db(-atten_dB); //linear value, amplitude not power
       return getMaxAttenuation_dB();
     }
-    virtual float32_t getMaxAttenuation_dB(void) const { return -10.0f*log10f(max_gain*max_gain); }
+    virtual float32_t getMaxAttenuation_dB(void) const { return -FastMath::db_from_amp(max_gain); }
     virtual float32_t setSNRforMaxAttenuation_dB(const float32_t val_dB) { 
-      SNR_for_max_atten = powf(10.0f, 0.1f*val_dB); //linear not dB, but it is power (ie, signal^2)
+      SNR_for_max_atten = FastMath::pow_from_db(val_dB); //linear not dB, but it is power (ie, signal^2)
       return getSNRforMaxAttenuation_dB();
     };
-    virtual float32_t getSNRforMaxAttenuation_dB(void) const { return 10.0f*log10f(SNR_for_max_atten); };
+    virtual float32_t getSNRforMaxAttenuation_dB(void) const { return FastMath::db_from_pow(SNR_for_max_atten); };
     virtual float32_t setTransitionWidth_dB(float32_t val_dB) { 
       val_dB = max(1.0f, val_dB);
-      transition_width = powf(10.0f, 0.1f*val_dB);  //linear not dB, but it is power (ie, signal^2)
+      transition_width = FastMath::pow_from_db(val_dB);  //linear not dB, but it is power (ie, signal^2)
       return getTransitionWidth_dB();
     };
-    virtual float32_t getTransitionWidth_dB(void) const { return 10.0f*log10f(transition_width); }
+    virtual float32_t getTransitionWidth_dB(void) const { return FastMath::db_from_pow(transition_width); }
     virtual float32_t setGainSmoothing_octaves(const float32_t val_oct) { return freq_smooth_octaves = max(0.0,val_oct); }
     virtual float32_t getGainSmoothing_octaves(void) const { return freq_smooth_octaves; }
     virtual float32_t setGainSmoothing_sec(const float32_t val_sec) {
@@ -99,11 +118,47 @@ class AudioEffectNoiseReduction_FD_F32 : public AudioFreqDomainBase_FD_F32   //A
     }
     virtual bool setEnableNoiseEstimationUpdates(const bool true_is_update) { return enableNoiseEstimationUpdates = true_is_update; }
     virtual bool getEnableNoiseEstimationUpdates(void) const { return enableNoiseEstimationUpdates; }
+
+    //freeze the noise estimate whenever the VAD thinks that there is speech.  Set to NULL to stop using the VAD.
+    virtual void setVAD(const AudioCalcVAD_F32 *_vad, const float32_t freeze_above_prob = 0.5f) { vad = _vad; vad_freeze_prob = freeze_above_prob; }
+    virtual const AudioCalcVAD_F32* getVAD(void) const { return vad; }
+
+    //band mode: compute the noise estimate and gains on ERB-spaced bands instead of on each FFT bin
+    virtual bool setBandMode(const bool enable, const int target_n_bands = 32);  //returns whether band mode is active
+    virtual bool getBandMode(void) const { return use_band_mode; }
+    virtual int getNBands(void) const { return n_bands; }  //might be fewer than requested, if the FFT is too short to fill them all
+    virtual int getBandStartBin(int Iband) const { if ((Iband >= 0) && (Iband < n_bands)) return band_start_bin[Iband]; return 0; }
+    virtual float32_t *getBandAveSpectrumPtr(void) { return band_ave; }
+    static const int MAX_N_BANDS = 48;
+
+    //choose the noise estimator and the gain rule
+    enum NOISE_EST { NOISE_EST_ATTACK_RELEASE=0, NOISE_EST_MIN_STATS };
+    enum GAIN_RULE { GAIN_RULE_SNR_THRESH=0, GAIN_RULE_WIENER_DD, GAIN_RULE_MMSE_STSA_DD };
+    virtual int setNoiseEstimator(const int type);   //returns the estimator that is active (ie, default if memory allocation failed).  OK to call before setup()
+    virtual int getNoiseEstimator(void) const { return noise_est_type; }
+    virtual int setGainRule(const int type);         //returns the gain rule that is active (ie, default if memory allocation failed).  OK to call before setup()
+    virtual int getGainRule(void) const { return gain_rule; }
+    virtual float32_t setMinStatsWindow_sec(const float32_t val_sec);   //how far back to look for the minimum
+    virtual float32_t getMinStatsWindow_sec(void) const { return min_stats_window_sec; }
+    virtual float32_t setMinStatsSmoothing_sec(const float32_t val_sec) {  //smoothing of the power before taking the minimum
+      if (val_sec >= 0.0001f) min_stats_smooth_sec = val_sec;
+      min_stats_smooth_coeff = calcCoeffGivenTimeConstant(min_stats_smooth_sec, getOverlappedFFTRate_Hz()); //getOverlappedFFTRate_Hz() is in AudioFreqDomainBase_FD_F32
+      return min_stats_smooth_sec;
+    }
+    virtual float32_t getMinStatsSmoothing_sec(void) const { return min_stats_smooth_sec; }
+    virtual float32_t setMinStatsBias(const float32_t val) { return min_stats_bias = max(1.0f, val); } //the minimum is always below the mean, so scale it up by this
+    virtual float32_t getMinStatsBias(void) const { return min_stats_bias; }
+    virtual float32_t setDecisionDirectedAlpha(const float32_t val) { return dd_alpha = max(0.0f, min(0.999f, val)); } //larger is smoother (typically 0.98)
+    virtual float32_t getDecisionDirectedAlpha(void) const { return dd_alpha; }
    
-    virtual void resetAveSpectrumAndGains(void) { for (int ind=0; ind < ave_spectrum_N; ind++) { ave_spectrum[ind]=0.0f; gains[ind] = 1.0f; prev_gains[ind]=1.0; } };
-    virtual void updateAveSpectrum(float32_t *current_pow);
-    virtual void calcGainsBasedOnSpectrum(float32_t *current_pow);
-    virtual void smoothGainsInTime(void);
+    virtual void resetAveSpectrumAndGains(void) { 
+      for (int ind=0; ind < ave_spectrum_N; ind++) { ave_spectrum[ind]=0.0f; gains[ind] = 1.0f; prev_gains[ind]=1.0; }
+      for (int Iband=0; Iband < MAX_N_BANDS; Iband++) { band_ave[Iband] = 0.0f; band_gains[Iband] = 1.0f; band_prev_gains[Iband] = 1.0f; }
+      resetNoiseTrackers();
+    };
+    virtual void updateAveSpectrum(float32_t *current_pow) { updateAveSpectrum_N(current_pow, ave_spectrum, ave_spectrum_N); }
+    virtual void calcGainsBasedOnSpectrum(float32_t *current_pow) { calcGainsBasedOnSpectrum_N(current_pow, ave_spectrum, gains, ave_spectrum_N); }
+    virtual void smoothGainsInTime(void) { smoothGainsInTime_N(gains, prev_gains, ave_spectrum_N); }
     virtual void smoothGainsInFrequency(void);
 
     //this is the method from AudioFreqDomainBase that we are overriding where we will
@@ -113,13 +168,75 @@ class AudioEffectNoiseReduction_FD_F32 : public AudioFreqDomainBase_FD_F32   //A
     void processAudioFD(float32_t *complex_2N_buffer) override; 
 
   protected:
+    //the underlying steps of the algorithm.  These work on N values, which are either the FFT bins or the bands
+    virtual void updateAveSpectrum_N(float32_t *current_pow, float32_t *ave, const int N);
+    virtual void calcGainsBasedOnSpectrum_N(float32_t *current_pow, float32_t *ave, float32_t *gains_out, const int N);
+    virtual void updateAveSpectrum_minStats(float32_t *current_pow, float32_t *ave, const int N);
+    virtual void calcGains_decisionDirected(float32_t *current_pow, float32_t *ave, float32_t *gains_out, const int N);
+    virtual void smoothGainsInTime_N(float32_t *gains_inout, float32_t *prev, const int N);
+    
+    //band mode
+    virtual void computeBands(void);  //fills in the band edges and the band-to-bin interpolation (swapped in with the audio interrupt blocked)
+    virtual void poolBinsIntoBands(float32_t *bin_pow, float32_t *band_pow_out);
+    virtual void expandBandGainsToBins(float32_t *band_gains_in, float32_t *bin_gains_out);
+    bool use_band_mode = false;
+    int target_n_bands = 32, n_bands = 0;
+    int band_start_bin[MAX_N_BANDS+1];       //first bin of each band (the last entry is one past the final bin)
+    float32_t band_inv_n_bins[MAX_N_BANDS];  //1/(number of bins in each band)...for averaging the power
+    float32_t band_pow[MAX_N_BANDS], band_ave[MAX_N_BANDS], band_gains[MAX_N_BANDS], band_prev_gains[MAX_N_BANDS];
+    uint8_t *bin_band_lo = NULL;             //interpolation matrix (it's sparse, so only store the non-zero terms): for each bin,
+    float32_t *bin_weight_hi = NULL;         //   gain = (1-w)*band_gains[lo] + w*band_gains[lo+1]
+    uint8_t *bin_band_lo_next = NULL;        //where computeBands() builds the new interpolation, before swapping it in
+    float32_t *bin_weight_hi_next = NULL;
+
+    //minimum statistics noise estimator and decision-directed gain rules
+    int noise_est_type = NOISE_EST_ATTACK_RELEASE, gain_rule = GAIN_RULE_SNR_THRESH;
+    static const int MIN_STATS_N_SUB = 8;    //number of sub-windows in the minimum-tracking window
+    float32_t min_stats_window_sec = 1.5f, min_stats_smooth_sec = 0.03f, min_stats_smooth_coeff = 1.0f, min_stats_bias = 1.5f;
+    int min_stats_frames_per_sub = 1, min_stats_frame_count = 0, min_stats_sub_ind = 0;
+    bool min_stats_first_frame = true;       //if true, the tracker is started from the next FFT's power
+    float32_t *min_stats_pow = NULL;         //smoothed power for each bin
+    float32_t *min_stats_sub_min = NULL;     //minimum of each bin during the current sub-window
+    float32_t *min_stats_win_min = NULL;     //minimum of each bin across the completed sub-windows
+    float32_t *min_stats_ring = NULL;        //minimum of each bin for each of the past sub-windows [MIN_STATS_N_SUB][ave_spectrum_N]
+    float32_t dd_alpha = 0.98f;
+    float32_t *dd_prev_clean_pow = NULL;     //estimated clean power of each bin from the previous FFT
+    void resetNoiseTrackers(void) {          //restart the minimum statistics and the decision-directed priors (such as when their resolution changes)
+      min_stats_first_frame = true;          //the minimum-statistics tracker restarts from the next FFT
+      if (dd_prev_clean_pow != NULL) for (int ind=0; ind < ave_spectrum_N; ind++) dd_prev_clean_pow[ind] = 0.0f;
+    }
+
     //create some data members specific to our processing
     float *ave_spectrum = NULL, *gains = NULL, *prev_gains = NULL;
+    float *raw_pow = NULL;       //magnitude^2 of the current FFT bins.  Allocated in setup() so that it isn't on the stack every hop
+    float *gains_cumsum = NULL;  //running sum of the gains (one longer than gains) for smoothGainsInFrequency()
     int ave_spectrum_N = 0;
+    void freeBuffers(void) {
+      if (prev_gains != NULL) delete[] prev_gains;
+      if (gains != NULL) delete[] gains;
+      if (ave_spectrum != NULL) delete[] ave_spectrum;
+      if (raw_pow != NULL) delete[] raw_pow;
+      if (gains_cumsum != NULL) delete[] gains_cumsum;
+      if (bin_weight_hi != NULL) delete[] bin_weight_hi;
+      if (bin_band_lo != NULL) delete[] bin_band_lo;
+      if (bin_weight_hi_next != NULL) delete[] bin_weight_hi_next;
+      if (bin_band_lo_next != NULL) delete[] bin_band_lo_next;
+      if (min_stats_pow != NULL) delete[] min_stats_pow;
+      if (min_stats_sub_min != NULL) delete[] min_stats_sub_min;
+      if (min_stats_win_min != NULL) delete[] min_stats_win_min;
+      if (min_stats_ring != NULL) delete[] min_stats_ring;
+      if (dd_prev_clean_pow != NULL) delete[] dd_prev_clean_pow;
+      min_stats_pow = min_stats_sub_min = min_stats_win_min = min_stats_ring = dd_prev_clean_pow = NULL;
+      prev_gains = gains = ave_spectrum = raw_pow = gains_cumsum = bin_weight_hi = NULL;
+      bin_weight_hi_next = NULL;
+      bin_band_lo = bin_band_lo_next = NULL;
+    }
     float32_t attack_sec = 10.0f, attack_coeff = 0;
     float32_t release_sec = 3.0f, release_coeff = 0;
     float32_t smooth_sec = 0.01f, smooth_coeff = 1.0; 
     bool enableNoiseEstimationUpdates = true;
+    const AudioCalcVAD_F32 *vad = NULL;     //optional voice activity detector
+    float32_t vad_freeze_prob = 0.5f;       //don't update the noise estimate when the speech probability is above this
     float32_t max_gain = 1.0;               //linear not dB, amplitude not power (so 2.0 is 6 dB)
     float32_t SNR_for_max_atten = 2.0;     //linear not dB, but it is power  (so, 2.0 is 3dB)
     float32_t transition_width = 4.0;      //linear not dB, but it is power  (so, 4.0 is 6dB)
@@ -0,0 +1,117 @@
+
+#include "AudioEffectPitchShiftPV_FD_F32.h"
+
+int AudioEffectPitchShiftPV_FD_F32::setup(const AudioSettings_F32 &settings, const int _N_FFT) {
+	int ret_val = AudioFreqDomainBase_FD_F32::setup(settings, _N_FFT, _N_FFT);
+	if (ret_val < 0) return ret_val; //it failed, so simply return now
+
+	//allocate all of the memory that we'll need (so that nothing is allocated during update())
+	freeBuffers();
+	N_2 = getNFFT() / 2 + 1;
+	mag_sq = new float32_t[N_2];
+	prev_complex = new float32_t[2*N_2];
+	out_complex = new float32_t[2*N_2];
+	syn_rot = new float32_t[N_2];
+	peak_bins = new int[N_2/2 + 1];  //peaks must be separated by at least one bin, so there can't be more than this
+	if ((mag_sq == NULL) || (prev_complex == NULL) || (out_complex == NULL) || (syn_rot == NULL) || (peak_bins == NULL)) {
+		Serial.println(F("AudioEffectPitchShiftPV_FD_F32: setup: *** ERROR ***: could not allocate memory."));
+		freeBuffers();  enabled = 0;
+		return -1;
+	}
+	resetState();
+	return ret_val;
+}
+
+void AudioEffectPitchShiftPV_FD_F32::resetState(void) {
+	for (int i=0; i < 2*N_2; i++) prev_complex[i] = 0.0f;
+	for (int i=0; i < N_2; i++) syn_rot[i] = 0.0f;
+	n_peaks = 0;
+}
+
+//Find the local maxima of the spectrum.  A bin is a peak if it is larger than its two neighbors on each side.
+void AudioEffectPitchShiftPV_FD_F32::findPeaks(void) {
+	n_peaks = 0;
+	for (int k = 2; k < N_2-2; k++) {
+		const float32_t m = mag_sq[k];
+		if ((m > peak_thresh_pow) && (m > mag_sq[k-1]) && (m >= mag_sq[k+1]) && (m > mag_sq[k-2]) && (m >= mag_sq[k+2])) {
+			peak_bins[n_peaks++] = k;
+			k++;  //the next bin can't be a peak
+		}
+	}
+}
+
+//wrap a phase to be within -pi to +pi
+static inline float32_t princarg(float32_t phase_rad) {
+	const float32_t two_pi = 2.0f*(float32_t)M_PI, inv_two_pi = 1.0f / two_pi;
+	return phase_rad - two_pi * floorf(phase_rad * inv_two_pi + 0.5f);
+}
+
+//Move one peak and its region of influence to the new frequency.  The region of influence extends
+//halfway to the neighboring peaks (to the lowest bin in between, actually).  Every bin in the region
+//is moved by the same number of bins and is rotated by the same phase, which keeps their relative phases.
+void AudioEffectPitchShiftPV_FD_F32::shiftPeakRegion(float32_t *complex_2N_buffer, const int Ipeak, const int hop) {
+	const int N_FFT = getNFFT();
+	const int k = peak_bins[Ipeak];
+	const float32_t two_pi_over_N = 2.0f*(float32_t)M_PI / ((float32_t)N_FFT);
+
+	//find the region of influence for this peak
+	int start_bin = 0, end_bin = N_2-1;
+	if (Ipeak > 0) {
+		start_bin = k;
+		for (int j = peak_bins[Ipeak-1]+1; j < k; j++) if (mag_sq[j] < mag_sq[start_bin]) start_bin = j;
+		start_bin++;  //the lowest bin belongs to the previous region
+	}
+	if (Ipeak < n_peaks-1) {
+		end_bin = k;
+		for (int j = k+1; j < peak_bins[Ipeak+1]; j++) if (mag_sq[j] <= mag_sq[end_bin]) end_bin = j;
+	}
+
+	//where does the peak go?
+	const int new_k = (int)(scale_fac * k + 0.5f);
+	const int shift_bins = new_k - k;
+	if ((new_k < 0) || (new_k >= N_2)) return;  //shifted out of the spectrum
+
+	//measure the true frequency of the peak from its change in phase since the previous FFT
+	const float32_t phase = atan2f(complex_2N_buffer[2*k+1], complex_2N_buffer[2*k]);
+	const float32_t prev_phase = atan2f(prev_complex[2*k+1], prev_complex[2*k]);
+	const float32_t expected_advance = two_pi_over_N * (float32_t)(k * hop);
+	const float32_t omega = two_pi_over_N * (float32_t)k + princarg(phase - prev_phase - expected_advance) / ((float32_t)hop); //radians per sample
+
+	//the phase rotation needed so that the shifted peak advances at its new frequency
+	float32_t rot = princarg(syn_rot[new_k] + ((float32_t)hop) * (scale_fac - 1.0f) * omega);
+	syn_rot[new_k] = rot;
+	const float32_t c = cosf(rot), s = sinf(rot);
+
+	//move and rotate every bin in the region
+	for (int src = start_bin; src <= end_bin; src++) {
+		const int dest = src + shift_bins;
+		if ((dest < 0) || (dest >= N_2)) continue;
+		const float32_t re = complex_2N_buffer[2*src], im = complex_2N_buffer[2*src+1];
+		out_complex[2*dest]   += re*c - im*s;
+		out_complex[2*dest+1] += re*s + im*c;
+	}
+}
+
+//Here is the method that is the starting point
+//
+//  Argument 1: complex_2N_buffer is the float32_t array that holds the FFT results that we are going to
+//     manipulate.  It is 2*NFFT in length because it contains the real and imaginary data values
+//     for each FFT bin.  Real and imaginary are interleaved.  We only need to worry about the bins
+//     up to Nyquist because AudioFreqDomainBase will reconstruct the freuqency bins above Nyquist for us.
+//
+//  We get our data from complex_2N_buffer and we put our results back into complex_2N_buffer
+void AudioEffectPitchShiftPV_FD_F32::processAudioFD(float32_t *complex_2N_buffer) {
+	if (out_complex == NULL) return;  //not set up yet
+	const int hop = getBlockLength_samples();  //the FFTs advance by one audio block each time
+
+	//find the peaks
+	arm_cmplx_mag_squared_f32(complex_2N_buffer, mag_sq, N_2);
+	findPeaks();
+
+	//build the pitch-shifted spectrum, one peak (and its region of influence) at a time
+	for (int i=0; i < 2*N_2; i++) out_complex[i] = 0.0f;
+	for (int Ipeak = 0; Ipeak < n_peaks; Ipeak++) shiftPeakRegion(complex_2N_buffer, Ipeak, hop);
+
+	//save the input spectrum for next time and then swap in the pitch-shifted spectrum
+	for (int i=0; i < 2*N_2; i++) { prev_complex[i] = complex_2N_buffer[i];  complex_2N_buffer[i] = out_complex[i]; }
+}
@@ -0,0 +1,87 @@
+
+/*
+ * AudioEffectPitchShiftPV_FD_F32
+ *
+ * Created: 2026
+ * Purpose: Shift the pitch of the audio up or down so that harmonic relationships are maintained
+ *          (like AudioEffectPitchShift_FD_F32), but do it entirely within the frequency domain using
+ *          a phase vocoder with identity phase locking (after Laroche and Dolson, 1999).
+ *
+ *          Rather than time-stretching and then resampling, this finds the peaks in the spectrum,
+ *          moves each peak (along with its neighboring bins, its "region of influence") to its new
+ *          frequency, and rotates the whole region's phase so that successive FFTs line up.  Because
+ *          all the bins of a region are moved and rotated together, their relative phases are kept
+ *          (the "identity phase locking"), which reduces the phasiness of the classic phase vocoder.
+ *
+ *          It is built on AudioFreqDomainBase_FD_F32, so it works with any power-of-two overlap (ie,
+ *          N_FFT divided by the audio block size).  All memory is allocated in setup(), so there is no
+ *          heap or audio-memory churn during update(), and the worst-case CPU is bounded by N_FFT.
+ *
+ * This processes a single stream of audio data (ie, it is mono)
+ *
+ * MIT License.  use at your own risk.
+*/
+
+#ifndef _AudioEffectPitchShiftPV_FD_F32_h
+#define _AudioEffectPitchShiftPV_FD_F32_h
+
+#include "AudioStream_F32.h"
+#include "AudioFreqDomainBase_FD_F32.h"
+#include "utility/FastMath_F32.h"
+#include <arm_math.h>
+#include <Arduino.h>
+
+class AudioEffectPitchShiftPV_FD_F32 : public AudioFreqDomainBase_FD_F32
+{
+//GUI: inputs:1, outputs:1  //this line used for automatic generation of GUI node
+//GUI: shortName:pitch_shift_pv
+  public:
+    //constructors...a few different options.  The usual one should be: AudioEffectPitchShiftPV_FD_F32(const AudioSettings_F32 &settings, const int _N_FFT)
+    AudioEffectPitchShiftPV_FD_F32(void) : AudioFreqDomainBase_FD_F32() { setInstanceName(); };
+    AudioEffectPitchShiftPV_FD_F32(const AudioSettings_F32 &settings) :  AudioFreqDomainBase_FD_F32(settings)  { setInstanceName(); }
+    AudioEffectPitchShiftPV_FD_F32(const AudioSettings_F32 &settings, const int _N_FFT) :  AudioFreqDomainBase_FD_F32(settings)  { setInstanceName(); setup(settings, _N_FFT); }
+    void setInstanceName(void) { instanceName = "AudioEffectPitchShiftPV_FD_F32"; }
+
+    //destructor...release all of the memory that has been allocated
+    virtual ~AudioEffectPitchShiftPV_FD_F32(void) { freeBuffers(); }
+
+    int setup(const AudioSettings_F32 &settings, const int _N_FFT) override;
+
+    //void update(void) override;  // we'll use the one from the parent class
+    void processAudioFD(float32_t *complex_2N_buffer) override;  //this is where we put all the processing.  It'll get called by the parent's update()
+
+    // set and get methods for parameters specific to the pitch-shifting processing
+    float setScaleFac(float _scale_fac) { scale_fac = max(0.125f, min(8.0f, _scale_fac)); return getScaleFac(); }
+    float getScaleFac(void) const { return scale_fac; }
+    float setScaleFac_semitones(float semitones) { setScaleFac(FastMath::exp2(semitones/12.0f)); return getScaleFac_semitones(); }
+    float getScaleFac_semitones(void) const { return 12.0f * FastMath::log2(getScaleFac()); }
+    float setPeakThresh_dB(float val_dB) { peak_thresh_pow = FastMath::pow_from_db(val_dB); return getPeakThresh_dB(); } //ignore peaks quieter than this (dBFS, per bin)
+    float getPeakThresh_dB(void) const { return FastMath::db_from_pow(peak_thresh_pow); }
+    int getOverlapFactor(void) { return myFFT.getNBuffBlocks(); }  //N_FFT / audio_block_samples
+    void resetState(void);
+
+  protected:
+    float scale_fac = 1.0; //how much to scale the frequencies (1.0 is no scaling)
+    float32_t peak_thresh_pow = 1.0e-12f;  //power, per bin (-120 dBFS)
+    int N_2 = 0;                           //number of bins from DC through Nyquist
+    float32_t *mag_sq = NULL;              //magnitude^2 of the current FFT, each bin
+    float32_t *prev_complex = NULL;        //the previous FFT (input), DC through Nyquist, interleaved real and imaginary
+    float32_t *out_complex = NULL;         //the pitch-shifted FFT being assembled, DC through Nyquist, interleaved real and imaginary
+    float32_t *syn_rot = NULL;             //accumulated phase rotation (radians) for each destination bin
+    int *peak_bins = NULL;                 //index of each spectral peak
+    int n_peaks = 0;
+
+    void freeBuffers(void) {
+      if (mag_sq != NULL) delete[] mag_sq;
+      if (prev_complex != NULL) delete[] prev_complex;
+      if (out_complex != NULL) delete[] out_complex;
+      if (syn_rot != NULL) delete[] syn_rot;
+      if (peak_bins != NULL) delete[] peak_bins;
+      mag_sq = prev_complex = out_complex = syn_rot = NULL;  peak_bins = NULL;
+    }
+    virtual void findPeaks(void);
+    virtual void shiftPeakRegion(float32_t *complex_2N_buffer, const int Ipeak, const int hop);
+};
+
+
+#endif
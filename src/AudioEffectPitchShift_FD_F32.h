@@ -19,6 +19,7 @@
 #include <arm_math.h>
 #include "FFT_Overlapped_F32.h"
 #include "AudioFilterBiquad_F32.h"
+#include "utility/FastMath_F32.h"
 #include <Arduino.h>
 #include <deque>
 #include <algorithm> //do we need this
@@ -120,8 +121,8 @@ class AudioEffectPitchShift_FD_F32 : public AudioStream_F32
     void resampleAudio(MultiAudioBlocks_F32 &stretched_audio_blocks, MultiAudioBlocks_F32 &resampled_audio_blocks);
 
     float getScaleFac(void) { return scale_fac; }
-    float setScaleFac_semitones(float semitones) { setScaleFac(powf(2.0f,semitones/12.0f)); return getScaleFac_semitones(); }
-    float getScaleFac_semitones(void) { return 12.0f * logf(getScaleFac())/ (logf(2.0f)); } //ideally, we'd use log2f, but it doesn't seem to be available
+    float setScaleFac_semitones(float semitones) { setScaleFac(FastMath::exp2(semitones/12.0f)); return getScaleFac_semitones(); }
+    float getScaleFac_semitones(void) { return 12.0f * FastMath::log2(getScaleFac()); }
    
     int getNFFT(void) { return myFFT.getNFFT(); }
     FFT_Overlapped_F32* getFFTobj(void) { return &myFFT; }
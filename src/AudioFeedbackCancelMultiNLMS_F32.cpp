@@ -0,0 +1,141 @@
+
+#include "AudioFeedbackCancelMultiNLMS_F32.h"
+#include <cfloat> //for "isfinite()"
+#include <cmath>  //actually, this one is for "isfinite()" ?
+
+//here's the method that is called automatically by the Teensy Audio Library
+void AudioFeedbackCancelMultiNLMS_F32::update(void) {
+  audio_block_f32_t *in_block[AFC_MULTI_MAX_CHAN], *out_block[AFC_MULTI_MAX_CHAN];
+
+  //receive the input audio data (and discard any for the unused channels)
+  bool any_audio = false;
+  int cs = 0;
+  for (int m=0; m < AFC_MULTI_MAX_CHAN; m++) {
+    in_block[m] = AudioStream_F32::receiveReadOnly_f32(m);
+    out_block[m] = NULL;
+    if (m >= n_chan) { AudioStream_F32::release(in_block[m]); in_block[m] = NULL; continue; }
+    if (in_block[m]) { any_audio = true; cs = in_block[m]->length; }
+  }
+  if (!any_audio) return;
+
+  //allocate memory for the outputs of our algorithm (and stand in silence for any missing inputs)
+  bool ok = true;
+  for (int m=0; m < n_chan; m++) {
+    if (in_block[m] == NULL) {
+      in_block[m] = AudioStream_F32::allocate_f32();
+      if (in_block[m]) { for (int i=0; i < cs; i++) in_block[m]->data[i] = 0.0f; in_block[m]->length = cs; }
+    }
+    out_block[m] = AudioStream_F32::allocate_f32();
+    if ((in_block[m] == NULL) || (out_block[m] == NULL) || (in_block[m]->length != cs)) ok = false;
+  }
+
+  if (ok) {
+    //do the work
+    float32_t *x[AFC_MULTI_MAX_CHAN], *y[AFC_MULTI_MAX_CHAN];
+    for (int m=0; m < n_chan; m++) { x[m] = in_block[m]->data;  y[m] = out_block[m]->data; }
+    if (enabled) {
+      cha_afc(x, y, cs);
+    } else {
+      //simply copy input to output
+      for (int m=0; m < n_chan; m++) for (int i=0; i < cs; i++) y[m][i] = x[m][i];
+    }
+
+    // transmit the blocks
+    for (int m=0; m < n_chan; m++) {
+      out_block[m]->id = in_block[m]->id;
+      out_block[m]->length = cs;
+      AudioStream_F32::transmit(out_block[m], m);
+    }
+  }
+
+  // release memory
+  for (int m=0; m < n_chan; m++) { AudioStream_F32::release(out_block[m]);  AudioStream_F32::release(in_block[m]); }
+}
+
+void AudioFeedbackCancelMultiNLMS_F32::cha_afc(float32_t *x[], float32_t *y[], int cs) {
+  switch (n_chan) {
+    case 1: cha_afc_M<1>(x, y, cs); break;
+    case 2: cha_afc_M<2>(x, y, cs); break;
+    case 3: cha_afc_M<3>(x, y, cs); break;
+    default: cha_afc_M<4>(x, y, cs); break;
+  }
+}
+
+//All M filters share one pass over the reference: each reference sample is loaded once and used by every channel
+template <int M>
+void AudioFeedbackCancelMultiNLMS_F32::cha_afc_M(float32_t *x[], float32_t *y[], int cs) {
+  //The window for the oldest sample of the block reaches afl+cs samples back (plus one for the sliding
+  //energy), which must all be in the ring buffer.  If not (a big block with a long filter), pass the audio
+  //through, as receiveLoopBackAudio() has already refused to fill the ring.
+  if ((afl + cs + 1) > max_afc_ringbuff_len) {
+    for (int m = 0; m < M; m++) for (int i = 0; i < cs; i++) y[m][i] = x[m][i];
+    return;
+  }
+
+  const int n_taps = afl - hdel;  //the first hdel taps are known to be zero, so skip them entirely
+  float32_t *w = efbp + hdel*M;
+
+  //should we adapt during this block?
+  const bool adapt = AudioCalcVAD_F32::isGateOpen(vad, vad_gate, vad_thresh);
+
+  //energy of the reference over the filter, shared by all channels.  Computed exactly once per
+  //block and then updated sample-by-sample as the window slides.
+  const float32_t *xw = ring + rhd + (cs-1) + hdel;  //window for the first sample of the block
+  float32_t ref_energy;
+  arm_power_f32(xw, n_taps, &ref_energy);
+
+  for (int i = 0; i < cs; i++) {  //step through the audio sample-by-sample
+    xw = ring + rhd + (cs-1) - i + hdel;
+    if (i > 0) ref_energy = max(0.0f, ref_energy + xw[0]*xw[0] - xw[n_taps]*xw[n_taps]);
+
+    // estimate the feedback at every mic
+    float32_t fbe[M];
+    for (int m = 0; m < M; m++) fbe[m] = 0.0f;
+    for (int j = 0; j < n_taps; j++) {
+      const float32_t xj = xw[j];
+      for (int m = 0; m < M; m++) fbe[m] += w[j*M + m] * xj;
+    }
+
+    // remove the estimated feedback from the signals
+    float32_t step[M];
+    const float32_t mum = mu / (eps + ref_energy);  // modified mu, the same for every mic
+    for (int m = 0; m < M; m++) {
+      const float32_t s1 = x[m][i] - fbe[m];
+      y[m][i] = s1;
+      step[m] = mum * s1;
+    }
+
+    // update adaptive feedback coefficients
+    if (adapt) {  //skip the adaptation (and save its CPU) if the VAD gate is closed
+      for (int j = 0; j < n_taps; j++) {
+        const float32_t xj = xw[j];
+        for (int m = 0; m < M; m++) w[j*M + m] += step[m] * xj;
+      }
+    }
+  }
+}
+
+void AudioFeedbackCancelMultiNLMS_F32::receiveLoopBackAudio(
+      float *x, //input audio block
+      int cs)   //number of samples in this audio block
+{
+  const int len = max_afc_ringbuff_len;
+  if ((cs < 1) || ((afl + cs + 1) > len)) return;  //the newest afl+cs samples (plus one) must fit in the ring buffer
+
+  //store the reference newest-first, writing each sample twice, and check that the values are valid
+  //floats (ie, not NaN or Inf), which could happen if the system is overloading
+  bool all_finite = true;
+  int ind = rhd;
+  for (int i=0; i < cs; i++) {
+    const float32_t val = x[i];
+    all_finite &= (bool)std::isfinite(val);
+    ind = (ind == 0) ? (len-1) : (ind-1);
+    ring[ind] = val;  ring[ind+len] = val;
+  }
+  if (!all_finite) {
+    //bad data found!  reset the states and return early
+    initializeStates();
+    return;
+  }
+  rhd = ind;  //the newest sample
+}
@@ -0,0 +1,162 @@
+
+/*
+   AudioFeedbackCancelMultiNLMS_F32
+
+   Created: 2026
+   Purpose: Adaptive feedback cancelation for several microphones that all hear the same loudspeaker,
+       such as the front and rear mics of one earpiece.  It is like running one AudioFeedbackCancelNLMS_F32
+       per mic, except that the loudspeaker reference (from AudioLoopBack_F32) is stored only once, its
+       power is computed only once, and all of the mics' filters are run and updated together in one
+       pass over the reference.  So, cancelling the feedback at each mic (before beamforming) costs much
+       less than using separate instances.
+
+   Normalization: Unlike AudioFeedbackCancelNLMS_F32 (whose power estimate includes each mic's own
+       signal), the step size here is normalized by the energy of the reference over the length of
+       the filter, which is the same for every mic.  So, mu is the classic NLMS step size (0 to 2, but
+       usually much smaller) and eps is a floor on that energy.
+
+   This has up to four inputs and four outputs (one per mic).  Output N is input N with its feedback removed.
+
+   MIT License.  use at your own risk.
+*/
+
+#ifndef _AudioFeedbackCancelMultiNLMS_F32
+#define _AudioFeedbackCancelMultiNLMS_F32
+
+#include <Arduino.h>  //for Serial.println()
+#include <arm_math.h> //ARM DSP extensions.  https://www.keil.com/pack/doc/CMSIS/DSP/html/index.html
+#include "AudioStream_F32.h"
+#include "AudioLoopBack_F32.h" //from Tympan_Library
+#include "AudioCalcVAD_F32.h"  //from Tympan_Library
+
+#define AFC_MULTI_MAX_CHAN 4
+#ifndef MAX_AFC_MULTI_FILT_LEN
+#define MAX_AFC_MULTI_FILT_LEN  256  //must be longer than afl
+#endif
+
+class AudioFeedbackCancelMultiNLMS_F32 : public AudioStream_F32, public AudioLoopBackInterface_F32
+{
+//GUI: inputs:4, outputs:4  //this line used for automatic generation of GUI node
+//GUI: shortName: FB_Cancel_Multi
+  public:
+    //constructor
+    AudioFeedbackCancelMultiNLMS_F32(const unsigned int _n_chan = 2) : AudioStream_F32(AFC_MULTI_MAX_CHAN, inputQueueArray_f32) {
+      setDefaultValues();
+      setNumChannels(_n_chan);  //also initializes the states
+    }
+    AudioFeedbackCancelMultiNLMS_F32(const unsigned int _n_chan, const AudioSettings_F32 &settings) : AudioFeedbackCancelMultiNLMS_F32(_n_chan) {}
+
+    virtual void setDefaultValues(void) {
+      float _mu = 0.005;   //NLMS step size
+      float _eps = 1.0e-4; //floor on the reference energy (over the whole filter)
+      int _afl = 100;      //For 24kHz sample rate
+      setParams(_mu, _eps, _afl);
+    }
+    virtual void setParams(float _mu, float _eps, int _afl) {
+      setMu(_mu);    // AFC step size
+      setEps(_eps);  // AFC floor on the reference energy (thereby avoiding divide-by-near-zero)
+      setAfl(_afl);  // AFC adaptive filter length
+    }
+
+    virtual int setNumChannels(unsigned int _n_chan) {
+      n_chan = max(1U, min(_n_chan, (unsigned int)AFC_MULTI_MAX_CHAN));
+      initializeStates();  //the filters are interleaved by channel, so the layout has changed
+      return n_chan;
+    }
+    virtual int getNumChannels(void) { return n_chan; }
+    virtual float setMu(float _mu) { return mu = max(_mu, 0.0f); }
+    virtual float setEps(float _eps) { return eps = min(max(_eps,1e-30f),1.0f); };
+    virtual float getMu(void) { return mu; };
+    virtual float getEps(void) { return eps; };
+    virtual int setAfl(int _afl) {
+      afl = min(max(_afl,1),MAX_AFC_MULTI_FILT_LEN);
+      hdel = min(hdel, afl-1);  //keep at least one active tap
+      for (int i = afl*n_chan; i < MAX_AFC_MULTI_FILT_LEN*AFC_MULTI_MAX_CHAN; i++) efbp[i] = 0.0;  //clear out the upper coefficients
+      return afl;
+    }
+    virtual int getAfl(void) { return afl; }
+    virtual int setHDel(int _hdel) {  //number of leading taps that are known to be zero (see AudioFeedbackCancelNLMS_F32)
+      hdel = min(max(_hdel,0), afl-1);
+      for (int i=0; i < hdel*n_chan; i++) efbp[i] = 0.0;
+      return hdel;
+    }
+    virtual int getHDel(void) { return hdel; }
+
+    virtual bool enable(void) { return enable(true); }
+    virtual bool enable(bool _enabled) { return enabled = _enabled; }
+    virtual void setEnable(bool _enabled) { enable(_enabled); }
+    virtual bool getEnable(void) { return enabled;};
+
+    //Optionally, gate the adaptation with a voice activity detector.  By default, there is no gate (it always adapts).
+    //With AudioCalcVAD_F32::GATE_OPEN_DURING_SPEECH, it only adapts while the speech probability is at least the
+    //threshold (skipping the adaptation, and its CPU, when there's little signal to learn from).  With
+    //AudioCalcVAD_F32::GATE_OPEN_DURING_SILENCE, it only adapts while the speech probability is below the threshold
+    //(avoiding the bias that the self-correlated speech can cause).  Use GATE_OFF (or a NULL VAD) to always adapt.
+    virtual void setVADGate(const AudioCalcVAD_F32 *_vad, const int gate, const float32_t speech_prob_thresh = 0.5f) { 
+      vad = _vad; vad_gate = gate; vad_thresh = speech_prob_thresh; 
+    }
+    virtual const AudioCalcVAD_F32* getVAD(void) const { return vad; }
+    virtual int getVADGate(void) const { return vad_gate; }
+
+    //ring buffer for the shared reference.  It is mirrored, as in AudioFeedbackCancelNLMS_F32.
+    static const int max_afc_ringbuff_len = 2*MAX_AFC_MULTI_FILT_LEN;
+    void initializeRingBuffer(void) {
+      rhd = 0;
+      for (int i = 0; i < 2*max_afc_ringbuff_len; i++) ring[i] = 0.0;
+    }
+    virtual void initializeStates(void) {
+      for (int i = 0; i < MAX_AFC_MULTI_FILT_LEN*AFC_MULTI_MAX_CHAN; i++) efbp[i] = 0.0;
+      initializeRingBuffer();
+    }
+
+    virtual void update(void);
+    virtual void cha_afc(float32_t *x[], float32_t *y[], int cs);  //input arrays, output arrays (one per channel), block (chunk) size
+
+    virtual void receiveLoopBackAudio(audio_block_f32_t *in_block) {
+      newest_ring_audio_block_id = in_block->id;
+      receiveLoopBackAudio(in_block->data, in_block->length);
+    }
+    virtual void receiveLoopBackAudio(float *x, int cs); //input array, block (chunk) size
+
+    virtual void printEstimatedFeedbackImpulseResponse(int chan) { printEstimatedFeedbackImpulseResponse(chan, &Serial); }
+    virtual void printEstimatedFeedbackImpulseResponse(int chan, Print *p) {
+      if ((chan < 0) || (chan >= n_chan)) return;
+      p->print("AudioFeedbackCancelMultiNLMS_F32: estimated feedback impulse response for channel "); p->println(chan);
+      for (int i=0; i<afl; i++) { p->print(efbp[i*n_chan + chan],5); p->print(", "); }
+      p->println();
+    }
+
+    virtual void printAlgorithmInfo(void) {
+      Serial.println("AudioFeedbackCancelMultiNLMS_F32: parameter values...");
+      Serial.println("    n_chan = " + String(n_chan));
+      Serial.println("    eps = " + String(eps,6));
+      Serial.println("    mu = " + String(mu,6));
+      Serial.println("    afl = " + String(afl));
+      Serial.println("    hdel = " + String(hdel));
+    }
+
+  protected:
+    //state-related variables
+    audio_block_f32_t *inputQueueArray_f32[AFC_MULTI_MAX_CHAN]; //memory pointer for the inputs to this module
+    bool enabled = true;
+    int n_chan = 2;
+    const AudioCalcVAD_F32 *vad = NULL;  //optional voice activity detector for gating the adaptation
+    int vad_gate = AudioCalcVAD_F32::GATE_OFF;  //off unless the user chooses a gate
+    float32_t vad_thresh = 0.5f;
+    unsigned long newest_ring_audio_block_id = 999999;
+
+    //AFC parameters
+    float32_t mu;    // AFC scale factor for how fast the filter adapts (bigger is faster)
+    float32_t eps;   // AFC floor on the reference energy (avoid divide-by-near-zero)
+    int afl;         // AFC adaptive filter length
+    int hdel = 0;    // AFC number of leading taps that are held at zero (and skipped)
+
+    //AFC states
+    float32_t ring[2*max_afc_ringbuff_len];  //the shared reference, newest first, starting at ring[rhd]
+    int rhd = 0;
+    float32_t efbp[MAX_AFC_MULTI_FILT_LEN*AFC_MULTI_MAX_CHAN];  //the estimated feedback impulse responses, interleaved: efbp[tap*n_chan + chan]
+
+    template <int M> void cha_afc_M(float32_t *x[], float32_t *y[], int cs);  //the work, for a fixed number of channels
+};  //end class definition
+
+#endif
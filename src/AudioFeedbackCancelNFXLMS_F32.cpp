@@ -96,7 +96,7 @@ int AudioFeedbackCancelNFXLMS_F32::cha_afc_input(float32_t *x, float32_t *y, int
   //float ye, yy, mmu, dif, dm, xx, ee, uu, ef, uf, cfc, sum, pwr;
   float ye, yy, mmu, xx, ee, uu, ef, uf, cfc, sum; //, pwr;
   //int i, ih, ij, is, id, j, jp1, k, nfc, puc, iqm = 0;
-  int i, ih, ij, is, id, j, jp1, k, nfc; //, puc, iqm = 0;
+  int i, ih, is, id, j, jp1, k, nfc; //, puc, iqm = 0;
   //static float *rng0, *rng1, *rng2, *rng3;
   //static float *efbp, *sfbp, *wfrp, *ffrp, *qm;
   //static float mu, rho, eps, alf, fbm;
@@ -104,6 +104,13 @@ int AudioFeedbackCancelNFXLMS_F32::cha_afc_input(float32_t *x, float32_t *y, int
   
   int mask = rsz - 1;  //added by WEA.  "rsz" must be a factor of two for this to work!
 
+  //The ring buffers are mirrored (each sample is also written rsz later), so every window back from
+  //"is" or "id" is contiguous and needs no masking...as long as the ring buffer is big enough
+  if ((mxl + hdel + cs) > rsz) {
+	  for (i = 0; i < cs; i++) y[i] = x[i];
+	  return -1;
+  }
+
   // loop over chunk
   for (i = 0; i < cs; i++) {
 	  //------------------------------------
@@ -120,47 +127,40 @@ int AudioFeedbackCancelNFXLMS_F32::cha_afc_input(float32_t *x, float32_t *y, int
 	  // apply band-limit filter
 	  if (pfl > 0) {
 		  uu = 0;
-		  for (j = 0; j < pfl; j++) {
-			  ij = (is - j) & mask;
-			  uu += ffrp[j] * rng0[ij];
-		  }
-		  rng1[ih] = uu;
+		  const float32_t *r0 = rng0 + is;
+		  for (j = 0; j < pfl; j++) uu += ffrp[j] * r0[-j];
+		  rng1[ih] = uu;  rng1[ih + rsz] = uu;
 	  }
 	  // estimate feedback
 	  ye = 0;
 	  if (afl > 0) {
-		  for (j = 0; j < afl; j++) {
-			  ij = (id - j) & mask;
-			  ye += efbp[j] * rng1[ij];
-		  }
+		  const float32_t *r1 = rng1 + id;
+		  for (j = 0; j < afl; j++) ye += efbp[j] * r1[-j];
 	  }
 	  // apply feedback to input signal
 	  ee = xx + yy - ye;
 	  //------------------------------------
 	  // apply whiten filter
 	  if (wfl > 0) {
-		  rng3[ih] = ee;
+		  rng3[ih] = ee;  rng3[ih + rsz] = ee;
 		  ef = uf = 0;
+		  const float32_t *r3 = rng3 + is, *r1 = rng1 + is;
 		  for (j = 0; j < wfl; j++) {
-			  ij = (is - j) & mask;
-			  ef += rng3[ij] * wfrp[j];
-			  uf += rng1[ij] * wfrp[j];
+			  ef += r3[-j] * wfrp[j];
+			  uf += r1[-j] * wfrp[j];
 		  }
-		  rng2[ih] = uf;
+		  rng2[ih] = uf;  rng2[ih + rsz] = uf;
 	  } else {
 		  ef = ee;
 	  }
 	  // update adaptive feedback coefficients
 	  if (afl > 0) {
-		  uf = rng2[id & mask];
+		  uf = rng2[id];
 		  //pwr = rho * sqrtf(ef * ef + uf * uf) + (1.0f - rho) * pwr;  //WEA Nov 2021...per Steve Neely email Nov 8, 2021
 		  pwr = rho * (ef * ef + uf * uf) + (1 - rho) * pwr;
 		  mmu = mu / (eps + pwr);  // modified mu
-		  for (j = 0; j < afl; j++) {
-			  ij = (id - j) & mask;
-			  uf = rng2[ij];
-			  efbp[j] += mmu * ef * uf;
-		  }
+		  const float32_t mmu_ef = mmu * ef, *r2 = rng2 + id;
+		  for (j = 0; j < afl; j++) efbp[j] += mmu_ef * r2[-j];
 	  }
 	  // update band-limit filter coefficients
 	  if (pup) {
@@ -240,7 +240,7 @@ void AudioFeedbackCancelNFXLMS_F32::cha_afc_output(float *x, int cs) { // audio
   rhd = rtl;
   for (i = 0; i < cs; i++) {
 	  j = (rhd + i) & mask;
-	  rng0[j] = x[i];
+	  rng0[j] = x[i];  rng0[j + rsz] = x[i];  //mirrored, so that the windows in cha_afc_input() are contiguous
   }
   rtl = (rhd + cs) % rsz;
 //     CHA_IVAR[_rhd] = rhd;
@@ -183,10 +183,10 @@ class AudioFeedbackCancelNFXLMS_F32 : public AudioStream_F32, public AudioLoopBa
     virtual void initializeStates(void) {
       pwr = 0.0;
       for (int i = 0; i < MAX_AFC_NXFXLMS_FILT_LEN; i++) efbp[i] = 0.0;
-      for (int i = 0; i < MAX_RSZ; i++) rng0[i] = 0.0;
-      for (int i = 0; i < MAX_RSZ; i++) rng1[i] = 0.0;
-      for (int i = 0; i < MAX_RSZ; i++) rng2[i] = 0.0;
-      for (int i = 0; i < MAX_RSZ; i++) rng3[i] = 0.0;
+      for (int i = 0; i < 2*MAX_RSZ; i++) rng0[i] = 0.0;
+      for (int i = 0; i < 2*MAX_RSZ; i++) rng1[i] = 0.0;
+      for (int i = 0; i < 2*MAX_RSZ; i++) rng2[i] = 0.0;
+      for (int i = 0; i < 2*MAX_RSZ; i++) rng3[i] = 0.0;
 
       //should we also clear the arrays for wfrp and ffrp?
     }
@@ -308,7 +308,7 @@ class AudioFeedbackCancelNFXLMS_F32 : public AudioStream_F32, public AudioLoopBa
     //ring buffer stuff
     int rhd, rtl;
     unsigned long newest_ring_audio_block_id = 999999;
-    float32_t rng0[MAX_RSZ], rng1[MAX_RSZ], rng2[MAX_RSZ], rng3[MAX_RSZ];  //ring buffers
+    float32_t rng0[2*MAX_RSZ], rng1[2*MAX_RSZ], rng2[2*MAX_RSZ], rng3[2*MAX_RSZ];  //ring buffers, mirrored (each sample is written at i and i+rsz)
  
 
 };  //end class definition
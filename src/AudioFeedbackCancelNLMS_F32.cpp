@@ -52,22 +52,31 @@ void AudioFeedbackCancelNLMS_F32::cha_afc(float32_t *x, //input audio array
   float32_t *offset_ringbuff;
   //float32_t foo;
 
+  //the first hdel taps are known to be zero, so skip them entirely
+  float32_t *efbp_active = efbp + hdel;
+  const int n_taps = afl - hdel;
+
+  //should we adapt during this block?
+  const bool adapt = AudioCalcVAD_F32::isGateOpen(vad, vad_gate, vad_thresh);
+  const bool use_ipnlms = adapt && (adapt_type == ADAPT_IPNLMS);
+  if (use_ipnlms) updateTapGains();  //the gains change slowly, so only compute them once per block
+
   // subtract estimated feedback signal
   for (i = 0; i < cs; i++) {  //step through WAV sample-by-sample
 		s0 = x[i];  //current waveform sample
 		//ii = rhd + i;
-		offset_ringbuff = ring + (cs-1) - i;
+		offset_ringbuff = ring + rhd + (cs-1) - i + hdel;
 
 		// estimate feedback
 		#if 1
 			//is this faster?  Tested on Teensy 3.6.  Yes, this is faster.
-			arm_dot_prod_f32(offset_ringbuff, efbp, afl, &fbe); //from CMSIS-DSP library for ARM chips
+			arm_dot_prod_f32(offset_ringbuff, efbp_active, n_taps, &fbe); //from CMSIS-DSP library for ARM chips
 		#else
 			fbe = 0;
-			for (int j = 0; j < afl; j++) {
+			for (int j = 0; j < n_taps; j++) {
 				//ij = (ii - j + rsz) & mask;
 				//fbe += ring[ij] * efbp[j];
-				fbe += offset_ringbuff[j] * efbp[j];
+				fbe += offset_ringbuff[j] * efbp_active[j];
 			}
 		#endif
 
@@ -81,19 +90,35 @@ void AudioFeedbackCancelNLMS_F32::cha_afc(float32_t *x, //input audio array
 		pwr = rho * pwr + ipwr; //original
 
 		// update adaptive feedback coefficients
-		mum = mu / (eps + pwr);  // modified mu
-		#if 1
-			//is this faster?  Tested on Teensy 3.6.  It is not faster
-			arm_scale_f32(offset_ringbuff,mum*s1,foo_float_array,afl);
-			arm_add_f32(efbp,foo_float_array,efbp,afl);
-		#else
-			foo = mum*s1;
-			for (int j = 0; j < afl; j++) {
-				//ij = (ii - j + rsz) & mask;
-				//efbp[j] += mum * ring[ij] * s1;  //update the estimated feedback coefficients
-				efbp[j] += foo * offset_ringbuff[j];  //update the estimated feedback coefficients
+		if (adapt) {  //skip the adaptation (and save its CPU) if the VAD gate is closed
+			mum = mu / (eps + pwr);  // modified mu
+			if (use_ipnlms) {
+				//proportionate update: each tap has its own step size
+				const float32_t foo = mum*s1;
+				const float32_t *g = tap_gain + hdel;
+				int j = 0;
+				for ( ; j <= n_taps-4; j += 4) {
+					efbp_active[j]   += foo * g[j]   * offset_ringbuff[j];
+					efbp_active[j+1] += foo * g[j+1] * offset_ringbuff[j+1];
+					efbp_active[j+2] += foo * g[j+2] * offset_ringbuff[j+2];
+					efbp_active[j+3] += foo * g[j+3] * offset_ringbuff[j+3];
+				}
+				for ( ; j < n_taps; j++) efbp_active[j] += foo * g[j] * offset_ringbuff[j];
+			} else {
+			#if 1
+				//is this faster?  Tested on Teensy 3.6.  It is not faster
+				arm_scale_f32(offset_ringbuff,mum*s1,foo_float_array,n_taps);
+				arm_add_f32(efbp_active,foo_float_array,efbp_active,n_taps);
+			#else
+				foo = mum*s1;
+				for (int j = 0; j < n_taps; j++) {
+					//ij = (ii - j + rsz) & mask;
+					//efbp[j] += mum * ring[ij] * s1;  //update the estimated feedback coefficients
+					efbp_active[j] += foo * offset_ringbuff[j];  //update the estimated feedback coefficients
+				}
+			#endif
 			}
-		#endif
+		}
 
 	//        if (n_coeff_to_zero > 0) {
 	//          //zero out the first feedback coefficients
@@ -107,38 +132,56 @@ void AudioFeedbackCancelNLMS_F32::cha_afc(float32_t *x, //input audio array
   }
 }
 
+//IPNLMS per-tap gains (Benesty and Gay, 2002):
+//    g_j = (1-alpha)/2 + (1+alpha) * N * |w_j| / (2*||w||_1 + delta)
+//These only average to one when the taps are non-zero (with all-zero taps, they'd average (1-alpha)/2), so
+//they are then divided by their actual mean.  That way, mu means the same thing as it does for NLMS.
+void AudioFeedbackCancelNLMS_F32::updateTapGains(void) {
+  const int n = afl - hdel;
+  if (n < 1) return;
+  float32_t *g = tap_gain + hdel;
+  float32_t mean_abs, mean_g;
+  arm_abs_f32(efbp + hdel, g, n);
+  arm_mean_f32(g, n, &mean_abs);
+  const float32_t l1_norm = mean_abs * (float32_t)n;
+  const float32_t delta = 1.0e-6f;  //avoid divide-by-zero when all of the taps are zero
+  arm_scale_f32(g, (1.0f + ipnlms_alpha) * ((float32_t)n) / (2.0f * l1_norm + delta), g, n);
+  arm_offset_f32(g, 0.5f * (1.0f - ipnlms_alpha), g, n);
+  
+  //normalize so that the gains average to one
+  arm_mean_f32(g, n, &mean_g);
+  if (mean_g > 1.0e-12f) {
+    arm_scale_f32(g, 1.0f / mean_g, g, n);
+  } else {
+    arm_fill_f32(1.0f, g, n);  //all-zero taps with alpha = +1.0...nothing to be proportionate to, so act like NLMS
+  }
+}
+
 void AudioFeedbackCancelNLMS_F32::receiveLoopBackAudio(
       float *x, //input audio block
 			int cs)   //number of samples in this audio block
 {
-  int Isrc, Idst;
+  const int len = max_afc_ringbuff_len;
+  if ((cs < 1) || ((afl + cs) > len)) return;  //the newest afl+cs samples must fit in the ring buffer
 
-  //Check to see if the in-coming values are valid floats (ie, not NaN or Inf).
+  //we're going to store the audio data in reverse order so that the newest is at the lowest index.
+  //Walk the head backwards, writing each sample twice (see the ring buffer's definition).
+  //
+  //Also check to see if the in-coming values are valid floats (ie, not NaN or Inf).
   //If the system is overloading, this could happen, which would lock-up this
   //feedback cancelation algorithm.
-  for (int i=0; i<cs; i++) { 
-		if (!std::isfinite(x[i])) {
-			//bad data found!  reset the states and return early
-			initializeStates();
-			return;
-		}
+  bool all_finite = true;
+  int ind = rhd;
+  for (int i=0; i < cs; i++) {  //the given data is in normal order (oldest first, newest last) so start at index 0
+		const float32_t val = x[i];
+		all_finite &= (bool)std::isfinite(val);
+		ind = (ind == 0) ? (len-1) : (ind-1);
+		ring[ind] = val;  ring[ind+len] = val;
   }
-  
-  //we're going to store the audio data in reverse order so that
-  //the newest is at index 0 and the oldest is at the end
-  //the only part of the buffer that we're using is [0 afl+cs-1]
-  
-  //slide the data to the older end of the buffer (overwriting the very oldest data)
-  Idst = afl+cs-1;  //start with the destination at the end of the buffer
-  for (int Isrc = (afl-1); Isrc > -1; Isrc--) {
-		ring[Idst]=ring[Isrc]; 
-		Idst--;
-  }
-
-  //add new data to front (we're also reversing it)
-  Idst = cs-1;  //the given data is only "cs" long
-  for (Isrc=0; Isrc < cs; Isrc++) { //the given data is in normal order (oldest first, newest last) so start at index 0
-		ring[Idst]=x[Isrc]; 
-		Idst--;
+  if (!all_finite) {
+		//bad data found!  reset the states and return early
+		initializeStates();
+		return;
   }
+  rhd = ind;  //the newest sample
 }
@@ -19,6 +19,7 @@
 #include "AudioStream_F32.h"
 #include "BTNRH_WDRC_Types.h" //from Tympan_Library
 #include "AudioLoopBack_F32.h" //form Tympan_Library
+#include "AudioCalcVAD_F32.h" //from Tympan_Library
 
 
 #ifndef MAX_AFC_NLMS_FILT_LEN
@@ -85,6 +86,7 @@ class AudioFeedbackCancelNLMS_F32 : public AudioStream_F32, public AudioLoopBack
     virtual int setAfl(int _afl) { 
       //apply limits on the input value
       afl = min(max(_afl,1),MAX_AFC_NLMS_FILT_LEN);
+      hdel = min(hdel, afl-1);  //keep at least one active tap
 
       //clear out the upper coefficients
       if (afl < MAX_AFC_NLMS_FILT_LEN) {
@@ -97,6 +99,24 @@ class AudioFeedbackCancelNLMS_F32 : public AudioStream_F32, public AudioLoopBack
     };
     virtual int getAfl(void) { return afl;};
 
+    //The first hdel taps of the feedback model are known to be zero (eg, the hardware delay, as in the
+    //hdel of settings_AFC_NFXLMS, minus the one block that the loopback already provides).  They are held
+    //at zero and are skipped entirely by the filtering and by the adaptation.
+    virtual int setHDel(int _hdel) {
+      hdel = min(max(_hdel,0), afl-1);
+      for (int i=0; i < hdel; i++) efbp[i] = 0.0;
+      return hdel;
+    }
+    virtual int getHDel(void) { return hdel; }
+
+    //Choose the adaptation rule.  IPNLMS ("improved proportionate NLMS") gives each tap a step size that
+    //grows with the tap's magnitude, which converges faster for sparse feedback paths without raising mu.
+    enum ADAPT_TYPE { ADAPT_NLMS=0, ADAPT_IPNLMS };
+    virtual int setAdaptationType(int _type) { return adapt_type = ((_type == ADAPT_IPNLMS) ? ADAPT_IPNLMS : ADAPT_NLMS); }
+    virtual int getAdaptationType(void) { return adapt_type; }
+    virtual float setIPNLMSAlpha(float _alpha) { return ipnlms_alpha = min(max(_alpha,-1.0f),1.0f); }  //-1.0 is the same as NLMS, +1.0 is fully proportionate
+    virtual float getIPNLMSAlpha(void) { return ipnlms_alpha; }
+
     //int setNCoeffToZero(int _n_coeff_to_zero) { return n_coeff_to_zero = min(max(_n_coeff_to_zero,0),MAX_AFC_NLMS_FILT_LEN); }
     //int getNCoeffToZero(void) { return n_coeff_to_zero; };
     
@@ -105,15 +125,28 @@ class AudioFeedbackCancelNLMS_F32 : public AudioStream_F32, public AudioLoopBack
     virtual void setEnable(bool _enabled) { enable(_enabled); }
     virtual bool getEnable(void) { return enabled;};
 
-    //ring buffer
+    //Optionally, gate the adaptation with a voice activity detector.  By default, there is no gate (it always adapts).
+    //With AudioCalcVAD_F32::GATE_OPEN_DURING_SPEECH, it only adapts while the speech probability is at least the
+    //threshold (skipping the adaptation, and its CPU, when there's little signal to learn from).  With
+    //AudioCalcVAD_F32::GATE_OPEN_DURING_SILENCE, it only adapts while the speech probability is below the threshold
+    //(avoiding the bias that the self-correlated speech can cause).  Use GATE_OFF (or a NULL VAD) to always adapt.
+    virtual void setVADGate(const AudioCalcVAD_F32 *_vad, const int gate, const float32_t speech_prob_thresh = 0.5f) { 
+      vad = _vad; vad_gate = gate; vad_thresh = speech_prob_thresh; 
+    }
+    virtual const AudioCalcVAD_F32* getVAD(void) const { return vad; }
+    virtual int getVADGate(void) const { return vad_gate; }
+
+    //ring buffer.  It is a mirrored circular buffer: each sample is written twice (at rhd and at
+    //rhd+max_afc_ringbuff_len) so that the newest afl+cs samples are always contiguous, newest first,
+    //starting at ring[rhd].  So, nothing needs to be slid when new audio arrives.
     //static const int max_afc_ringbuff_len = MAX_AFC_NLMS_FILT_LEN;
     static const int max_afc_ringbuff_len = 2*MAX_AFC_NLMS_FILT_LEN;
-    float32_t ring[max_afc_ringbuff_len];
+    float32_t ring[2*max_afc_ringbuff_len];
     int rhd, rtl;
     unsigned long newest_ring_audio_block_id = 999999;
     void initializeRingBuffer(void) {
       rhd = 0;  rtl = 0;
-      for (int i = 0; i < max_afc_ringbuff_len; i++) ring[i] = 0.0;
+      for (int i = 0; i < 2*max_afc_ringbuff_len; i++) ring[i] = 0.0;
     }
     //int rsz = max_afc_ringbuff_len;  //"ring buffer size"...variable name inherited from original BTNRH code
     //int mask = rsz - 1;
@@ -168,6 +201,8 @@ class AudioFeedbackCancelNLMS_F32 : public AudioStream_F32, public AudioLoopBack
       Serial.println("    eps = " + String(eps,6));
       Serial.println("    mu = " + String(mu,6));
       Serial.println("    afl = " + String(afl));
+      Serial.println("    hdel = " + String(hdel));
+      Serial.println("    adaptation = " + String((adapt_type == ADAPT_IPNLMS) ? "IPNLMS, alpha = " + String(ipnlms_alpha,2) : "NLMS"));
       Serial.println("    pwr = " + String(pwr,6));
     }
 
@@ -175,18 +210,26 @@ class AudioFeedbackCancelNLMS_F32 : public AudioStream_F32, public AudioLoopBack
     //state-related variables
     audio_block_f32_t *inputQueueArray_f32[1]; //memory pointer for the input to this module
     bool enabled = true;
+    const AudioCalcVAD_F32 *vad = NULL;  //optional voice activity detector for gating the adaptation
+    int vad_gate = AudioCalcVAD_F32::GATE_OFF;  //off unless the user chooses a gate
+    float32_t vad_thresh = 0.5f;
 
     //AFC parameters
     float32_t mu;    // AFC scale factor for how fast the filter adapts (bigger is faster)
     float32_t rho;   // AFC averaging factor for estimating audio envelope (bigger is longer averaging)
     float32_t eps;   // AFC when estimating audio level, this is the min value allowed (avoid divide-by-near-zero)
     int afl;         // AFC adaptive filter length
+    int hdel = 0;    // AFC number of leading taps that are held at zero (and skipped)
+    int adapt_type = ADAPT_NLMS;
+    float32_t ipnlms_alpha = 0.0f;  // IPNLMS mix between uniform (-1.0) and proportionate (+1.0) step sizes
     //int n_coeff_to_zero;  //number of the first AFC filter coefficients to artificially zero out (debugging)
 
     //AFC states
     float32_t pwr;   // AFC estimate of error power...a state variable
     float32_t efbp[MAX_AFC_NLMS_FILT_LEN];  //vector holding the estimated feedback impulse response
     float32_t foo_float_array[MAX_AFC_NLMS_FILT_LEN];
+    float32_t tap_gain[MAX_AFC_NLMS_FILT_LEN];  //IPNLMS per-tap gains (updated once per block)
+    virtual void updateTapGains(void);
 
 };  //end class definition
 
@@ -0,0 +1,256 @@
+
+#include "AudioFeedbackCancelPBFDAF_F32.h"
+#include <cfloat> //for "isfinite()"
+#include <cmath>  //actually, this one is for "isfinite()" ?
+
+int AudioFeedbackCancelPBFDAF_F32::setAfl(int _afl) {
+  is_ready = false;  //stop the audio processing from using the memory
+
+  //the partitions are as long as the audio blocks and the FFT is twice that
+  if (!FFT_F32::is_valid_N_FFT(2*block_size)) {
+    Serial.print(F("AudioFeedbackCancelPBFDAF_F32: setAfl: *** ERROR ***: block size (")); Serial.print(block_size);
+    Serial.println(F(") must be a power of 2 from 8 to 2048."));
+    freeBuffers(); n_part = 0;
+    return 0;
+  }
+  _afl = min(max(_afl, 1), MAX_AFC_PBFDAF_FILT_LEN);
+
+  //allocate the memory
+  freeBuffers();
+  N_FFT = 2*block_size;
+  N_2 = block_size + 1;
+  n_part = (_afl + block_size - 1) / block_size;  //round up to a whole number of partitions
+  X_fdl = new float32_t[2*N_2*n_part];
+  W = new float32_t[2*N_2*n_part];
+  bin_pow = new float32_t[N_2];
+  prev_ref = new float32_t[block_size];
+  work = new float32_t[2*N_FFT];
+  err_spec = new float32_t[2*N_2];
+  if ((X_fdl == NULL) || (W == NULL) || (bin_pow == NULL) || (prev_ref == NULL) || (work == NULL) || (err_spec == NULL)) {
+    Serial.println(F("AudioFeedbackCancelPBFDAF_F32: setAfl: *** ERROR ***: could not allocate memory."));
+    freeBuffers(); n_part = 0;
+    return 0;
+  }
+
+  //setup the FFTs.  No windowing!
+  myFFT.setup(N_FFT);  myFFT.useRectangularWindow();
+  myIFFT.setup(N_FFT);
+
+  initializeStates();
+  is_ready = true;
+  return getAfl();
+}
+
+void AudioFeedbackCancelPBFDAF_F32::freeBuffers(void) {
+  delete [] X_fdl;    X_fdl = NULL;
+  delete [] W;        W = NULL;
+  delete [] bin_pow;  bin_pow = NULL;
+  delete [] prev_ref; prev_ref = NULL;
+  delete [] work;     work = NULL;
+  delete [] err_spec; err_spec = NULL;
+}
+
+void AudioFeedbackCancelPBFDAF_F32::initializeStates(void) {
+  if (W == NULL) return;
+  for (int i=0; i < 2*N_2*n_part; i++) { X_fdl[i] = 0.0f; W[i] = 0.0f; }
+  for (int k=0; k < N_2; k++) bin_pow[k] = 0.0f;
+  for (int i=0; i < block_size; i++) prev_ref[i] = 0.0f;
+  fdl_head = 0;
+  constrain_ind = 0;
+}
+
+//here's the method that is called automatically by the Teensy Audio Library
+void AudioFeedbackCancelPBFDAF_F32::update(void) {
+
+  //receive the input audio data
+  audio_block_f32_t *in_block = AudioStream_F32::receiveReadOnly_f32();
+  if (!in_block) return;
+
+  //allocate memory for the output of our algorithm
+  audio_block_f32_t *out_block = AudioStream_F32::allocate_f32();
+  if (!out_block) {
+    AudioStream_F32::release(in_block);
+    return;
+  }
+
+  //check to see if we're outpacing our feedback data
+  if (newest_ring_audio_block_id != 999999) { //999999 is the default startup number, so ignore it
+    if ((in_block->id > 100) && (newest_ring_audio_block_id > 0)) { //ignore startup period
+      if ((in_block->id != 0) && ((in_block->id - newest_ring_audio_block_id) > 1)) {  //is the difference more than one block counter? (an offset of 1 is expected)
+        Serial.print("AudioFeedbackCancelPBFDAF_F32: falling behind?  in_block = ");
+        Serial.print(in_block->id); Serial.print(", ring block = "); Serial.println(newest_ring_audio_block_id);
+      }
+    }
+  }
+
+  //do the work
+  if (enabled && is_ready && (in_block->length == block_size)) {
+    processAudioBlock(in_block->data, out_block->data, in_block->length);
+  } else {
+    //simply copy input to output
+    for (int i=0; i < in_block->length; i++) out_block->data[i] = in_block->data[i];
+  }
+  out_block->id = in_block->id;
+  out_block->length = in_block->length;
+
+  // transmit the block and release memory
+  AudioStream_F32::transmit(out_block);
+  AudioStream_F32::release(out_block);
+  AudioStream_F32::release(in_block);
+}
+
+void AudioFeedbackCancelPBFDAF_F32::processAudioBlock(const float32_t *x, //input audio array
+    float32_t *y, //output audio array
+    int cs) //"chunk size"...the length of the audio array
+{
+  const int B = block_size;
+  if (cs != B) return;
+
+  // estimate the feedback: sum over the partitions of the weights times the delayed loopback spectra
+  for (int i=0; i < 2*N_2; i++) work[i] = 0.0f;
+  for (int p=0; p < n_part; p++) {
+    const float32_t *Xp = partition(X_fdl, p), *Wp = W + 2*N_2*p;
+    for (int k=0; k < N_2; k++) {
+      const float32_t xr = Xp[2*k], xi = Xp[2*k+1], wr = Wp[2*k], wi = Wp[2*k+1];
+      work[2*k]   += xr*wr - xi*wi;
+      work[2*k+1] += xr*wi + xi*wr;
+    }
+  }
+  mirrorToFullSpectrum(work);
+  myIFFT.execute(work);
+
+  // remove the estimated feedback (overlap-save: the valid output is the second half)
+  for (int i=0; i < B; i++) y[i] = x[i] - work[2*(B+i)];
+
+  // should we adapt during this block?
+  if (!AudioCalcVAD_F32::isGateOpen(vad, vad_gate, vad_thresh)) return;  //skip the adaptation (and save its CPU)
+
+  // get the spectrum of the error, [zeros, error]
+  for (int i=0; i < B; i++) {
+    work[2*i] = 0.0f;        work[2*i+1] = 0.0f;
+    work[2*(B+i)] = y[i];    work[2*(B+i)+1] = 0.0f;
+  }
+  myFFT.execute(work);
+
+  // per-bin normalized step size.  |X_k|^2 is about N_FFT times the per-sample power, so the factor
+  // of 2 makes mu match that of a time-domain NLMS of the same length.
+  const float32_t pow_floor = eps * (float32_t)N_FFT;
+  const float32_t mu_scaled = 2.0f * mu / ((float32_t)n_part);
+  for (int k=0; k < N_2; k++) {
+    const float32_t g = mu_scaled / (bin_pow[k] + pow_floor);
+    err_spec[2*k]   = g * work[2*k];
+    err_spec[2*k+1] = g * work[2*k+1];
+  }
+
+  // update the weights: W_p += conj(X_p) * E
+  for (int p=0; p < n_part; p++) {
+    const float32_t *Xp = partition(X_fdl, p);
+    float32_t *Wp = W + 2*N_2*p;
+    for (int k=0; k < N_2; k++) {
+      const float32_t xr = Xp[2*k], xi = Xp[2*k+1], er = err_spec[2*k], ei = err_spec[2*k+1];
+      Wp[2*k]   += xr*er + xi*ei;
+      Wp[2*k+1] += xr*ei - xi*er;
+    }
+  }
+
+  // apply the gradient constraint
+  if (constrain_all) {
+    for (int p=0; p < n_part; p++) constrainPartition(W + 2*N_2*p);
+  } else {
+    constrainPartition(W + 2*N_2*constrain_ind);
+    constrain_ind = (constrain_ind + 1) % n_part;
+  }
+}
+
+void AudioFeedbackCancelPBFDAF_F32::receiveLoopBackAudio(
+      float *x, //input audio block
+      int cs)   //number of samples in this audio block
+{
+  if ((!is_ready) || (cs != block_size)) return;
+  const int B = block_size;
+
+  //Check to see if the in-coming values are valid floats (ie, not NaN or Inf).
+  //If the system is overloading, this could happen, which would lock-up this
+  //feedback cancelation algorithm.
+  for (int i=0; i<cs; i++) {
+    if (!std::isfinite(x[i])) {
+      //bad data found!  reset the states and return early
+      initializeStates();
+      return;
+    }
+  }
+
+  //take the FFT of [previous block, this block]
+  for (int i=0; i < B; i++) {
+    work[2*i] = prev_ref[i];    work[2*i+1] = 0.0f;
+    work[2*(B+i)] = x[i];       work[2*(B+i)+1] = 0.0f;
+    prev_ref[i] = x[i];
+  }
+  myFFT.execute(work);
+
+  //push it onto the frequency-domain delay line (over-writing the oldest)
+  fdl_head = (fdl_head + n_part - 1) % n_part;
+  float32_t *X0 = partition(X_fdl, 0);
+  for (int i=0; i < 2*N_2; i++) X0[i] = work[i];
+
+  //smooth the power in each bin (for the normalized step size)
+  const float32_t a = rho, b = 1.0f - rho;
+  for (int k=0; k < N_2; k++) bin_pow[k] = a*bin_pow[k] + b*(X0[2*k]*X0[2*k] + X0[2*k+1]*X0[2*k+1]);
+}
+
+void AudioFeedbackCancelPBFDAF_F32::mirrorToFullSpectrum(float32_t *complex_buff) {
+  for (int k=1; k < N_FFT/2; k++) {
+    complex_buff[2*(N_FFT-k)]   =  complex_buff[2*k];    //real
+    complex_buff[2*(N_FFT-k)+1] = -complex_buff[2*k+1];  //imaginary (complex conjugate)
+  }
+}
+
+//go to the time domain, zero the second half, and come back
+void AudioFeedbackCancelPBFDAF_F32::constrainPartition(float32_t *W_p) {
+  for (int i=0; i < 2*N_2; i++) work[i] = W_p[i];
+  mirrorToFullSpectrum(work);
+  myIFFT.execute(work);
+  for (int i=0; i < block_size; i++) work[2*i+1] = 0.0f;  //the impulse response is real
+  for (int i=2*block_size; i < 2*N_FFT; i++) work[i] = 0.0f;
+  myFFT.execute(work);
+  for (int i=0; i < 2*N_2; i++) W_p[i] = work[i];
+}
+
+int AudioFeedbackCancelPBFDAF_F32::getEstimatedFeedbackImpulseResponse(float32_t *out, int max_n) {
+  if ((!is_ready) || (out == NULL)) return 0;
+  float32_t *buff = new float32_t[2*N_FFT];  //don't use "work", which belongs to the audio processing
+  if (buff == NULL) return 0;
+
+  int n_out = 0;
+  for (int p=0; (p < n_part) && (n_out < max_n); p++) {
+    const float32_t *Wp = W + 2*N_2*p;
+    for (int i=0; i < 2*N_2; i++) buff[i] = Wp[i];
+    for (int k=1; k < N_FFT/2; k++) { buff[2*(N_FFT-k)] = buff[2*k];  buff[2*(N_FFT-k)+1] = -buff[2*k+1]; }
+    myIFFT.execute(buff);
+    for (int i=0; (i < block_size) && (n_out < max_n); i++) out[n_out++] = buff[2*i];
+  }
+  delete [] buff;
+  return n_out;
+}
+
+void AudioFeedbackCancelPBFDAF_F32::printEstimatedFeedbackImpulseResponse(Print *p, bool flag_eachOnNewLine) {
+  const int afl = getAfl();
+  if (afl < 1) return;
+  float32_t *ir = new float32_t[afl];
+  if (ir == NULL) return;
+  int n = getEstimatedFeedbackImpulseResponse(ir, afl);
+
+  p->println("AudioFeedbackCancelPBFDAF_F32: estimated feedback impulse response:");
+  float scale = 1.0;
+  if (flag_eachOnNewLine) scale = 20.0;
+  for (int i=0; i<n; i++) {
+    p->print(ir[i]*scale,5);
+    if (flag_eachOnNewLine) {
+      p->println();
+    } else {
+      p->print(", ");
+    }
+  }
+  if (!flag_eachOnNewLine) p->println();
+  delete [] ir;
+}
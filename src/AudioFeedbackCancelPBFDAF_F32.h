@@ -0,0 +1,175 @@
+
+/*
+   AudioFeedbackCancelPBFDAF_F32
+
+   Created: 2026
+   Purpose: Adaptive feedback cancelation using a partitioned-block frequency-domain adaptive
+       filter (PBFDAF).  This is the same job as AudioFeedbackCancelNLMS_F32, but the filtering
+       and the adaptation are done with FFTs a whole audio block at a time.  As a result, the
+       cost per sample grows with log(N) (plus a small complex multiply per partition) rather
+       than with the filter length, so much longer filters (256+ taps) become affordable, as are
+       needed for higher sample rates or for vented fittings.
+
+   Algorithm:
+       * The feedback model (afl taps) is split into partitions whose length is the audio block
+         size (B).  Each partition is held in the frequency domain with N = 2*B (overlap-save).
+       * The loopback audio (via AudioLoopBack_F32) is FFT'd once per block and kept in a
+         frequency-domain delay line, one spectrum per partition.
+       * The estimated feedback is the sum over partitions of the weights times the delayed
+         loopback spectra.  It is subtracted from the input audio.
+       * The weights are updated with a per-bin normalized step size (mu divided by the smoothed
+         loopback power in that bin), which speeds the convergence for colored signals like speech.
+       * The gradient constraint (which keeps each partition from wrapping around in time) is
+         applied to one partition per block, in rotation, unless setConstrainAllPartitions(true).
+
+   Compared to AudioFeedbackCancelNLMS_F32, "mu" here is a normalized step size (roughly 0 to 1),
+   "rho" is the forgetting factor of the per-bin power estimate, which is updated once per block,
+   and "eps" is a floor on the per-sample signal power.
+
+   This processes a single stream of audio data (ie, it is mono)
+
+   MIT License.  use at your own risk.
+*/
+
+#ifndef _AudioFeedbackCancelPBFDAF_F32
+#define _AudioFeedbackCancelPBFDAF_F32
+
+#include <Arduino.h>  //for Serial.println()
+#include <arm_math.h> //ARM DSP extensions.  https://www.keil.com/pack/doc/CMSIS/DSP/html/index.html
+#include "AudioStream_F32.h"
+#include "FFT_F32.h"              //from Tympan_Library
+#include "BTNRH_WDRC_Types.h"     //from Tympan_Library
+#include "AudioLoopBack_F32.h"    //from Tympan_Library
+#include "AudioCalcVAD_F32.h"     //from Tympan_Library
+
+#ifndef MAX_AFC_PBFDAF_FILT_LEN
+#define MAX_AFC_PBFDAF_FILT_LEN  2048  //limits the memory that can be allocated
+#endif
+
+class AudioFeedbackCancelPBFDAF_F32 : public AudioStream_F32, public AudioLoopBackInterface_F32
+{
+//GUI: inputs:1, outputs:1  //this line used for automatic generation of GUI node
+//GUI: shortName: FB_Cancel_PBFDAF
+  public:
+    //constructor
+    AudioFeedbackCancelPBFDAF_F32(void) : AudioStream_F32(1, inputQueueArray_f32) {
+      setDefaultValues();
+    }
+    AudioFeedbackCancelPBFDAF_F32(const AudioSettings_F32 &settings) : AudioStream_F32(1, inputQueueArray_f32) {
+      block_size = settings.audio_block_samples;
+      setDefaultValues();
+    }
+    ~AudioFeedbackCancelPBFDAF_F32(void) { freeBuffers(); }
+
+    virtual void setDefaultValues(void) {
+      float _mu = 0.005;   //normalized step size
+      float _rho = 0.9;    //forgetting factor for the per-bin power (per block)
+      float _eps = 1.0e-6; //floor on the per-sample power (-60 dBFS)
+      int _afl = 256;      //adaptive filter length (is rounded up to a multiple of the block size)
+      setParams(_mu, _rho, _eps, _afl);
+    }
+    virtual void setParams(BTNRH_WDRC::CHA_AFC cha) {
+      setParams(cha.mu, cha.rho, cha.eps, cha.afl);
+      setEnable(cha.default_to_active);
+    }
+    virtual void setParams(float _mu, float _rho, float _eps, int _afl) {
+      setMu(_mu);     // AFC step size
+      setRho(_rho);   // AFC forgetting factor
+      setEps(_eps);   // AFC tolerance for setting a floor on the smallest signal level (thereby avoiding divide-by-near-zero)
+      setAfl(_afl);   // AFC adaptive filter length
+    }
+
+    virtual float setMu(float _mu) { return mu = max(_mu, 0.0f); }
+    virtual float setRho(float _rho) { return rho = min(max(_rho,0.0f),1.0f); };
+    virtual float setEps(float _eps) { return eps = min(max(_eps,1e-30f),1.0f); };
+    virtual float getMu(void) { return mu; };
+    virtual float getRho(void) { return rho; };
+    virtual float getEps(void) { return eps; };
+    virtual int setAfl(int _afl);  //re-allocates the memory and resets the states.  Returns the actual afl.
+    virtual int getAfl(void) { return n_part * block_size; };
+    virtual int getNumPartitions(void) { return n_part; }
+    virtual int getBlockSize(void) { return block_size; }
+    virtual bool setConstrainAllPartitions(bool val) { return constrain_all = val; }  //true costs 2 more FFTs per partition per block
+    virtual bool getConstrainAllPartitions(void) { return constrain_all; }
+
+    virtual bool enable(void) { return enable(true); }
+    virtual bool enable(bool _enabled) { return enabled = _enabled; }
+    virtual void setEnable(bool _enabled) { enable(_enabled); }
+    virtual bool getEnable(void) { return enabled;};
+
+    //Optionally, gate the adaptation with a voice activity detector.  There is no gate unless you choose one.
+    //See AudioFeedbackCancelNLMS_F32::setVADGate() for the meaning of each gate.
+    virtual void setVADGate(const AudioCalcVAD_F32 *_vad, const int gate, const float32_t speech_prob_thresh = 0.5f) { 
+      vad = _vad; vad_gate = gate; vad_thresh = speech_prob_thresh; 
+    }
+    virtual const AudioCalcVAD_F32* getVAD(void) const { return vad; }
+    virtual int getVADGate(void) const { return vad_gate; }
+
+    virtual void initializeStates(void);
+
+    virtual void update(void);
+    virtual void processAudioBlock(const float32_t *x, float32_t *y, int cs);  //input array, output array, block (chunk) size
+
+    virtual void receiveLoopBackAudio(audio_block_f32_t *in_block) {
+      newest_ring_audio_block_id = in_block->id;
+      receiveLoopBackAudio(in_block->data, in_block->length);
+    }
+    virtual void receiveLoopBackAudio(float *x, int cs); //input array, block (chunk) size
+
+    //convert the frequency-domain weights back into an impulse response.  Not for use inside the audio processing!
+    virtual int getEstimatedFeedbackImpulseResponse(float32_t *out, int max_n);
+    virtual void printEstimatedFeedbackImpulseResponse(void) { printEstimatedFeedbackImpulseResponse(&Serial, false); }
+    virtual void printEstimatedFeedbackImpulseResponse(Print *p, bool flag_eachOnNewLine);
+
+    virtual void printAlgorithmInfo(void) {
+      Serial.println("AudioFeedbackCancelPBFDAF_F32: parameter values...");
+      Serial.println("    rho = " + String(rho,6));
+      Serial.println("    eps = " + String(eps,8));
+      Serial.println("    mu = " + String(mu,6));
+      Serial.println("    afl = " + String(getAfl()) + " (" + String(n_part) + " partitions of " + String(block_size) + ")");
+      Serial.println("    N_FFT = " + String(N_FFT));
+    }
+
+  protected:
+    //state-related variables
+    audio_block_f32_t *inputQueueArray_f32[1]; //memory pointer for the input to this module
+    bool enabled = true;
+    volatile bool is_ready = false;  //false while the memory is being (re)allocated
+    const AudioCalcVAD_F32 *vad = NULL;  //optional voice activity detector for gating the adaptation
+    int vad_gate = AudioCalcVAD_F32::GATE_OFF;  //off unless the user chooses a gate
+    float32_t vad_thresh = 0.5f;
+    unsigned long newest_ring_audio_block_id = 999999;
+
+    //AFC parameters
+    float32_t mu;    // normalized step size
+    float32_t rho;   // forgetting factor for the per-bin power estimate
+    float32_t eps;   // floor on the per-sample power (avoid divide-by-near-zero)
+    bool constrain_all = false;
+
+    //sizes
+    int block_size = AUDIO_BLOCK_SAMPLES;  //B, the partition length
+    int N_FFT = 0;   //2*B
+    int N_2 = 0;     //number of unique bins, B+1
+    int n_part = 0;  //number of partitions
+
+    //FFT machinery (complex FFTs of real data)
+    FFT_F32 myFFT;
+    IFFT_F32 myIFFT;
+
+    //states (all allocated in setAfl())
+    float32_t *X_fdl = NULL;       //frequency-domain delay line of the loopback spectra, [n_part][N_2] complex
+    float32_t *W = NULL;           //frequency-domain weights, [n_part][N_2] complex
+    float32_t *bin_pow = NULL;     //smoothed power of the newest loopback spectrum, [N_2]
+    float32_t *prev_ref = NULL;    //previous block of loopback audio, [B]
+    float32_t *work = NULL;        //complex working buffer, [N_FFT] complex
+    float32_t *err_spec = NULL;    //step-size-scaled error spectrum, [N_2] complex
+    int fdl_head = 0;              //index of the newest spectrum in X_fdl
+    int constrain_ind = 0;         //which partition gets constrained next
+
+    void freeBuffers(void);
+    float32_t* partition(float32_t *base, int age) { return base + 2*N_2*((fdl_head + age) % n_part); }
+    void mirrorToFullSpectrum(float32_t *complex_buff);  //rebuild bins N/2+1...N-1 from bins 1...N/2-1
+    void constrainPartition(float32_t *W_p);             //zero the second half of the partition's impulse response
+};  //end class definition
+
+#endif
@@ -15,23 +15,37 @@ void AudioFilterBiquad_F32::update(void)
 {
   audio_block_f32_t *block;
 
-  block = AudioStream_F32::receiveWritable_f32();
-  if (!block) return;
-
   // If there's no coefficient table, give up.  
   if (coeff_p == NULL) {
+    block = AudioStream_F32::receiveReadOnly_f32();
+    if (block) AudioStream_F32::release(block);
+    return;
+  }
+
+  //if the input is silent and the filter has rung down, simply pass the silence along
+  if (isInputSilent_f32() && is_enabled && !is_bypassed && isStateQuiet()) {
+    block = AudioStream_F32::receiveReadOnly_f32();
+    clearState();  //so that it really is silent
+    AudioStream_F32::transmit(block);
     AudioStream_F32::release(block);
     return;
   }
 
-  // do passthru
+  // do passthru (the block isn't changed, so it can be passed along as-is, including whether it is silent)
   if ((coeff_p == IIR_F32_PASSTHRU) || (is_bypassed==true)) {
-    // Just passthrough
+    block = AudioStream_F32::receiveReadOnly_f32();
+    if (!block) return;
     AudioStream_F32::transmit(block);
     AudioStream_F32::release(block);
     return;
   }
 
+  //receiveWritable_f32() clears the silent flag, so remember it for processAudioBlock()
+  const bool was_silent = isInputSilent_f32();
+  block = AudioStream_F32::receiveWritable_f32();
+  if (!block) return;
+  block->is_silent = was_silent;
+
   // do IIR
   //arm_biquad_cascade_df1_f32(&iir_inst, block->data, block->data, block->length);
   processAudioBlock(block, block);
@@ -46,10 +60,17 @@ int AudioFilterBiquad_F32::processAudioBlock(const audio_block_f32_t *block, aud
 	if (!is_enabled || !block || !block_new) return -1;
 	
 	if (is_bypassed) {
-		for (int i=0; i<block->length; i++) block_new->data[i] = block->data[i]; //copy input to output
+		if (block_new != block) for (int i=0; i<block->length; i++) block_new->data[i] = block->data[i]; //copy input to output
+		block_new->is_silent = block->is_silent;
+	} else if (block->is_silent && isStateQuiet()) {
+		//the filter has rung down, so skip the IIR
+		clearState();
+		for (int i=0; i<block->length; i++) block_new->data[i] = 0.0f;
+		block_new->is_silent = true;
 	} else {
 		// do IIR
 		arm_biquad_cascade_df1_f32(&iir_inst, block->data, block_new->data, block->length);
+		block_new->is_silent = false;
 	}
 
 	//copy info about the block
@@ -25,6 +25,7 @@
 #define IIR_F32_PASSTHRU ((const float32_t *) 1)
 
 #define IIR_MAX_STAGES 4  //meaningless right now
+#define IIR_F32_QUIET_STATE (1.0e-12f)  //filter states smaller than this are treated as zero when the input is silent
 
 class AudioFilterBiquad_F32_settings {
   public:
@@ -102,6 +103,13 @@ class AudioFilterBiquad_F32 : public AudioFilterBase_F32
       enable(false);
     }
 		virtual bool resetState(void) { return initFilter();}  //returns is_ok
+		
+		//With silent input, the filter is skipped once its state has decayed below this (about -240 dB)
+		bool isStateQuiet(void) const {
+			for (int i=0; i < 4*n_stages; i++) if (fabsf(StateF32[i]) > IIR_F32_QUIET_STATE) return false;
+			return true;
+		}
+		void clearState(void) { for (int i=0; i < 4*n_stages; i++) StateF32[i] = 0.0f; }
 		virtual bool initFilter(void) 
 		{
 			bool is_ok = false;
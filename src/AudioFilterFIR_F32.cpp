@@ -18,6 +18,7 @@ bool AudioFilterFIR_F32::begin(const float32_t *cp, const int _n_coeffs, const i
 		//initialize the ARM FIR module
 		arm_fir_init_f32(&fir_inst, n_coeffs, (float32_t *)coeff_p,  &StateF32[0], block_size);
 		configured_block_size = block_size;
+		n_silent_samples = n_coeffs;  //the init cleared the filter's state
 		
 		is_armed = true;
 		is_enabled = true;
@@ -57,6 +58,13 @@ void AudioFilterFIR_F32::update(void)
 		return;
 	}
 
+	// if the input is silent and the filter's state is all zeros, the output is silent, too
+	if (block->is_silent && isStateSilent() && !is_bypassed) {
+		AudioStream_F32::transmit(block);
+		AudioStream_F32::release(block);
+		return;
+	}
+
 	// get a block for the FIR output
 	block_new = AudioStream_F32::allocate_f32();
 	if (block_new == NULL) { AudioStream_F32::release(block); return; } //failed to allocate
@@ -83,9 +91,24 @@ int AudioFilterFIR_F32::processAudioBlock(const audio_block_f32_t *block, audio_
 	
 	if (is_bypassed) {
 		for (int i=0; i<block->length; i++) block_new->data[i] = block->data[i]; //copy input to output
+		block_new->is_silent = block->is_silent;
+	} else if (block->is_silent && isStateSilent()) {
+		//the filter's state is all zeros and it would stay that way, so skip the FIR
+		for (int i=0; i<block->length; i++) block_new->data[i] = 0.0f;
+		block_new->is_silent = true;
 	} else {
 		//apply the FIR
 		arm_fir_f32(&fir_inst, block->data, block_new->data, block->length);
+		block_new->is_silent = false;
+	}
+	
+	//count how many zeros have gone into the filter's state (nothing goes into it while bypassed)
+	if (!is_bypassed) {
+		if (block->is_silent) {
+			n_silent_samples = min(n_silent_samples + block->length, n_coeffs);
+		} else {
+			n_silent_samples = 0;
+		}
 	}
 	
 	//copy info about the block
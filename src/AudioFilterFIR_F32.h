@@ -70,6 +70,8 @@ class AudioFilterFIR_F32 : public AudioFilterBase_F32
 		const float32_t *coeff_p;
 		int n_coeffs;
 		int configured_block_size;
+		int n_silent_samples = 0;  //number of consecutive zeros (from silent blocks) that have been put into the filter's state
+		bool isStateSilent(void) const { return n_silent_samples >= n_coeffs - 1; }
 
 		// ARM DSP Math library filter instance
 		arm_fir_instance_f32 fir_inst;
@@ -1,43 +1,46 @@
 #include "AudioMixer_F32.h"
 
 void AudioMixerBase_F32::update(void) {
-  audio_block_f32_t *in, *out=NULL;
-
-	
-  //get the first available channel
-  unsigned int channel = 0U;
-  while  (channel < N_CHAN) {
-	  out = receiveWritable_f32(channel);
-	  if (out) break;
-	  channel++;
+  audio_block_f32_t *audio_in[MIXER_N_CHAN_MAX];
+
+  //get all of the inputs and see which of them actually contribute to the mix
+  bool any_audio = false;
+  unsigned int n_contributing = 0U, last_contributing = 0U;
+  for (unsigned int channel = 0U; channel < N_CHAN; channel++) {
+    audio_in[channel] = receiveReadOnly_f32(channel);
+    if (audio_in[channel]) {
+      any_audio = true;
+      if (!(audio_in[channel]->is_silent) && (multiplier[channel] != 0.0f)) { n_contributing++; last_contributing = channel; }
+    }
   }
-  if (!out) return;  //there was no data available.  so exit.
-  arm_scale_f32(out->data, multiplier[channel], out->data, audio_block_samples);  //there was data, so scale it per the mier
-  
-  //add in the remaining channels, as available
-  channel++;
-  while  (channel < N_CHAN) {
-    in = receiveReadOnly_f32(channel);
-    if (in) {
-		audio_block_f32_t *tmp = allocate_f32();
-
-		arm_scale_f32(in->data, multiplier[channel], tmp->data, audio_block_samples);
-		arm_add_f32(out->data, tmp->data, out->data, audio_block_samples);
-
-		AudioStream_F32::release(tmp);
-		AudioStream_F32::release(in);
-	} else {
-		//do nothing, this vector is empty
-	}
-	channel++;
+  if (!any_audio) return;  //there was no data available.  so exit.
+
+  if ((n_contributing == 1U) && (multiplier[last_contributing] == 1.0f)) {
+    //only one input is heard, and at unity gain, so simply pass it along
+    AudioStream_F32::transmit(audio_in[last_contributing]);
+  } else {
+    //if nothing is heard, try to pass along one of the silent blocks rather than making a new one
+    audio_block_f32_t *out = NULL;
+    if (n_contributing == 0U) {
+      for (unsigned int channel = 0U; channel < N_CHAN; channel++) {
+        if ((audio_in[channel]) && (audio_in[channel]->is_silent)) { out = audio_in[channel]; break; }
+      }
+    }
+    if (out) {
+      AudioStream_F32::transmit(out);
+    } else {
+      //do the mixing
+      out = allocate_f32();
+      if (out) {
+        processData(audio_in, out);
+        AudioStream_F32::transmit(out);
+        AudioStream_F32::release(out);
+      }
+    }
   }
 
-  if (out) {
-	out->fs_Hz = sample_rate_Hz;
-	out->length = audio_block_samples;
-    AudioStream_F32::transmit(out);
-    AudioStream_F32::release(out);
-  }
+  //release the inputs
+  for (unsigned int channel = 0U; channel < N_CHAN; channel++) AudioStream_F32::release(audio_in[channel]);
 } 
 
 //alternative approach that breaks up the AudioStream management from the actual mixing.
@@ -63,38 +66,55 @@ void AudioMixerBase_F32::update(void) {
 }
 */
 
-//Note audio_in can be read-only as none of the operations are in-place
+//Note audio_in can be read-only as none of the operations are in-place.
+//Inputs that are silent (or that have zero gain) are skipped.  If nothing is heard, audio_out is marked as silent.
 int AudioMixerBase_F32::processData(audio_block_f32_t *audio_in[], audio_block_f32_t *audio_out) {
 	if (audio_out == NULL) return -1;
 	bool firstValidAudio = true;
-	audio_block_f32_t *tmp = allocate_f32();	
-	if (tmp == NULL) return -1;  //no memory!
-	unsigned int num_channels_mixed = 0U;
-	
+	unsigned int num_channels_mixed = 0U, num_channels_heard = 0U;
 	
 	//loop over channels
 	for (unsigned int channel = 0; channel < N_CHAN; channel++) {
 		if (audio_in[channel] != NULL) {  //is it valid audio
-		
 			if (firstValidAudio) {
-				//this is the first audio, so simply scale and have the scaling operation copy directly to audio_out
 				firstValidAudio = false;
-				arm_scale_f32(audio_in[channel]->data, multiplier[channel], audio_out->data, audio_block_samples);
 				audio_out->id = audio_in[channel]->id;
 				audio_out->length = audio_block_samples;
 				audio_out->fs_Hz = sample_rate_Hz;
-
-			} else {
-				//scale the input data (holding in tmp) and then add tmp to the existing audio_out
-				arm_scale_f32(audio_in[channel]->data, multiplier[channel], tmp->data, audio_block_samples);
-				arm_add_f32(audio_out->data, tmp->data, audio_out->data, audio_block_samples);
 			}
 			num_channels_mixed++;
+			
+			//skip the channels that wouldn't change the result
+			const float32_t gain = multiplier[channel];
+			if ((audio_in[channel]->is_silent) || (gain == 0.0f)) continue;
+			
+			if (num_channels_heard == 0U) {
+				//this is the first audio to be heard, so simply scale and have the scaling operation copy directly to audio_out
+				arm_scale_f32(audio_in[channel]->data, gain, audio_out->data, audio_block_samples);
+			} else {
+				//scale and accumulate directly into audio_out (no temporary block needed)
+				const float32_t *in = audio_in[channel]->data;
+				float32_t *out = audio_out->data;
+				int i = 0;
+				for ( ; i <= audio_block_samples-4; i += 4) {
+					out[i]   += gain*in[i];   out[i+1] += gain*in[i+1];
+					out[i+2] += gain*in[i+2]; out[i+3] += gain*in[i+3];
+				}
+				for ( ; i < audio_block_samples; i++) out[i] += gain*in[i];
+			}
+			num_channels_heard++;
 		}
 	}
 	
-	//release the temporarily allocated block
-	AudioStream_F32::release(tmp); 
+	//if there was audio but none of it was heard, the output is silent
+	if (!firstValidAudio) {
+		if (num_channels_heard == 0U) {
+			for (int i=0; i < audio_block_samples; i++) audio_out->data[i] = 0.0f;
+			audio_out->is_silent = true;
+		} else {
+			audio_out->is_silent = false;
+		}
+	}
 	
 	//we're done!
 	return static_cast<int>(num_channels_mixed);
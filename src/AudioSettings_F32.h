@@ -14,8 +14,15 @@ class AudioSettings_F32 {
 			sample_rate_Hz = fs_Hz;
 			audio_block_samples = block_size;
 		}
+		AudioSettings_F32(const float fs_Hz, const int block_size, const int _i2s_bits) {
+			sample_rate_Hz = fs_Hz;
+			audio_block_samples = block_size;
+			i2s_bits = _i2s_bits;
+		}
 		float sample_rate_Hz;
 		int audio_block_samples;
+		int i2s_bits = 16;  //bits per sample on the I2S bus: 16, 20, 24, or 32.  Anything above 16 uses 32-bit DMA transfers.
+		bool small_block_memory = false; //if true, AudioMemory_F32() sizes each block to exactly audio_block_samples (instead of at least 128).  All audio classes must then be given these settings.
 		
 		float get_cpu_load_divide_fac(void);   // return devide_fac for: CPU_percent = n_cycles / divide_fac
 		float cpu_load_percent(const int n);   // convert any CPU load counter into % of total CPU time available
@@ -16,10 +16,22 @@ const int AudioStream_F32::maxInstanceCounting = 120;
 //bool AudioStream_F32::printUpdate = false;
 //bool AudioStream_F32::enableUpdateAll = false;
 int AudioStream_F32::numInstances = 0;
+int AudioStream_F32::numInstancesNotCounted = 0;
 AudioStream_F32* AudioStream_F32::allInstances[AudioStream_F32::maxInstanceCounting];
 bool AudioStream_F32::isAudioProcessing = false;
 
 uint32_t AudioStream_F32::update_counter = 0;
+bool AudioStream_F32::use_flat_dispatch = false;
+bool AudioStream_F32::flat_dispatch_measure_each = true;
+bool AudioStream_F32::flat_dispatch_attached = false;
+
+//software_isr() is what normally runs update_all().  It lives in the Teensy core's AudioStream.cpp but is not
+//part of the core's public API (AudioStream.h only names it as a friend), so it could be renamed in a future
+//core.  We only need it to hand the software interrupt back when flat dispatch is turned off.
+#if defined(TEENSYDUINO)
+  #define FLAT_DISPATCH_AVAILABLE
+  extern void software_isr(void);
+#endif
 
 
 
@@ -46,16 +58,17 @@ void AudioMemory_F32(const int num, const AudioSettings_F32 &settings) {
 void AudioStream_F32::allocate_f32_memory(const unsigned int num, const AudioSettings_F32 &settings) {
 
 	int fail_count = 0;
+	const int full_length = audio_block_f32_t::fullLengthForSettings(settings);
 	for (unsigned int i=0; i < num; i++) {
 		if (i < f32_memory_pool.size()) {
 			//there is already a memory block in the vector
-			if (f32_memory_pool[i]->full_length >= settings.audio_block_samples) {
-				//the existing block is not big enough, so delete and then re-allocate
+			if (f32_memory_pool[i]->full_length != full_length) {
+				//the existing block is not the right size, so delete and then re-allocate
 				delete f32_memory_pool[i]; //delete the audio_block_f32_t that was here
 				f32_memory_pool[i] = new audio_block_f32_t(settings); //create a new one
 				if (f32_memory_pool[i]->data == NULL) fail_count++;
 			} else {
-				//the existing block is big enough, so there is nothing to do
+				//the existing block is already the right size, so there is nothing to do
 			}
 		} else {	
 			//there is no existing memory block, so allocate a new one
@@ -131,6 +144,7 @@ audio_block_f32_t * AudioStream_F32::allocate_f32(void)
   //block = f32_memory_pool + ((index << 5) + (31 - n));
   block = f32_memory_pool[(index << 5) + (31 - n)];
   block->ref_count = 1;
+  block->is_silent = false;  //the new owner hasn't written anything yet
   if (used > f32_memory_used_max) f32_memory_used_max = used;
   //print_ptr->print("alloc_f32:");
   //print_ptr->println((uint32_t)block, HEX);
@@ -222,9 +236,70 @@ audio_block_f32_t * AudioStream_F32::receiveWritable_f32(unsigned int index)
     in->ref_count--;
     in = p;
   }
+  if (in) in->is_silent = false; //the caller is about to change the data, so we can't promise that it stays silent
   return in;
 }
 
+bool AudioStream_F32::setFlatUpdateDispatch(bool enable, bool measure_each_instance) {
+#if !defined(FLAT_DISPATCH_AVAILABLE)
+	if (enable) {
+		print_ptr->println("AudioStream_F32: setFlatUpdateDispatch: *** ERROR ***: only available with the Teensy core.");
+		enable = false;
+	}
+#endif
+	if (enable && (numInstancesNotCounted > 0)) {
+		print_ptr->println("AudioStream_F32: setFlatUpdateDispatch: *** ERROR ***: more than " + String(maxInstanceCounting) + " instances.  Cannot use flat dispatch.");
+		enable = false;
+	}
+	__disable_irq();
+	use_flat_dispatch = enable;
+	flat_dispatch_measure_each = measure_each_instance;
+	
+	//Take over the software interrupt now, whether or not the audio is running yet.  Nothing triggers it
+	//until an I2S (or TDM) object calls update_setup(), which attaches it again anyway.
+	if (use_flat_dispatch) {
+		attachFlatDispatch();
+	} else if (flat_dispatch_attached) {
+#if defined(FLAT_DISPATCH_AVAILABLE)
+		attachInterruptVector(IRQ_SOFTWARE, software_isr);  //give it back to the Teensy Audio library
+#endif
+		flat_dispatch_attached = false;
+	}
+	__enable_irq();
+	return use_flat_dispatch;
+}
+
+void AudioStream_F32::attachFlatDispatch(void) {
+	if (use_flat_dispatch) {
+		attachInterruptVector(IRQ_SOFTWARE, update_all_flat);
+		flat_dispatch_attached = true;
+	}
+}
+
+//Same as the Teensy Audio library's software_isr(), except that it steps through an array instead of a linked list
+void AudioStream_F32::update_all_flat(void) {
+	uint32_t totalcycles = ARM_DWT_CYCCNT;
+	AudioStream_F32 **p = allInstances;
+	AudioStream_F32 **p_end = allInstances + numInstances;
+	if (flat_dispatch_measure_each) {
+		for ( ; p < p_end; p++) {
+			if ((*p)->active) {
+				uint32_t cycles = ARM_DWT_CYCCNT;
+				(*p)->update();
+				cycles = (ARM_DWT_CYCCNT - cycles) >> 6;
+				(*p)->cpu_cycles = cycles;
+				if (cycles > (*p)->cpu_cycles_max) (*p)->cpu_cycles_max = cycles;
+			}
+		}
+	} else {
+		for ( ; p < p_end; p++) if ((*p)->active) (*p)->update();
+	}
+	totalcycles = (ARM_DWT_CYCCNT - totalcycles) >> 6;
+	AudioStream::cpu_cycles_total = totalcycles;
+	if (totalcycles > AudioStream::cpu_cycles_total_max) AudioStream::cpu_cycles_total_max = totalcycles;
+	asm("DSB");
+}
+
 void AudioConnection_F32::connect(void) {
   AudioConnection_F32 *p;
   
@@ -48,7 +48,7 @@ class audio_block_f32_t {
 		}
 		audio_block_f32_t(const AudioSettings_F32 &settings)
 		{
-			full_length = max(MIN_AUDIO_BLOCK_SAMPLES_F32, settings.audio_block_samples);
+			full_length = fullLengthForSettings(settings);
 			data = new float32_t[full_length];
 			fs_Hz = settings.sample_rate_Hz;
 			length = settings.audio_block_samples;
@@ -57,6 +57,13 @@ class audio_block_f32_t {
 		{
 			if (data != NULL) delete [] data;
 		}
+
+		//how long data[] is for the given settings.  Normally, it is never less than MIN_AUDIO_BLOCK_SAMPLES_F32,
+		//but in small-block mode (for low latency), it is exactly the block size so that the pool stays compact.
+		static int fullLengthForSettings(const AudioSettings_F32 &settings) {
+			if (settings.small_block_memory) return max(1, settings.audio_block_samples);
+			return max(MIN_AUDIO_BLOCK_SAMPLES_F32, settings.audio_block_samples);
+		}
 		
 		
 		unsigned char ref_count;
@@ -68,6 +75,7 @@ class audio_block_f32_t {
 		int length = MAX_AUDIO_BLOCK_SAMPLES_F32; // AUDIO_BLOCK_SAMPLES is 128, from AudioStream.h
 		float fs_Hz = AUDIO_SAMPLE_RATE; // AUDIO_SAMPLE_RATE is 44117.64706 from AudioStream.h
 		unsigned long id;
+		bool is_silent = false; //true if every sample is known to be exactly zero (the data must still hold the zeros)
 	private:
 };
 
@@ -105,7 +113,7 @@ class AudioStream_F32 : public AudioStream {
 			for (int i=0; i < n_input_f32; i++) {
 			inputQueue_f32[i] = NULL;
 			}
-				if (numInstances < AudioStream_F32::maxInstanceCounting) allInstances[numInstances++] = this;
+				if (numInstances < AudioStream_F32::maxInstanceCounting) { allInstances[numInstances++] = this; } else { numInstancesNotCounted++; }
 		};
 		//static void initialize_f32_memory(audio_block_f32_t *data, unsigned int num);
 		//static void initialize_f32_memory(audio_block_f32_t *data, unsigned int num, const AudioSettings_F32 &settings);
@@ -139,6 +147,7 @@ class AudioStream_F32 : public AudioStream {
 		//added for tracking and debugging how algorithms are called
 		static AudioStream_F32* allInstances[]; 
 		static int numInstances; 
+		static int numInstancesNotCounted;  //instances created after allInstances[] was already full
 		static const int maxInstanceCounting;
 		//static void printNextUpdatePointers(void); 
 		static void printAllInstances(void);       //step through each AudioStream_F32 instances and print the names (in the order used by update_all()?)
@@ -148,6 +157,14 @@ class AudioStream_F32 : public AudioStream {
 		
 		static void reset_update_counter(void) { update_counter = 0; }
 		static uint32_t update_counter;
+
+		//Flat update dispatch (for small, low-latency blocks).  Instead of the Teensy Audio library walking its linked
+		//list of every AudioStream, update_all() steps through allInstances[] (which is in the same order).  Optionally,
+		//the per-instance CPU measurement can be skipped, too.  This only sees AudioStream_F32 instances, so do not
+		//use it if your sketch also has Teensy (Int16) audio objects.  Returns true if flat dispatch is active.
+		static bool setFlatUpdateDispatch(bool enable, bool measure_each_instance = true);
+		static bool getFlatUpdateDispatch(void) { return use_flat_dispatch; }
+		static void update_all_flat(void);  //run every active instance's update() once, right now.  Normally, only the software interrupt calls this.
 		
 		//added to enable AudioStreamComposite_F32 to put its inputs into another AudioStream_F32 inputs
 		bool putBlockInInputQueue(audio_block_f32_t *block, unsigned int ind);
@@ -163,15 +180,22 @@ class AudioStream_F32 : public AudioStream {
 		unsigned char num_inputs_f32;
 		audio_block_f32_t * receiveReadOnly_f32(unsigned int index = 0);
 		audio_block_f32_t * receiveWritable_f32(unsigned int index = 0);  
+		bool isInputSilent_f32(unsigned int index = 0) const {  //peek at the waiting block without receiving it (receiveWritable_f32 clears the flag)
+			return (index < num_inputs_f32) && (inputQueue_f32[index] != NULL) && (inputQueue_f32[index]->is_silent);
+		}
 		friend class AudioConnection_F32;
 
 		//Control the global update_all() process handled by the underlying AudioStream class.
 		//These affect the *global* audio processing behavior, not the per-instance behavior.
 		//The methods below should only be used with care...like in the I2S classes.
-		static bool update_setup(void) { return isAudioProcessing = AudioStream::update_setup(); }        //setup the global "update" process...not per instance, global! 
+		static bool update_setup(void) { bool ret = AudioStream::update_setup(); isAudioProcessing |= ret; attachFlatDispatch(); return ret; }  //setup the global "update" process...not per instance, global! 
 		static bool update_stop(void) { AudioStream::update_stop(); return isAudioProcessing = false; }   //stop the global "update" process...not per instance, global!
 		static void update_all(void) { update_counter++; AudioStream::update_all(); }											//force th execution of the global "update" process...not per instance, global!
 		static bool isAudioProcessing; //try to keep the same as AudioStream::update_scheduled, which is private and inaccessible to me :(
+		static bool use_flat_dispatch;
+		static bool flat_dispatch_measure_each;
+		static bool flat_dispatch_attached;  //is update_all_flat() currently attached to the software interrupt?
+		static void attachFlatDispatch(void);  //if enabled, take over the software interrupt that runs update_all()
 
 		static void printAllInstances_common(const bool flag_printProcessorUsage, const float processorUsage_divideFac);
 
@@ -282,7 +282,7 @@ class TympanBase : public AudioControlAIC3206, virtual public Print
 
 		int testTympanRev(TympanRev tympanRev);
 		void setupPins(const TympanPins &_pins);
-		void setAudioSettings(const AudioSettings_F32 &_aud_set) { audio_settings = _aud_set; }  //shallow copy
+		void setAudioSettings(const AudioSettings_F32 &_aud_set) { audio_settings = _aud_set; setI2SWordLength(_aud_set.i2s_bits); }  //shallow copy
 		void forceBTtoDataMode(bool state);
 
 		//TympanPins getTympanPins(void) { return &pins; }
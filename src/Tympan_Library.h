@@ -11,6 +11,8 @@
 #include "AudioCalcGainDecWDRC_F32.h"
 #include "AudioCalcLeq_F32.h"
 #include "AudioCalcLevel_F32.h"
+#include "AudioCalcVAD_F32.h"
+#include "AudioAnalysisSpectrum_FD_F32.h"
 #include "AudioConfigFIRFilter_F32.h"
 #include "AudioConfigFIRFilterBank_F32.h"
 #include "AudioConfigIIRFilterBank_F32.h"
@@ -25,12 +27,17 @@
 #include "AudioEffectCompressor_F32.h"
 #include "AudioEffectDelay_F32.h"
 #include "AudioEffectFormantShift_FD_F32.h"
+#include "AudioEffectFormantShiftEnv_FD_F32.h"
+#include "AudioEffectFreqComp_FD_F32.h"
 #include "AudioEffectFreqShift_FD_F32.h"
 #include "AudioEffectMultiBandWDRC_F32.h"
 #include "AudioEffectNoiseReduction_FD_F32.h"
 #include "AudioEffectPitchShift_FD_F32.h"
+#include "AudioEffectPitchShiftPV_FD_F32.h"
 #include "AudioFeedbackCancelNLMS_F32.h"
 #include "AudioFeedbackCancelNFXLMS_F32.h"
+#include "AudioFeedbackCancelPBFDAF_F32.h"
+#include "AudioFeedbackCancelMultiNLMS_F32.h"
 #include "AudioFilterbank_F32.h"
 #include "AudioFilterBiquad_F32.h"
 #include "AudioFilterFIR_F32.h"
@@ -65,6 +72,7 @@
 #include "input_i2s_F32.h"
 #include "input_i2s_quad_F32.h"
 #include "input_i2s_hex_F32.h"
+#include "input_tdm_F32.h"
 #include "AudioSDPlayer_F32.h"
 #include "AudioSDPlayerTeensy_F32.h"
 #include "AudioSDWriter_F32.h"
@@ -85,6 +93,7 @@
 #include "TympanStateBase.h"
 #include "output_i2s_F32.h"
 #include "output_i2s_quad_F32.h"
+#include "output_tdm_F32.h"
 //include "USB_Audio_F32.h"
 #include "BLE/ble.h"
 #include "BLE/ble_BC127.h"
@@ -243,6 +243,7 @@ bool AudioControlAIC3206::enable(void) {
   aic_initDAC(); //delay(10);
 
   aic_readPage(0, 27); // check a specific register - a register read test
+  aic_is_enabled = true;
 
   if (debugToSerial) Serial.println("AIC3206 enable done");
 
@@ -931,10 +932,32 @@ void AudioControlAIC3206::aic_init() {
 
   // !!!!!!!!! The below writes are from WHF/CHA - probably don't need?
   // aic_writePage(1, 1, 10); // 10 = 0b00001010 // weakly connect AVDD to DVDD.  Activate charge pump
- aic_writePage(0, 27, 0x01 | AIC_CLK_DIR | (AIC_BITS == 32 ? 0x30 : 0)); //Page 0, 0x1B
+ aic_writePage(0, 27, aic_interfaceSetting()); //Page 0, 0x1B
   // aic_writePage(0, 28, 0); // 0x1C
 }
 
+//Page 0, Register 27: I2S interface, word length (bits D5-D4), and clock directions.  The Teensy always
+//uses 32-bit slots, so any word length fits.  Longer words just fill in more of the low bits of each slot.
+uint8_t AudioControlAIC3206::aic_interfaceSetting(void) {
+  uint8_t word_length_code = 0;  //16 bits
+  switch (i2s_word_length_bits) {
+    case 20: word_length_code = 0x10; break;
+    case 24: word_length_code = 0x20; break;
+    case 32: word_length_code = 0x30; break;
+  }
+  return 0x01 | AIC_CLK_DIR | word_length_code;
+}
+
+int AudioControlAIC3206::setI2SWordLength(int bits) {
+  if ((bits != 16) && (bits != 20) && (bits != 24) && (bits != 32)) {
+    Serial.println(F("AudioControlAIC3206: setI2SWordLength: *** ERROR ***: bits must be 16, 20, 24, or 32."));
+    return i2s_word_length_bits;
+  }
+  i2s_word_length_bits = bits;
+  if (aic_is_enabled) aic_writePage(0, 27, aic_interfaceSetting()); //otherwise, it is applied by enable()
+  return i2s_word_length_bits;
+}
+
 unsigned int AudioControlAIC3206::aic_readPage(uint8_t page, uint8_t reg)
 {
   unsigned int val;
@@ -120,6 +120,8 @@ public:
 	void muteLineOut(bool state);
 	bool enableDigitalMicInputs(void) { return enableDigitalMicInputs(true); }
 	bool enableDigitalMicInputs(bool desired_state);
+	int setI2SWordLength(int bits);  //16, 20, 24, or 32 bits per sample on the I2S bus.  Can be called before or after enable().
+	int getI2SWordLength(void) { return i2s_word_length_bits; }
 
 protected:
   TwoWire *myWire = &Wire;  //from Wire.h
@@ -147,6 +149,9 @@ protected:
   void convertCoeff_f32_to_i32(float *coeff_f32, int32_t *coeff_i32, int ncoeff);
 
   bool outputSelect_firstTime = true;
+  int i2s_word_length_bits = 16;
+  bool aic_is_enabled = false;
+  uint8_t aic_interfaceSetting(void);  //value for page 0, register 27
 
 };
 
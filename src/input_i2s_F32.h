@@ -49,9 +49,66 @@ class AudioInputI2SBase_F32 : public AudioStream_F32 {
 		virtual void begin(void) = 0;
 		virtual int get_isOutOfMemory(void) { return flag_out_of_memory; }
 		virtual void clear_isOutOfMemory(void) { flag_out_of_memory = 0; }
+
+		//De-interleave n_frames of raw I2S data (N_SLOTS interleaved channels of int16 or int32) into the float
+		//destinations (one per slot, in slot order) while scaling to +/-1.0.  Two frames are handled per
+		//pass and the slot loop is unrolled by the compiler, so each sample is one load, one convert,
+		//one multiply, and one store.
+		template <int N_SLOTS, typename T>
+		static void deinterleave_to_f32(const T *src, float32_t *dest[], const int n_frames, const float32_t scale) {
+			int i = 0;
+			for ( ; i+2 <= n_frames; i += 2) {
+				for (int k=0; k < N_SLOTS; k++) {
+					dest[k][i]   = scale * (float32_t)src[k];
+					dest[k][i+1] = scale * (float32_t)src[N_SLOTS+k];
+				}
+				src += 2*N_SLOTS;
+			}
+			for ( ; i < n_frames; i++) {
+				for (int k=0; k < N_SLOTS; k++) dest[k][i] = scale * (float32_t)src[k];
+				src += N_SLOTS;
+			}
+		}
+		template <int N_SLOTS>
+		static void deinterleave_i16_to_f32(const int16_t *src, float32_t *dest[], const int n_frames) {
+			deinterleave_to_f32<N_SLOTS,int16_t>(src, dest, n_frames, 1.0f/32767.0f); //same as scale_i16_to_f32()
+		}
+		template <int N_SLOTS>
+		static void deinterleave_i32_to_f32(const int32_t *src, float32_t *dest[], const int n_frames) {
+			deinterleave_to_f32<N_SLOTS,int32_t>(src, dest, n_frames, 1.0f/2147483647.0f); //same as scale_i32_to_f32()
+		}
+
+		//Same as above, but only for the n_used slots listed in slots[] (dest[] is still indexed by slot number).
+		//Used by the TDM inputs so that disabled slots are never touched.
+		template <int N_SLOTS, typename T>
+		static void deinterleave_slots_to_f32(const T *src, float32_t *dest[], const uint8_t slots[], const int n_used, const int n_frames, const float32_t scale) {
+			if (n_used == N_SLOTS) { deinterleave_to_f32<N_SLOTS,T>(src, dest, n_frames, scale); return; }
+			for (int k=0; k < n_used; k++) {
+				const T *s = src + slots[k];
+				float32_t *d = dest[slots[k]];
+				for (int i=0; i < n_frames; i++) { d[i] = scale * (float32_t)(*s); s += N_SLOTS; }
+			}
+		}
+
+		//With 32-bit transfers, the full 32-bit I2S slot is moved by the DMA (so 24-bit data from the codec
+		//is kept) instead of just its upper 16 bits.  Set via AudioSettings_F32::i2s_bits or via begin(bool).
+		static bool get_isTransfer32bit(void) { return transfer_32bit; }
 	protected:
+		//The ISR copies the raw (still interleaved) samples out of the DMA buffer into one of two staging
+		//blocks and then hands the completed block to update(), which does the conversion to float.
+		static bool allocateRawStaging(int16_t *&staging, int &staging_len, const int n_int16_per_block) {
+			if (staging_len < 2*n_int16_per_block) {
+				delete[] staging;
+				staging = new int16_t[2*n_int16_per_block];
+				staging_len = (staging == NULL) ? 0 : 2*n_int16_per_block;
+				for (int i=0; i < staging_len; i++) staging[i] = 0;
+			}
+			if (staging == NULL) Serial.println(F("AudioInputI2SBase_F32: allocateRawStaging: *** ERROR ***: could not allocate the staging memory."));
+			return (staging != NULL);
+		}
 		static float sample_rate_Hz;
 		static int audio_block_samples;
+		static bool transfer_32bit;
 		static int flag_out_of_memory;
 		static unsigned long update_counter;
 	private:
@@ -71,12 +128,14 @@ public:
 		//Serial.println("AudioInputI2S_F32: constructor 2...");
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		setInstanceName();
 		begin(); 
 	}
- 	AudioInputI2S_F32(const AudioSettings_F32 &settings, uint32_t *rx_buff) : AudioInputI2SBase_F32() { 
+ 	AudioInputI2S_F32(const AudioSettings_F32 &settings, uint32_t *rx_buff) : AudioInputI2SBase_F32() { //rx_buff must hold audio_block_samples uint32s (16-bit) or 2*audio_block_samples (32-bit)
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		i2s_rx_buffer = rx_buff;
 		setInstanceName();
 		begin(); 
@@ -100,10 +159,10 @@ protected:
 	static void isr_32(void);
 	static void isr(void);
 	virtual void update_1chan(int, audio_block_f32_t *&);
-private:
-	static audio_block_f32_t *block_left_f32;
-	static audio_block_f32_t *block_right_f32;
-	static uint16_t block_offset;
+	static int16_t *raw_staging;           //two blocks of raw interleaved samples, filled alternately by the ISR
+	static int raw_staging_len;            //total length of raw_staging (int16 values)
+	static int raw_fill_ind;               //which staging block the ISR is filling (0 or 1)
+	static const int16_t * volatile raw_ready; //the staging block that is ready for update(), or NULL
 };
 
 class AudioInputI2Sslave_F32 : public AudioInputI2S_F32
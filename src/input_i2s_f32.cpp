@@ -39,11 +39,12 @@
 //DMAMEM __attribute__((aligned(32))) static uint32_t i2s_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32]; //good for 16-bit audio samples coming in from teh AIC.  32-bit transfers will need this to be bigger.
 //DMAMEM __attribute__((aligned(32)))
 //static uint32_t i2s_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32]; //good for 16-bit audio samples coming in from teh AIC.  32-bit transfers will need this to be bigger.
-uint32_t i2s_default_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32];
+uint32_t i2s_default_rx_buffer[2*MAX_AUDIO_BLOCK_SAMPLES_F32];  //big enough for 32-bit transfers
 uint32_t * AudioInputI2S_F32::i2s_rx_buffer = i2s_default_rx_buffer;
-audio_block_f32_t * AudioInputI2S_F32::block_left_f32 = NULL;
-audio_block_f32_t * AudioInputI2S_F32::block_right_f32 = NULL;
-uint16_t AudioInputI2S_F32::block_offset = 0;
+int16_t * AudioInputI2S_F32::raw_staging = NULL;
+int AudioInputI2S_F32::raw_staging_len = 0;
+int AudioInputI2S_F32::raw_fill_ind = 0;
+const int16_t * volatile AudioInputI2S_F32::raw_ready = NULL;
 bool AudioInputI2S_F32::update_responsibility = false;
 DMAChannel AudioInputI2S_F32::dma(false);
 
@@ -52,21 +53,21 @@ unsigned long AudioInputI2SBase_F32::update_counter = 0;
 
 float AudioInputI2SBase_F32::sample_rate_Hz = AUDIO_SAMPLE_RATE;
 int AudioInputI2SBase_F32::audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32; //set to default, gets set again later during initialization
+bool AudioInputI2SBase_F32::transfer_32bit = false;
 
 
-//#for 16-bit transfers
-#define I2S_BUFFER_TO_USE_BYTES (AudioOutputI2S_F32::audio_block_samples*sizeof(i2s_rx_buffer[0]))
-
-//#for 32-bit transfers
-//#define I2S_BUFFER_TO_USE_BYTES (AudioOutputI2S_F32::audio_block_samples*2*sizeof(i2s_rx_buffer[0]))
+//for 16-bit transfers, L+R share one uint32.  For 32-bit transfers, they each get one.
+#define I2S_BUFFER_TO_USE_BYTES (AudioOutputI2S_F32::audio_block_samples*sizeof(i2s_rx_buffer[0])*(transfer_32bit ? 2 : 1))
 	
 
 void AudioInputI2S_F32::begin(void) {
-	bool transferUsing32bit = false;
-	begin(transferUsing32bit);
+	begin(transfer_32bit); //defaults to false, unless set by the AudioSettings_F32 given to the constructor
 }
 
 void AudioInputI2S_F32::begin(bool transferUsing32bit) {
+	transfer_32bit = transferUsing32bit;
+	allocateRawStaging(raw_staging, raw_staging_len, 2*audio_block_samples*(transfer_32bit ? 2 : 1)); //L and R per sample
+	raw_fill_ind = 0;  raw_ready = NULL;
 	dma.begin(true); // Allocate the DMA channel first
 
 	AudioOutputI2S_F32::sample_rate_Hz = sample_rate_Hz; //these were given in the AudioSettings in the contructor
@@ -77,22 +78,25 @@ void AudioInputI2S_F32::begin(bool transferUsing32bit) {
 
 	// TODO: should we set & clear the I2S_RCSR_SR bit here?
 	AudioOutputI2S_F32::config_i2s(transferUsing32bit);
+	const int xfer_bytes = transfer_32bit ? 4 : 2;  //bytes per DMA transfer (one sample)
+	const int xfer_size = transfer_32bit ? 2 : 1;   //DMA size code: 1 = 16-bit, 2 = 32-bit
 
 #if defined(KINETISK)
 	CORE_PIN13_CONFIG = PORT_PCR_MUX(4); // pin 13, PTC5, I2S0_RXD0
-	dma.TCD->SADDR = (void *)((uint32_t)&I2S0_RDR0 + 2);  //From Teensy Audio Library...but why "+ 2"  (Chip 2020-10-31)
+	//The I2S slots are 32 bits.  For 16-bit transfers, only read the upper half of the slot (hence the "+ 2").
+	dma.TCD->SADDR = (void *)((uint32_t)&I2S0_RDR0 + (transfer_32bit ? 0 : 2));
 	dma.TCD->SOFF = 0;
-	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
-	dma.TCD->NBYTES_MLNO = 2;
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
+	dma.TCD->NBYTES_MLNO = xfer_bytes;
 	dma.TCD->SLAST = 0;
 	dma.TCD->DADDR = i2s_rx_buffer;
-	dma.TCD->DOFF = 2;
+	dma.TCD->DOFF = xfer_bytes;
 	//dma.TCD->CITER_ELINKNO = sizeof(i2s_rx_buffer) / 2;  //original from Teensy Audio Library
-	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	//dma.TCD->DLASTSGA = -sizeof(i2s_rx_buffer);  //original from Teensy Audio Library
 	dma.TCD->DLASTSGA = -I2S_BUFFER_TO_USE_BYTES;
 	//dma.TCD->BITER_ELINKNO = sizeof(i2s_rx_buffer) / 2;  //original from Teensy Audio Library
-	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
 	dma.triggerAtHardwareEvent(DMAMUX_SOURCE_I2S0_RX);
 
@@ -103,19 +107,20 @@ void AudioInputI2S_F32::begin(bool transferUsing32bit) {
 	CORE_PIN8_CONFIG  = 3;  //1:RX_DATA0
 	IOMUXC_SAI1_RX_DATA0_SELECT_INPUT = 2;
 	
-	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + 2);
+	//The I2S slots are 32 bits.  For 16-bit transfers, only read the upper half of the slot (hence the "+ 2").
+	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + (transfer_32bit ? 0 : 2));
 	dma.TCD->SOFF = 0;
-	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
-	dma.TCD->NBYTES_MLNO = 2;
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
+	dma.TCD->NBYTES_MLNO = xfer_bytes;
 	dma.TCD->SLAST = 0;
 	dma.TCD->DADDR = i2s_rx_buffer;
-	dma.TCD->DOFF = 2;
+	dma.TCD->DOFF = xfer_bytes;
 	//dma.TCD->CITER_ELINKNO = sizeof(i2s_rx_buffer) / 2; //original from Teensy Audio Library
-	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	//dma.TCD->DLASTSGA = -sizeof(i2s_rx_buffer); //original from Teensy Audio Library
 	dma.TCD->DLASTSGA = -I2S_BUFFER_TO_USE_BYTES;
 	//dma.TCD->BITER_ELINKNO = sizeof(i2s_rx_buffer) / 2; //original from Teensy Audio Library
-	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
 	dma.triggerAtHardwareEvent(DMAMUX_SOURCE_SAI1_RX);
 
@@ -271,55 +276,43 @@ void AudioInputI2S_F32::begin(bool transferUsing32bit) {
 
 void AudioInputI2S_F32::isr(void)
 {
-	uint32_t daddr, offset;
-	const int16_t *src, *end;
-	//int16_t *dest_left, *dest_right;
-	//audio_block_t *left, *right;
-	float32_t *dest_left_f32, *dest_right_f32;
-	audio_block_f32_t *left_f32, *right_f32;
+	uint32_t daddr;
+	const uint32_t *src;
+	int half;
 
 #if defined(KINETISK) || defined(__IMXRT1062__)
 	daddr = (uint32_t)(dma.TCD->DADDR);
 #endif
 	dma.clearInterrupt();
-	//Serial.println("isr");
 
 	//if (daddr < (uint32_t)i2s_rx_buffer + sizeof(i2s_rx_buffer) / 2) { //original Teensy Audio Library
 	if (daddr < (uint32_t)i2s_rx_buffer + I2S_BUFFER_TO_USE_BYTES / 2) {
 		// DMA is receiving to the first half of the buffer
 		// need to remove data from the second half
-		//src = (int16_t *)&i2s_rx_buffer[AUDIO_BLOCK_SAMPLES/2]; //original Teensy Audio Library
-		//end = (int16_t *)&i2s_rx_buffer[AUDIO_BLOCK_SAMPLES]; //original Teensy Audio Library
-		src = (int16_t *)&i2s_rx_buffer[audio_block_samples/2];
-		end = (int16_t *)&i2s_rx_buffer[audio_block_samples];			
-		update_counter++; //let's increment the counter here to ensure that we get every ISR resulting in audio
-		if (AudioInputI2S_F32::update_responsibility) AudioStream_F32::update_all();
+		src = (uint32_t *)((uint32_t)i2s_rx_buffer + I2S_BUFFER_TO_USE_BYTES / 2);
+		half = 1;
 	} else {
 		// DMA is receiving to the second half of the buffer
 		// need to remove data from the first half
-		src = (int16_t *)&i2s_rx_buffer[0];
-		//end = (int16_t *)&i2s_rx_buffer[AUDIO_BLOCK_SAMPLES/2]; //original Teensy Audio Library
-		end = (int16_t *)&i2s_rx_buffer[audio_block_samples/2];
+		src = &i2s_rx_buffer[0];
+		half = 0;
 	}
-	left_f32 = AudioInputI2S_F32::block_left_f32;
-	right_f32 = AudioInputI2S_F32::block_right_f32;
-	if (left_f32 != NULL && right_f32 != NULL) {
-		offset = AudioInputI2S_F32::block_offset;
-		//if (offset <= (uint32_t)(AUDIO_BLOCK_SAMPLES/2)) { //original Teensy Audio Library
-		if (offset <= ((uint32_t) audio_block_samples/2)) {
-			dest_left_f32 = &(left_f32->data[offset]);
-			dest_right_f32 = &(right_f32->data[offset]);
-			//AudioInputI2S_F32::block_offset = offset + AUDIO_BLOCK_SAMPLES/2; //original Teensy Audio Library
-			AudioInputI2S_F32::block_offset = offset + audio_block_samples/2;
-			do {
-				//Serial.println(*src);
-				//n = *src++;
-				//*dest_left++ = (int16_t)n;
-				//*dest_right++ = (int16_t)(n >> 16);
-				*dest_left_f32++ = (float32_t) *src++;
-				*dest_right_f32++ = (float32_t) *src++;
-			} while (src < end);
+	const bool have_staging = (raw_staging != NULL); //if not, skip the copy...but still keep the audio system running
+
+	//Only copy the raw samples here.  The de-interleaving and the conversion to float are done in update().
+	const int n16_per_block = 2*audio_block_samples*(transfer_32bit ? 2 : 1); //block length in int16 units
+	if (have_staging) {
+		int16_t *dest = raw_staging + raw_fill_ind*n16_per_block + half*(n16_per_block/2);
+		memcpy(dest, src, I2S_BUFFER_TO_USE_BYTES / 2);
+	}
+	if (half == 1) {
+		//the staging block is complete, so hand it to update() and start filling the other one
+		if (have_staging) {
+			raw_ready = raw_staging + raw_fill_ind*n16_per_block;
+			raw_fill_ind = 1 - raw_fill_ind;
 		}
+		update_counter++; //let's increment the counter here to ensure that we get every ISR resulting in audio
+		if (AudioInputI2S_F32::update_responsibility) AudioStream_F32::update_all();
 	}
 }
 
@@ -495,10 +488,6 @@ void AudioInputI2S_F32::scale_i32_to_f32( float32_t *p_i32, float32_t *p_f32, in
  void AudioInputI2S_F32::update_1chan(int chan, audio_block_f32_t *&out_f32) {
 	 if (!out_f32) return;
 	 
-	//scale the float values so that the maximum possible audio values span -1.0 to + 1.0
-	//scale_i32_to_f32(out_f32->data, out_f32->data, audio_block_samples);
-	scale_i16_to_f32(out_f32->data, out_f32->data, audio_block_samples);
-
 	//prepare to transmit by setting the update_counter (which helps tell if data is skipped or out-of-order)
 	out_f32->id = update_counter;
 	out_f32->fs_Hz = sample_rate_Hz;
@@ -514,58 +503,36 @@ void AudioInputI2S_F32::scale_i32_to_f32( float32_t *p_i32, float32_t *p_f32, in
 void AudioInputI2S_F32::update(void)
 {
 	static bool flag_beenSuccessfullOnce = false;
-	audio_block_f32_t *new_left=NULL, *new_right=NULL, *out_left=NULL, *out_right=NULL;
 	
-	new_left = AudioStream_F32::allocate_f32();
-	new_right = AudioStream_F32::allocate_f32();
-	if ((!new_left) || (!new_right)) {
+	//take the raw block that the ISR has finished (if any)
+	__disable_irq();
+	const int16_t *src = raw_ready;
+	raw_ready = NULL;
+	__enable_irq();
+	if (src == NULL) return;  //the DMA has not finished a new block
+	
+	audio_block_f32_t *out_left = AudioStream_F32::allocate_f32();
+	audio_block_f32_t *out_right = AudioStream_F32::allocate_f32();
+	if ((!out_left) || (!out_right)) {
 		//ran out of memory.  Clear and return!
-		if (new_left) AudioStream_F32::release(new_left);
-		if (new_right) AudioStream_F32::release(new_right);
-		new_left = NULL;  new_right = NULL;
+		if (out_left) AudioStream_F32::release(out_left);
+		if (out_right) AudioStream_F32::release(out_right);
 		flag_out_of_memory = 1;
 		if (flag_beenSuccessfullOnce) Serial.println("Input_I2S_F32: update(): WARNING!!! Out of Memory.");
-	} else {
-		flag_beenSuccessfullOnce = true;
+		return;
 	}
+	flag_beenSuccessfullOnce = true;
 	
-	__disable_irq();
-	if (block_offset >= audio_block_samples) {
-		// the DMA filled 2 blocks, so grab them and get the
-		// 2 new blocks to the DMA, as quickly as possible
-		out_left = block_left_f32;
-		block_left_f32 = new_left;
-		out_right = block_right_f32;
-		block_right_f32 = new_right;
-		block_offset = 0;
-		__enable_irq();
-		
-		//update_counter++; //I chose to update it in the ISR instead.
-		update_1chan(0,out_left);  //uses audio_block_samples and update_counter
-		update_1chan(1,out_right);  //uses audio_block_samples and update_counter
-		
-		
-	} else if (new_left != NULL) {
-		// the DMA didn't fill blocks, but we allocated blocks
-		if (block_left_f32 == NULL) {
-			// the DMA doesn't have any blocks to fill, so
-			// give it the ones we just allocated
-			block_left_f32 = new_left;
-			block_right_f32 = new_right;
-			block_offset = 0;
-			__enable_irq();
-		} else {
-			// the DMA already has blocks, doesn't need these
-			__enable_irq();
-			AudioStream_F32::release(new_left);
-			AudioStream_F32::release(new_right);
-		}
+	//de-interleave and scale to +/-1.0
+	float32_t *dest[2] = {out_left->data, out_right->data};
+	if (transfer_32bit) {
+		deinterleave_i32_to_f32<2>((const int32_t *)src, dest, audio_block_samples);
 	} else {
-		// The DMA didn't fill blocks, and we could not allocate
-		// memory... the system is likely starving for memory!
-		// Sadly, there's nothing we can do.
-		__enable_irq();
+		deinterleave_i16_to_f32<2>(src, dest, audio_block_samples);
 	}
+	
+	update_1chan(0,out_left);  //uses audio_block_samples and update_counter
+	update_1chan(1,out_right);  //uses audio_block_samples and update_counter
 }
 
 /******************************************************************/
@@ -573,6 +540,9 @@ void AudioInputI2S_F32::update(void)
 
 void AudioInputI2Sslave_F32::begin(void)
 {
+	transfer_32bit = false;  //the slave has only been set up for 16-bit transfers
+	allocateRawStaging(raw_staging, raw_staging_len, 2*audio_block_samples); //two int16 values (L and R) per sample
+	raw_fill_ind = 0;  raw_ready = NULL;
 	dma.begin(true); // Allocate the DMA channel first
 
 	//block_left_1st = NULL;
@@ -37,15 +37,12 @@
 
 
 //DMAMEM __attribute__((aligned(32))) static uint32_t i2s_rx_buffer[AUDIO_BLOCK_SAMPLES*3]; //Teensy original
-DMAMEM __attribute__((aligned(32))) static uint32_t i2s_default_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32/2*6]; //The "divide by 2" is because we're fitting 16-bit samples into 32-bit slots
+DMAMEM __attribute__((aligned(32))) static uint32_t i2s_default_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32*6]; //big enough for 32-bit transfers (16-bit transfers fit two samples per slot)
 uint32_t *AudioInputI2SHex_F32::i2s_rx_buffer = i2s_default_rx_buffer;
-audio_block_f32_t * AudioInputI2SHex_F32::block_ch1 = NULL;
-audio_block_f32_t * AudioInputI2SHex_F32::block_ch2 = NULL;
-audio_block_f32_t * AudioInputI2SHex_F32::block_ch3 = NULL;
-audio_block_f32_t * AudioInputI2SHex_F32::block_ch4 = NULL;
-audio_block_f32_t * AudioInputI2SHex_F32::block_ch5 = NULL;
-audio_block_f32_t * AudioInputI2SHex_F32::block_ch6 = NULL;
-uint32_t AudioInputI2SHex_F32::block_offset = 0;
+int16_t * AudioInputI2SHex_F32::raw_staging = NULL;
+int AudioInputI2SHex_F32::raw_staging_len = 0;
+int AudioInputI2SHex_F32::raw_fill_ind = 0;
+const int16_t * volatile AudioInputI2SHex_F32::raw_ready = NULL;
 bool AudioInputI2SHex_F32::update_responsibility = false;
 DMAChannel AudioInputI2SHex_F32::dma(false);
 
@@ -53,8 +50,8 @@ DMAChannel AudioInputI2SHex_F32::dma(false);
 //float AudioInputI2SHex_F32::sample_rate_Hz = AUDIO_SAMPLE_RATE;
 //int AudioInputI2SHex_F32::audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32;
 
-//for 16-bit transfers?
-#define I2S_BUFFER_TO_USE_BYTES ((AudioInputI2SHex_F32::audio_block_samples)*6*(sizeof(i2s_rx_buffer[0])/2))
+//for 16-bit transfers, two samples share each uint32.  For 32-bit transfers, each gets its own.
+#define I2S_BUFFER_TO_USE_BYTES ((AudioInputI2SHex_F32::audio_block_samples)*6*(sizeof(i2s_rx_buffer[0])/2)*(transfer_32bit ? 2 : 1))
 
 
 #if defined(__IMXRT1062__)
@@ -62,6 +59,8 @@ DMAChannel AudioInputI2SHex_F32::dma(false);
 void AudioInputI2SHex_F32::begin(void)
 {
 	//Serial.println("AudioInputI2SHex_F32: begin: starting...");
+	allocateRawStaging(raw_staging, raw_staging_len, 6*audio_block_samples*(transfer_32bit ? 2 : 1)); //six values per sample
+	raw_fill_ind = 0;  raw_ready = NULL;
 	dma.begin(true); // Allocate the DMA channel first
 
 	//AudioOutputI2SHex_F32::sample_rate_Hz = sample_rate_Hz; //these were given in the AudioSettings in the contructor
@@ -95,15 +94,19 @@ void AudioInputI2SHex_F32::begin(void)
 			IOMUXC_SAI1_RX_DATA3_SELECT_INPUT = 1; // GPIO_B0_12_ALT3, pg 875
 			break;
 	}
-	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + 2 + pinoffset * 4);
+	//Each minor loop reads one sample from each of the three data lines (RDR0-RDR2).  The I2S slots are
+	//32 bits.  For 16-bit transfers, only read the upper half of each slot (hence the "+ 2").
+	const int xfer_bytes = transfer_32bit ? 4 : 2;  //bytes per sample
+	const int xfer_size = transfer_32bit ? 2 : 1;   //DMA size code: 1 = 16-bit, 2 = 32-bit
+	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + (transfer_32bit ? 0 : 2) + pinoffset * 4);
 	dma.TCD->SOFF = 4;
-	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
 	dma.TCD->NBYTES_MLOFFYES = DMA_TCD_NBYTES_SMLOE |
-		DMA_TCD_NBYTES_MLOFFYES_MLOFF(-12) |  // 4 samples @ 2 bytes each?
-		DMA_TCD_NBYTES_MLOFFYES_NBYTES(6);    
-	dma.TCD->SLAST = -12;  //6 samples @ 2 bytes each?
+		DMA_TCD_NBYTES_MLOFFYES_MLOFF(-12) |  // back to RDR0 (three 4-byte registers)
+		DMA_TCD_NBYTES_MLOFFYES_NBYTES(3*xfer_bytes);    
+	dma.TCD->SLAST = -12;  //back to RDR0
 	dma.TCD->DADDR = i2s_rx_buffer;
-	dma.TCD->DOFF = 2;
+	dma.TCD->DOFF = xfer_bytes;
 	
 //	dma.TCD->CITER_ELINKNO = AUDIO_BLOCK_SAMPLES * 2;  //original from Teensy library (hex.  assumes 16 bit transfers?)
 //	dma.TCD->DLASTSGA = -sizeof(i2s_rx_buffer);        //original from Teensy library (hex)
@@ -125,9 +128,9 @@ void AudioInputI2SHex_F32::begin(void)
 
 void AudioInputI2SHex_F32::isr(void)
 {
-	uint32_t daddr, offset;
+	uint32_t daddr;
 	const int16_t *src;
-	float32_t *dest1, *dest2, *dest3, *dest4, *dest5, *dest6;
+	int half;
 
 	//digitalWriteFast(3, HIGH);
 	daddr = (uint32_t)(dma.TCD->DADDR);
@@ -139,171 +142,80 @@ void AudioInputI2SHex_F32::isr(void)
 		// need to remove data from the second half
 		//src = (int16_t *)((uint32_t)i2s_rx_buffer + sizeof(i2s_rx_buffer) / 2);
 		src = (int16_t *)((uint32_t)i2s_rx_buffer + I2S_BUFFER_TO_USE_BYTES / 2); 
-		//if (update_responsibility) update_all();
-		if (AudioInputI2SHex_F32::update_responsibility) AudioStream_F32::update_all();
+		half = 1;
 	} else {
 		// DMA is receiving to the second half of the buffer
 		// need to remove data from the first half
 		src = (int16_t *)&i2s_rx_buffer[0];
+		half = 0;
 	}
+	const bool have_staging = (raw_staging != NULL); //if not, skip the copy...but still keep the audio system running
 	
-	//This block of code only copies the data into F32 buffers but leaves the scaling at +/-32767.0
-	//which will then be scaled in the update() method instead of here
-	if (block_ch1 && block_ch2 && block_ch3 && block_ch4 && block_ch5 && block_ch6) {
-		offset = AudioInputI2SHex_F32::block_offset;
-		if (offset <= (uint32_t)(audio_block_samples/2)) {
-			//arm_dcache_delete((void*)src, sizeof(i2s_rx_buffer) / 2);
-			arm_dcache_delete((void*)src, I2S_BUFFER_TO_USE_BYTES/2);
-			
-			//block_offset = offset + AUDIO_BLOCK_SAMPLES/2;
-			AudioInputI2SHex_F32::block_offset = offset + audio_block_samples/2;
-			dest1 = &(block_ch1->data[offset]);
-			dest2 = &(block_ch2->data[offset]);
-			dest3 = &(block_ch3->data[offset]);
-			dest4 = &(block_ch4->data[offset]);
-			dest5 = &(block_ch5->data[offset]);
-			dest6 = &(block_ch6->data[offset]);
-			for (int i=0; i < audio_block_samples/2; i++) {
-				*dest1++ = ((float32_t) *src++); //chan 1
-				*dest3++ = ((float32_t) *src++); //chan 3!
-				*dest5++ = ((float32_t) *src++); //chan 5!
-				*dest2++ = ((float32_t) *src++); //chan 2
-				*dest4++ = ((float32_t) *src++); //chan 4!
-				*dest6++ = ((float32_t) *src++); //chan 6!
-			}
+	//Only copy the raw samples here.  The de-interleaving (note the order!!! Chan 1, 3, 5, 2, 4, 6)
+	//and the conversion to float are done in update() instead.
+	arm_dcache_delete((void*)src, I2S_BUFFER_TO_USE_BYTES/2);
+	const int n16_per_block = 6*audio_block_samples*(transfer_32bit ? 2 : 1); //block length in int16 units
+	if (have_staging) {
+		int16_t *dest = raw_staging + raw_fill_ind*n16_per_block + half*(n16_per_block/2);
+		memcpy(dest, src, I2S_BUFFER_TO_USE_BYTES / 2);
+	}
+	if (half == 1) {
+		//the staging block is complete, so hand it to update() and start filling the other one
+		if (have_staging) {
+			raw_ready = raw_staging + raw_fill_ind*n16_per_block;
+			raw_fill_ind = 1 - raw_fill_ind;
 		}
+		if (AudioInputI2SHex_F32::update_responsibility) AudioStream_F32::update_all();
 	}
 	//digitalWriteFast(3, LOW);
 }
 
 void AudioInputI2SHex_F32::update_1chan(int chan, unsigned long counter, audio_block_f32_t *&out_block) {
 	if (!out_block) return;
-		
-	//incoming data is still scaled like int16 (so, +/-32767.).  Here we need to re-scale
-	//the values so that the maximum possible audio values spans the F32 stadard of +/-1.0
-	AudioInputI2S_F32::scale_i16_to_f32(out_block->data, out_block->data, audio_block_samples);
 	
 	//prepare to transmit by setting the update_counter (which helps tell if data is skipped or out-of-order)
 	out_block->id = counter;
-	out_block->id = sample_rate_Hz;
+	out_block->fs_Hz = sample_rate_Hz;
 	out_block->length = audio_block_samples;
 
-	// then transmit and release the DMA's former blocks
+	// then transmit and release the blocks
 	AudioStream_F32::transmit(out_block, chan);
 	AudioStream_F32::release(out_block);
 }
 
 void AudioInputI2SHex_F32::update(void)
 {
-	audio_block_f32_t *new1, *new2, *new3, *new4, *new5, *new6;
-	audio_block_f32_t *out1, *out2, *out3, *out4, *out5, *out6;
+	const int n_chan = 6;
+	audio_block_f32_t *out[n_chan];
 
-	// allocate 6 new blocks
-	new1 = AudioStream_F32::allocate_f32();
-	new2 = AudioStream_F32::allocate_f32();
-	new3 = AudioStream_F32::allocate_f32();
-	new4 = AudioStream_F32::allocate_f32();
-	new5 = AudioStream_F32::allocate_f32();
-	new6 = AudioStream_F32::allocate_f32();
-	// but if any fails, allocate none
-	if (!new1 || !new2 || !new3 || !new4 || !new5 || !new6) {
+	//take the raw block that the ISR has finished (if any)
+	__disable_irq();
+	const int16_t *src = raw_ready;
+	raw_ready = NULL;
+	__enable_irq();
+	if (src == NULL) return;  //the DMA has not finished a new block
+
+	// allocate 6 new blocks, but if any fails, allocate none
+	bool any_null = false;
+	for (int i=0; i < n_chan; i++) { out[i] = AudioStream_F32::allocate_f32(); if (!out[i]) any_null = true; }
+	if (any_null) {
 		flag_out_of_memory = 1;
 		//Serial.println("AudioInputI2SHex_F32 In: out of memory.");
-		if (new1) {
-			AudioStream_F32::release(new1);
-			new1 = NULL;
-		}
-		if (new2) {
-			AudioStream_F32::release(new2);
-			new2 = NULL;
-		}
-		if (new3) {
-			AudioStream_F32::release(new3);
-			new3 = NULL;
-		}
-		if (new4) {
-			AudioStream_F32::release(new4);
-			new4 = NULL;
-		}
-		if (new5) {
-			AudioStream_F32::release(new5);
-			new5 = NULL;
-		}
-		if (new6) {
-			AudioStream_F32::release(new6);
-			new6 = NULL;
-		}
+		for (int i=0; i < n_chan; i++) if (out[i]) AudioStream_F32::release(out[i]);
+		return;
 	}
-	__disable_irq();
-	if (block_offset >= (uint32_t)audio_block_samples) {
-		// the DMA filled 6 blocks, so grab them and get the
-		// 6 new blocks to the DMA, as quickly as possible
-		out1 = block_ch1;
-		block_ch1 = new1;
-		out2 = block_ch2;
-		block_ch2 = new2;
-		out3 = block_ch3;
-		block_ch3 = new3;
-		out4 = block_ch4;
-		block_ch4 = new4;
-		out5 = block_ch5;
-		block_ch5 = new5;
-		out6 = block_ch6;
-		block_ch6 = new6;
-		block_offset = 0;
-		__enable_irq();
-
-//		// then transmit the DMA's former blocks
-//		transmit(out1, 0);
-//		release(out1);
-//		transmit(out2, 1);
-//		release(out2);
-//		transmit(out3, 2);
-//		release(out3);
-//		transmit(out4, 3);
-//		release(out4);
-//		transmit(out5, 4);
-//		release(out5);
-//		transmit(out6, 5);
-//		release(out6);
 
-		update_1chan(0, update_counter, out1); //uses audio_block_samples and update_counter
-		update_1chan(1, update_counter, out2); //uses audio_block_samples and update_counter
-		update_1chan(2, update_counter, out3); //uses audio_block_samples and update_counter
-		update_1chan(3, update_counter, out4); //uses audio_block_samples and update_counter
-		update_1chan(4, update_counter, out5); //uses audio_block_samples and update_counter
-		update_1chan(5, update_counter, out6); //uses audio_block_samples and update_counter
-		
-
-	} else if (new1 != NULL) {
-		// the DMA didn't fill blocks, but we allocated blocks
-		if (block_ch1 == NULL) {
-			// the DMA doesn't have any blocks to fill, so
-			// give it the ones we just allocated
-			block_ch1 = new1;
-			block_ch2 = new2;
-			block_ch3 = new3;
-			block_ch4 = new4;
-			block_ch5 = new5;
-			block_ch6 = new6;
-			block_offset = 0;
-			__enable_irq();
-		} else {
-			// the DMA already has blocks, doesn't need these
-			__enable_irq();
-			AudioStream_F32::release(new1);
-			AudioStream_F32::release(new2);
-			AudioStream_F32::release(new3);
-			AudioStream_F32::release(new4);
-			AudioStream_F32::release(new5);
-			AudioStream_F32::release(new6);
-		}
+	//De-interleave and scale to +/-1.0.  Note the order!!! Chan 1, 3, 5, 2, 4, 6
+	float32_t *dest[n_chan] = {out[0]->data, out[2]->data, out[4]->data, out[1]->data, out[3]->data, out[5]->data};
+	if (transfer_32bit) {
+		deinterleave_i32_to_f32<n_chan>((const int32_t *)src, dest, audio_block_samples);
 	} else {
-		// The DMA didn't fill blocks, and we could not allocate
-		// memory... the system is likely starving for memory!
-		// Sadly, there's nothing we can do.
-		__enable_irq();
+		deinterleave_i16_to_f32<n_chan>(src, dest, audio_block_samples);
 	}
+
+	//transmit the data
+	update_counter++;
+	for (int i=0; i < n_chan; i++) update_1chan(i, update_counter, out[i]); //uses audio_block_samples
 }
 
 #else // not supported
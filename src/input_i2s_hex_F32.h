@@ -49,6 +49,7 @@ public:
 	AudioInputI2SHex_F32(const AudioSettings_F32 &settings, bool flag_callBegin) : AudioInputI2SBase_F32() { 
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		setInstanceName(); 
 		if (flag_callBegin) begin(); 
 	}
@@ -64,13 +65,10 @@ protected:
 	static void isr(void);
 	virtual void update_1chan(int, unsigned long, audio_block_f32_t *&);
 private:
-	static audio_block_f32_t *block_ch1;
-	static audio_block_f32_t *block_ch2;
-	static audio_block_f32_t *block_ch3;
-	static audio_block_f32_t *block_ch4;
-	static audio_block_f32_t *block_ch5;
-	static audio_block_f32_t *block_ch6;
-	static uint32_t block_offset;
+	static int16_t *raw_staging;           //two blocks of raw interleaved samples, filled alternately by the ISR
+	static int raw_staging_len;            //total length of raw_staging (int16 values)
+	static int raw_fill_ind;               //which staging block the ISR is filling (0 or 1)
+	static const int16_t * volatile raw_ready; //the staging block that is ready for update(), or NULL
 };
 
 
@@ -37,14 +37,13 @@
 #include "output_i2s_F32.h"
 
 //DMAMEM __attribute__((aligned(32))) static uint32_t i2s_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32*2]; //Teensy Audio original
-DMAMEM __attribute__((aligned(32))) static uint32_t i2s_default_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32/2*4]; //Teensy Audio original
+DMAMEM __attribute__((aligned(32))) static uint32_t i2s_default_rx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32*4]; //big enough for 32-bit transfers
 uint32_t *AudioInputI2SQuad_F32::i2s_rx_buffer = i2s_default_rx_buffer;
 //DMAMEM static uint32_t i2s_rx_buffer[AUDIO_BLOCK_SAMPLES/2*4];
-audio_block_f32_t * AudioInputI2SQuad_F32::block_ch1 = NULL;
-audio_block_f32_t * AudioInputI2SQuad_F32::block_ch2 = NULL;
-audio_block_f32_t * AudioInputI2SQuad_F32::block_ch3 = NULL;
-audio_block_f32_t * AudioInputI2SQuad_F32::block_ch4 = NULL;
-uint32_t AudioInputI2SQuad_F32::block_offset = 0;
+int16_t * AudioInputI2SQuad_F32::raw_staging = NULL;
+int AudioInputI2SQuad_F32::raw_staging_len = 0;
+int AudioInputI2SQuad_F32::raw_fill_ind = 0;
+const int16_t * volatile AudioInputI2SQuad_F32::raw_ready = NULL;
 bool AudioInputI2SQuad_F32::update_responsibility = false;
 DMAChannel AudioInputI2SQuad_F32::dma(false);
 //int AudioInputI2SQuad_F32::flag_out_of_memory = 0;
@@ -52,8 +51,8 @@ DMAChannel AudioInputI2SQuad_F32::dma(false);
 //float AudioInputI2SQuad_F32::sample_rate_Hz = AUDIO_SAMPLE_RATE;
 //int AudioInputI2SQuad_F32::audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32;
 
-//for 16-bit transfers?
-#define I2S_BUFFER_TO_USE_BYTES ((AudioOutputI2SQuad_F32::audio_block_samples)*4*(sizeof(i2s_rx_buffer[0])/2))
+//for 16-bit transfers, two samples share each uint32.  For 32-bit transfers, each gets its own.
+#define I2S_BUFFER_TO_USE_BYTES ((AudioOutputI2SQuad_F32::audio_block_samples)*4*(sizeof(i2s_rx_buffer[0])/2)*(transfer_32bit ? 2 : 1))
 
 
 #if defined(__MK20DX256__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) || defined(__IMXRT1062__)
@@ -61,6 +60,15 @@ DMAChannel AudioInputI2SQuad_F32::dma(false);
 
 void AudioInputI2SQuad_F32::begin(void)
 {
+#if defined(KINETISK)
+	if (transfer_32bit) {
+		//the Teensy 3.x quad I2S is set up with 16-bit slots
+		Serial.println(F("AudioInputI2SQuad_F32: begin: *** WARNING ***: 32-bit transfers are not supported on Teensy 3.x.  Using 16-bit."));
+		transfer_32bit = false;
+	}
+#endif
+	allocateRawStaging(raw_staging, raw_staging_len, 4*audio_block_samples*(transfer_32bit ? 2 : 1)); //four values per sample
+	raw_fill_ind = 0;  raw_ready = NULL;
 	dma.begin(true); // Allocate the DMA channel first
 
 	AudioOutputI2SQuad_F32::sample_rate_Hz = sample_rate_Hz;  //these were given in the AudioSettings in the Contructor
@@ -129,15 +137,19 @@ void AudioInputI2SQuad_F32::begin(void)
 		IOMUXC_SAI1_RX_DATA3_SELECT_INPUT = 1; // GPIO_B0_12_ALT3, pg 875
 		break;
 	}
-	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + 2 + pinoffset * 4);
+	//Each minor loop reads one sample from each of the two data lines (RDR0 and RDR1).  The I2S slots are
+	//32 bits.  For 16-bit transfers, only read the upper half of each slot (hence the "+ 2").
+	const int xfer_bytes = transfer_32bit ? 4 : 2;  //bytes per sample
+	const int xfer_size = transfer_32bit ? 2 : 1;   //DMA size code: 1 = 16-bit, 2 = 32-bit
+	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + (transfer_32bit ? 0 : 2) + pinoffset * 4);
 	dma.TCD->SOFF = 4;
-	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
 	dma.TCD->NBYTES_MLOFFYES = DMA_TCD_NBYTES_SMLOE |
-		DMA_TCD_NBYTES_MLOFFYES_MLOFF(-8) |  // 4 samples @ 2 bytes each?
-		DMA_TCD_NBYTES_MLOFFYES_NBYTES(4);
-	dma.TCD->SLAST = -8;   //4 samples @ 2 bytes each?
+		DMA_TCD_NBYTES_MLOFFYES_MLOFF(-8) |  // back to RDR0 (two 4-byte registers)
+		DMA_TCD_NBYTES_MLOFFYES_NBYTES(2*xfer_bytes);
+	dma.TCD->SLAST = -8;   //back to RDR0
 	dma.TCD->DADDR = i2s_rx_buffer;
-	dma.TCD->DOFF = 2;
+	dma.TCD->DOFF = xfer_bytes;
 	//dma.TCD->CITER_ELINKNO = AUDIO_BLOCK_SAMPLES * 2; //original Teensy Audio Library
 	//dma.TCD->DLASTSGA = -sizeof(i2s_rx_buffer);  //original Teensy Audio Library
 	//dma.TCD->BITER_ELINKNO = AUDIO_BLOCK_SAMPLES * 2; //original Teensy Audio Library
@@ -160,9 +172,9 @@ void AudioInputI2SQuad_F32::begin(void)
 
 void AudioInputI2SQuad_F32::isr(void)
 {
-	uint32_t daddr, offset;
-	const int16_t *src;  //*end;
-	float32_t *dest1_f32, *dest2_f32, *dest3_f32, *dest4_f32;
+	uint32_t daddr;
+	const uint32_t *src;
+	int half;
 
 	//digitalWriteFast(3, HIGH);
 	daddr = (uint32_t)(dma.TCD->DADDR);
@@ -172,69 +184,33 @@ void AudioInputI2SQuad_F32::isr(void)
 	if (daddr < (uint32_t)i2s_rx_buffer + I2S_BUFFER_TO_USE_BYTES / 2) { //new quad, enable diff audio block lengths
 		// DMA is receiving to the first half of the buffer
 		// need to remove data from the second half
-		//src = (int16_t *)&i2s_rx_buffer[AUDIO_BLOCK_SAMPLES];
-		src = (int16_t *)&i2s_rx_buffer[audio_block_samples];
-		//end = (int16_t *)&i2s_rx_buffer[audio_block_samples*2];
-		if (AudioInputI2SQuad_F32::update_responsibility) AudioStream_F32::update_all();
+		src = (uint32_t *)((uint32_t)i2s_rx_buffer + I2S_BUFFER_TO_USE_BYTES / 2);
+		half = 1;
 	} else {
 		// DMA is receiving to the second half of the buffer
 		// need to remove data from the first half
-		src = (int16_t *)&i2s_rx_buffer[0];
-		//end = (int16_t *)&i2s_rx_buffer[audio_block_samples];
+		src = &i2s_rx_buffer[0];
+		half = 0;
 	}
+	const bool have_staging = (raw_staging != NULL); //if not, skip the copy...but still keep the audio system running
 	
-	#if 0
-		//data in DMA is int16 (ie, +/-32767), so this block of code will copy to f32 buffer *and* it will scale it to be +/- 1.0
-	
-		//De-interleave and copy to destination audio buffers.  
-		//Note the unexpected order!!! Chan 1, 3, 2, 4
-		const float32_t scale = 1.0f/32767.0f;
-		if (block_ch1 && block_ch2 && block_ch3 && block_ch4) {
-			offset = AudioInputI2SQuad_F32::block_offset;
-			if (offset <= (uint32_t)(audio_block_samples/2)) {
-				//arm_dcache_delete((void*)src, sizeof(i2s_rx_buffer)/2);
-				arm_dcache_delete((void*)src, I2S_BUFFER_TO_USE_BYTES/2);
-				
-				AudioInputI2SQuad_F32::block_offset = offset + audio_block_samples/2;
-				dest1_f32 = &(block_ch1->data[offset]);
-				dest2_f32 = &(block_ch2->data[offset]);
-				dest3_f32 = &(block_ch3->data[offset]);
-				dest4_f32 = &(block_ch4->data[offset]);
-				for (int i=0; i < audio_block_samples/2; i++) {
-					*dest1_f32++ = scale*((float32_t) *src++);  //left 1
-					*dest3_f32++ = scale*((float32_t) *src++);  //left 2 (note chan 3!!)
-					*dest2_f32++ = scale*((float32_t) *src++);  //right 1 (note chan 2!!)
-					*dest4_f32++ = scale*((float32_t) *src++);  //right 2
-				}
-			}
-		} 
-	
-	#else
-		//This block of code only copies the data into F32 buffers but leaves the scaling at +/-32767.0
-		//which will then be scaled in the update() method instead of here
-	
-		//De-interleave and copy to destination audio buffers.  
-		//Note the unexpected order!!! Chan 1, 3, 2, 4
-		if (block_ch1 && block_ch2 && block_ch3 && block_ch4) {
-			offset = AudioInputI2SQuad_F32::block_offset;
-			if (offset <= (uint32_t)(audio_block_samples/2)) {
-				//arm_dcache_delete((void*)src, sizeof(i2s_rx_buffer)/2);
-				arm_dcache_delete((void*)src, I2S_BUFFER_TO_USE_BYTES/2);
-				
-				AudioInputI2SQuad_F32::block_offset = offset + audio_block_samples/2;
-				dest1_f32 = &(block_ch1->data[offset]);
-				dest2_f32 = &(block_ch2->data[offset]);
-				dest3_f32 = &(block_ch3->data[offset]);
-				dest4_f32 = &(block_ch4->data[offset]);
-				for (int i=0; i < audio_block_samples/2; i++) {
-					*dest1_f32++ = ((float32_t) *src++);  //left 1
-					*dest3_f32++ = ((float32_t) *src++);  //left 2 (note chan 3!!)
-					*dest2_f32++ = ((float32_t) *src++);  //right 1 (note chan 2!!)
-					*dest4_f32++ = ((float32_t) *src++);  //right 2
-				}
-			}
-		} 
-	#endif
+	//Only copy the raw samples here.  The de-interleaving (note the unexpected order!!! Chan 1, 3, 2, 4)
+	//and the conversion to float are done in update() instead.
+	arm_dcache_delete((void*)src, I2S_BUFFER_TO_USE_BYTES/2);
+	const int n16_per_block = 4*audio_block_samples*(transfer_32bit ? 2 : 1); //block length in int16 units
+	if (have_staging) {
+		int16_t *dest = raw_staging + raw_fill_ind*n16_per_block + half*(n16_per_block/2);
+		memcpy(dest, src, I2S_BUFFER_TO_USE_BYTES / 2);
+	}
+	if (half == 1) {
+		//the staging block is complete, so hand it to update() and start filling the other one
+		if (have_staging) {
+			raw_ready = raw_staging + raw_fill_ind*n16_per_block;
+			raw_fill_ind = 1 - raw_fill_ind;
+		}
+		if (AudioInputI2SQuad_F32::update_responsibility) AudioStream_F32::update_all();
+	}
+	//digitalWriteFast(3, LOW);
 }
 
 /* #define I16_TO_F32_NORM_FACTOR (3.051850947599719e-05)  //which is 1/32767 
@@ -252,100 +228,58 @@ void AudioInputI2SQuad_F32::scale_i32_to_f32( float32_t *p_i32, float32_t *p_f32
 
 void AudioInputI2SQuad_F32::update_1chan(int chan, unsigned long counter, audio_block_f32_t *&out_block) {
 	if (!out_block) return;
-		
-	//incoming data is still scaled like int16 (so, +/-32767.).  Here we need to re-scale
-	//the values so that the maximum possible audio values spans the F32 stadard of +/-1.0
-	AudioInputI2S_F32::scale_i16_to_f32(out_block->data, out_block->data, audio_block_samples);
 	
 	//prepare to transmit by setting the update_counter (which helps tell if data is skipped or out-of-order)
 	out_block->id = counter;
 	out_block->fs_Hz = sample_rate_Hz;
 	out_block->length = audio_block_samples;
 
-	// then transmit and release the DMA's former blocks
+	// then transmit and release the blocks
 	AudioStream_F32::transmit(out_block, chan);
 	AudioStream_F32::release(out_block);
 }
 
 void AudioInputI2SQuad_F32::update(void)
 {
-	audio_block_f32_t *new1, *new2, *new3, *new4;
 	audio_block_f32_t *out1, *out2, *out3, *out4;
 
+	//take the raw block that the ISR has finished (if any)
+	__disable_irq();
+	const int16_t *src = raw_ready;
+	raw_ready = NULL;
+	__enable_irq();
+	if (src == NULL) return;  //the DMA has not finished a new block
+
 	// allocate 4 new blocks
-	new1 = AudioStream_F32::allocate_f32();
-	new2 = AudioStream_F32::allocate_f32();
-	new3 = AudioStream_F32::allocate_f32();
-	new4 = AudioStream_F32::allocate_f32();
+	out1 = AudioStream_F32::allocate_f32();
+	out2 = AudioStream_F32::allocate_f32();
+	out3 = AudioStream_F32::allocate_f32();
+	out4 = AudioStream_F32::allocate_f32();
 	// but if any fails, allocate none
-	if (!new1 || !new2 || !new3 || !new4) {
+	if (!out1 || !out2 || !out3 || !out4) {
 		flag_out_of_memory = 1;
 		//Serial.println("Quad In: out of memory.");
-		if (new1) {
-			AudioStream_F32::release(new1);
-			new1 = NULL;
-		}
-		if (new2) {
-			AudioStream_F32::release(new2);
-			new2 = NULL;
-		}
-		if (new3) {
-			AudioStream_F32::release(new3);
-			new3 = NULL;
-		}
-		if (new4) {
-			AudioStream_F32::release(new4);
-			new4 = NULL;
-		}
+		if (out1) AudioStream_F32::release(out1);
+		if (out2) AudioStream_F32::release(out2);
+		if (out3) AudioStream_F32::release(out3);
+		if (out4) AudioStream_F32::release(out4);
+		return;
 	}
-	__disable_irq();
-	if (block_offset >= (uint32_t)audio_block_samples) {
-		// the DMA filled 4 blocks, so grab them and get the
-		// 4 new blocks to the DMA, as quickly as possible
-		out1 = block_ch1;
-		block_ch1 = new1;
-		out2 = block_ch2;
-		block_ch2 = new2;
-		out3 = block_ch3;
-		block_ch3 = new3;
-		out4 = block_ch4;
-		block_ch4 = new4;
-		block_offset = 0;
-		__enable_irq();
-		
-		//service the data that we just got out of the DMA
-		update_counter++;
-		update_1chan(0, update_counter, out1); //uses audio_block_samples and update_counter
-		update_1chan(1, update_counter, out2); //uses audio_block_samples and update_counter
-		update_1chan(2, update_counter, out3); //uses audio_block_samples and update_counter
-		update_1chan(3, update_counter, out4); //uses audio_block_samples and update_counter
-		
-		
-	} else if (new1 != NULL) {
-		// the DMA didn't fill blocks, but we allocated blocks
-		if (block_ch1 == NULL) {
-			// the DMA doesn't have any blocks to fill, so
-			// give it the ones we just allocated
-			block_ch1 = new1;
-			block_ch2 = new2;
-			block_ch3 = new3;
-			block_ch4 = new4;
-			block_offset = 0;
-			__enable_irq();
-		} else {
-			// the DMA already has blocks, doesn't need these
-			__enable_irq();
-			AudioStream_F32::release(new1);
-			AudioStream_F32::release(new2);
-			AudioStream_F32::release(new3);
-			AudioStream_F32::release(new4);
-		}
+
+	//De-interleave and scale to +/-1.0.  Note the unexpected order!!! Chan 1, 3, 2, 4
+	float32_t *dest[4] = {out1->data, out3->data, out2->data, out4->data};
+	if (transfer_32bit) {
+		deinterleave_i32_to_f32<4>((const int32_t *)src, dest, audio_block_samples);
 	} else {
-		// The DMA didn't fill blocks, and we could not allocate
-		// memory... the system is likely starving for memory!
-		// Sadly, there's nothing we can do.
-		__enable_irq();
+		deinterleave_i16_to_f32<4>(src, dest, audio_block_samples);
 	}
+		
+	//transmit the data
+	update_counter++;
+	update_1chan(0, update_counter, out1); //uses audio_block_samples and update_counter
+	update_1chan(1, update_counter, out2); //uses audio_block_samples and update_counter
+	update_1chan(2, update_counter, out3); //uses audio_block_samples and update_counter
+	update_1chan(3, update_counter, out4); //uses audio_block_samples and update_counter
 }
 
 #else // not __MK20DX256__
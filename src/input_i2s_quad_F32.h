@@ -54,12 +54,14 @@ public:
 	AudioInputI2SQuad_F32(const AudioSettings_F32 &settings, bool flag_callBegin) : AudioInputI2SBase_F32() {
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		setInstanceName();
 		if (flag_callBegin) begin(); 
 	}
- 	AudioInputI2SQuad_F32(const AudioSettings_F32 &settings, uint32_t *rx_buff) : AudioInputI2SBase_F32() { 
+ 	AudioInputI2SQuad_F32(const AudioSettings_F32 &settings, uint32_t *rx_buff) : AudioInputI2SBase_F32() { //rx_buff must hold 2*audio_block_samples uint32s (16-bit) or 4*audio_block_samples (32-bit)
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		i2s_rx_buffer = rx_buff;
 		setInstanceName();
 		begin(); 
@@ -75,13 +77,12 @@ protected:
 	static void isr(void);
 	virtual void update_1chan(int, unsigned long, audio_block_f32_t *&);
 private:
-	static audio_block_f32_t *block_ch1;
-	static audio_block_f32_t *block_ch2;
-	static audio_block_f32_t *block_ch3;
-	static audio_block_f32_t *block_ch4;
+	static int16_t *raw_staging;           //two blocks of raw interleaved samples, filled alternately by the ISR
+	static int raw_staging_len;            //total length of raw_staging (int16 values)
+	static int raw_fill_ind;               //which staging block the ISR is filling (0 or 1)
+	static const int16_t * volatile raw_ready; //the staging block that is ready for update(), or NULL
 //	static float sample_rate_Hz;
 //	static int audio_block_samples;
-	static uint32_t block_offset;
 //	static int flag_out_of_memory;
 //	unsigned long update_counter=0;
 };
@@ -0,0 +1,203 @@
+/*
+ * AudioInputTDM_F32
+ *
+ * Created: 2026
+ * Purpose: Receive N_SLOTS channels of audio over TDM (one data line, N_SLOTS 32-bit slots per frame)
+ *     from a multi-channel codec or mic array.  Like AudioInputI2SQuad_F32 and AudioInputI2SHex_F32,
+ *     the ISR only copies the raw samples out of the DMA buffer; update() does the de-interleaving and
+ *     conversion to float.  The number of slots (2, 4, 8, or 16) and the bit depth (16 or 32) are
+ *     template parameters.  Disabled slots get no audio blocks and no conversion, so they cost nothing.
+ *
+ *     Example: AudioInputTDM_F32<8> tdm_in(audio_settings);     //8 slots, 16-bit data
+ *              AudioInputTDM_F32<16,32> tdm_in(audio_settings); //16 slots, full 32-bit data
+ *              tdm_in.setAllSlotsEnabled(false); tdm_in.setSlotEnabled(0,true); tdm_in.setSlotEnabled(5,true);
+ *
+ *     Only for Teensy 4 (Tympan RevE and later).  The data comes in on pin 8 (RX_DATA0).
+ *
+ * MIT License.  use at your own risk.
+*/
+
+#ifndef _input_tdm_f32_h_
+#define _input_tdm_f32_h_
+
+#include <Arduino.h>
+#include <arm_math.h>
+#include <type_traits>  //for std::conditional
+#include "AudioStream_F32.h"
+#include "DMAChannel.h"
+#include "input_i2s_F32.h"  //for AudioInputI2SBase_F32
+#include "output_tdm_F32.h" //for AudioTDMBase_F32 and AudioTDMSlots_F32
+
+template <int N_SLOTS, int BITS = 16>
+class AudioInputTDM_F32 : public AudioInputI2SBase_F32, public AudioTDMSlots_F32<N_SLOTS>
+{
+	static_assert((N_SLOTS == 2) || (N_SLOTS == 4) || (N_SLOTS == 8) || (N_SLOTS == 16), "AudioInputTDM_F32: N_SLOTS must be 2, 4, 8, or 16");
+	static_assert((BITS == 16) || (BITS == 24) || (BITS == 32), "AudioInputTDM_F32: BITS must be 16, 24, or 32");
+	public:
+		typedef typename std::conditional<(BITS > 16), int32_t, int16_t>::type sample_t; //how each sample is received over the DMA
+
+		AudioInputTDM_F32(void) : AudioInputI2SBase_F32() {
+			setInstanceName();
+			audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32;
+			begin();
+		}
+		AudioInputTDM_F32(const AudioSettings_F32 &settings) : AudioInputI2SBase_F32() {
+			setInstanceName();
+			sample_rate_Hz = settings.sample_rate_Hz;
+			audio_block_samples = settings.audio_block_samples;
+			begin();
+		}
+		void setInstanceName(void) override { instanceName = "AudioInputTDM_F32"; }
+
+		void begin(void) override;
+		void update(void) override;
+
+		//the bit depth is fixed by the template, so TDM keeps its own flag rather than the I2S inputs' shared transfer_32bit
+		static bool get_isTransfer32bit(void) { return tdm_transfer_32bit; }
+
+	protected:
+		static const bool tdm_transfer_32bit = (BITS > 16);
+		static void isr(void);
+		static DMAChannel dma;
+		static bool update_responsibility;
+		static sample_t *tdm_rx_buffer;           //the DMA buffer (two halves)
+		static int tdm_rx_buffer_len;
+		static sample_t *raw_staging;             //two blocks of raw interleaved samples, filled alternately by the ISR
+		static int raw_staging_len;
+		static int raw_fill_ind;                  //which staging block the ISR is filling (0 or 1)
+		static const sample_t * volatile raw_ready; //the staging block that is ready for update(), or NULL
+};
+
+template <int N_SLOTS, int BITS> DMAChannel AudioInputTDM_F32<N_SLOTS,BITS>::dma(false);
+template <int N_SLOTS, int BITS> bool AudioInputTDM_F32<N_SLOTS,BITS>::update_responsibility = false;
+template <int N_SLOTS, int BITS> typename AudioInputTDM_F32<N_SLOTS,BITS>::sample_t * AudioInputTDM_F32<N_SLOTS,BITS>::tdm_rx_buffer = NULL;
+template <int N_SLOTS, int BITS> int AudioInputTDM_F32<N_SLOTS,BITS>::tdm_rx_buffer_len = 0;
+template <int N_SLOTS, int BITS> typename AudioInputTDM_F32<N_SLOTS,BITS>::sample_t * AudioInputTDM_F32<N_SLOTS,BITS>::raw_staging = NULL;
+template <int N_SLOTS, int BITS> int AudioInputTDM_F32<N_SLOTS,BITS>::raw_staging_len = 0;
+template <int N_SLOTS, int BITS> int AudioInputTDM_F32<N_SLOTS,BITS>::raw_fill_ind = 0;
+template <int N_SLOTS, int BITS> const typename AudioInputTDM_F32<N_SLOTS,BITS>::sample_t * volatile AudioInputTDM_F32<N_SLOTS,BITS>::raw_ready = NULL;
+
+template <int N_SLOTS, int BITS>
+void AudioInputTDM_F32<N_SLOTS,BITS>::begin(void)
+{
+#if defined(__IMXRT1062__)
+	//allocate the DMA buffer and the staging blocks (each is one full block of interleaved samples)
+	const int n_per_block = audio_block_samples * N_SLOTS;
+	if (tdm_rx_buffer_len < n_per_block) {
+		tdm_rx_buffer = (sample_t *)AudioTDMBase_F32::allocateDMABuffer(n_per_block * sizeof(sample_t));
+		tdm_rx_buffer_len = (tdm_rx_buffer == NULL) ? 0 : n_per_block;
+	}
+	if (raw_staging_len < 2*n_per_block) {
+		delete[] raw_staging;
+		raw_staging = new sample_t[2*n_per_block]();  //zeroed
+		raw_staging_len = (raw_staging == NULL) ? 0 : 2*n_per_block;
+	}
+	if ((tdm_rx_buffer == NULL) || (raw_staging == NULL)) {
+		Serial.println(F("AudioInputTDM_F32: begin: *** ERROR ***: could not allocate the buffers."));
+		return;
+	}
+	raw_fill_ind = 0;  raw_ready = NULL;
+
+	dma.begin(true); // Allocate the DMA channel first
+	AudioTDMBase_F32::config_tdm(N_SLOTS, sample_rate_Hz);
+	CORE_PIN8_CONFIG  = 3;  //1:RX_DATA0
+	IOMUXC_SAI1_RX_DATA0_SELECT_INPUT = 2;
+
+	//One sample per minor loop.  The slots are 32 bits.  For 16-bit data, only read the upper half of each slot (hence the "+ 2").
+	const int xfer_bytes = sizeof(sample_t);
+	const int xfer_size = (xfer_bytes == 4) ? 2 : 1;  //DMA size code: 1 = 16-bit, 2 = 32-bit
+	dma.TCD->SADDR = (void *)((uint32_t)&I2S1_RDR0 + ((xfer_bytes == 2) ? 2 : 0));
+	dma.TCD->SOFF = 0;
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
+	dma.TCD->NBYTES_MLNO = xfer_bytes;
+	dma.TCD->SLAST = 0;
+	dma.TCD->DADDR = tdm_rx_buffer;
+	dma.TCD->DOFF = xfer_bytes;
+	dma.TCD->CITER_ELINKNO = n_per_block;
+	dma.TCD->DLASTSGA = -(n_per_block * xfer_bytes);
+	dma.TCD->BITER_ELINKNO = n_per_block;
+	dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
+	dma.triggerAtHardwareEvent(DMAMUX_SOURCE_SAI1_RX);
+
+	I2S1_RCSR = I2S_RCSR_RE | I2S_RCSR_BCE | I2S_RCSR_FRDE | I2S_RCSR_FR;
+	update_responsibility = update_setup();
+	dma.enable();
+	dma.attachInterrupt(isr);
+#else
+	Serial.println(F("AudioInputTDM_F32: begin: *** ERROR ***: TDM is only supported on Teensy 4 (Tympan RevE and later)."));
+#endif
+}
+
+template <int N_SLOTS, int BITS>
+void AudioInputTDM_F32<N_SLOTS,BITS>::isr(void)
+{
+#if defined(__IMXRT1062__)
+	const int half_len = (audio_block_samples / 2) * N_SLOTS;  //samples in half of the DMA buffer
+	const int n_per_block = audio_block_samples * N_SLOTS;
+	const sample_t *src;
+
+	uint32_t daddr = (uint32_t)(dma.TCD->DADDR);
+	dma.clearInterrupt();
+	const bool second_half_done = (daddr < (uint32_t)(tdm_rx_buffer + half_len));
+	if (second_half_done) {
+		// DMA is receiving to the first half of the buffer, so the second half is complete
+		src = tdm_rx_buffer + half_len;
+	} else {
+		// DMA is receiving to the second half of the buffer, so the first half is complete
+		src = tdm_rx_buffer;
+	}
+	arm_dcache_delete((void *)src, half_len*sizeof(sample_t));
+
+	//just copy the raw samples out of the DMA buffer.  update() does the rest.
+	sample_t *dest = raw_staging + raw_fill_ind*n_per_block + (second_half_done ? half_len : 0);
+	memcpy(dest, src, half_len*sizeof(sample_t));
+	if (second_half_done) {
+		raw_ready = raw_staging + raw_fill_ind*n_per_block;  //a full block is ready
+		raw_fill_ind = 1 - raw_fill_ind;
+		if (update_responsibility) AudioStream_F32::update_all();
+	}
+#endif
+}
+
+template <int N_SLOTS, int BITS>
+void AudioInputTDM_F32<N_SLOTS,BITS>::update(void)
+{
+	//get the block that the ISR finished
+	__disable_irq();
+	const sample_t *src = raw_ready;
+	raw_ready = NULL;
+	__enable_irq();
+	if (src == NULL) return;
+
+	//allocate blocks only for the enabled slots
+	audio_block_f32_t *out_block[N_SLOTS];
+	float32_t *dest[N_SLOTS];
+	const int n_used = this->n_active_slots;
+	for (int k=0; k < n_used; k++) {
+		const int slot = this->active_slots[k];
+		out_block[slot] = allocate_f32();
+		if (out_block[slot] == NULL) {
+			flag_out_of_memory = 1;
+			for (int j=0; j < k; j++) AudioStream_F32::release(out_block[this->active_slots[j]]);
+			return;
+		}
+		dest[slot] = out_block[slot]->data;
+	}
+
+	//de-interleave and convert to float in one pass per enabled slot
+	const float32_t scale = tdm_transfer_32bit ? (1.0f/2147483647.0f) : (1.0f/32767.0f);
+	deinterleave_slots_to_f32<N_SLOTS,sample_t>(src, dest, this->active_slots, n_used, audio_block_samples, scale);
+
+	//transmit and release
+	update_counter++;
+	for (int k=0; k < n_used; k++) {
+		const int slot = this->active_slots[k];
+		out_block[slot]->id = update_counter;
+		out_block[slot]->length = audio_block_samples;
+		out_block[slot]->fs_Hz = sample_rate_Hz;
+		AudioStream_F32::transmit(out_block[slot], slot);
+		AudioStream_F32::release(out_block[slot]);
+	}
+}
+
+#endif
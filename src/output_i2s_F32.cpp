@@ -195,7 +195,7 @@ uint16_t  AudioOutputI2S_F32::block_right_offset = 0;
 bool AudioOutputI2S_F32::update_responsibility = false;
 DMAChannel AudioOutputI2S_F32::dma(false);
 //DMAMEM __attribute__((aligned(32))) static uint32_t i2s_tx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32];
-uint32_t i2s_default_tx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32];
+uint32_t i2s_default_tx_buffer[2*MAX_AUDIO_BLOCK_SAMPLES_F32]; //big enough for 32-bit transfers
 uint32_t * AudioOutputI2S_F32::i2s_tx_buffer = i2s_default_tx_buffer;
 //static uint32_t i2s_tx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32];
 //DMAMEM static int32_t i2s_tx_buffer[2*AUDIO_BLOCK_SAMPLES]; //2 channels at 32-bits per sample.  Local "audio_block_samples" should be no larger than global "AUDIO_BLOCK_SAMPLES"
@@ -203,25 +203,23 @@ uint32_t * AudioOutputI2S_F32::i2s_tx_buffer = i2s_default_tx_buffer;
 
 float AudioOutputI2S_F32::sample_rate_Hz = AUDIO_SAMPLE_RATE;
 int AudioOutputI2S_F32::audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32;
+bool AudioOutputI2S_F32::transfer_32bit = false;
 
 //#if defined(__IMXRT1062__)
 //#include <utility/imxrt_hw.h>   //from Teensy Audio library.  For set_audioClock()
 //#endif
 
-//#for 16-bit transfers
-#define I2S_BUFFER_TO_USE_BYTES (AudioOutputI2S_F32::audio_block_samples*sizeof(i2s_tx_buffer[0]))
-
-//#for 32-bit transfers
-//#define I2S_BUFFER_TO_USE_BYTES (AudioOutputI2S_F32::audio_block_samples*2*sizeof(i2s_tx_buffer[0]))
+//#for 16-bit transfers, each uint32 holds a left and right sample.  For 32-bit transfers, each sample gets its own.
+#define I2S_BUFFER_TO_USE_BYTES (AudioOutputI2S_F32::audio_block_samples*sizeof(i2s_tx_buffer[0])*(AudioOutputI2S_F32::transfer_32bit ? 2 : 1))
 
 
 void AudioOutputI2S_F32::begin(void)
 {
-	bool transferUsing32bit = false;
-	begin(transferUsing32bit);
+	begin(transfer_32bit);  //set by the constructor via AudioSettings_F32::i2s_bits
 }
 
 void AudioOutputI2S_F32::begin(bool transferUsing32bit) {
+	transfer_32bit = transferUsing32bit;
 
 	dma.begin(true); // Allocate the DMA channel first
 
@@ -233,19 +231,22 @@ void AudioOutputI2S_F32::begin(bool transferUsing32bit) {
 #if defined(KINETISK)
 	CORE_PIN22_CONFIG = PORT_PCR_MUX(6); // pin 22, PTC1, I2S0_TXD0
 
+	//The I2S slots are 32 bits.  For 16-bit transfers, only write the upper half of each slot (hence the "+ 2").
+	const int xfer_bytes = transfer_32bit ? 4 : 2;  //bytes per sample
+	const int xfer_size = transfer_32bit ? 2 : 1;   //DMA size code: 1 = 16-bit, 2 = 32-bit
 	dma.TCD->SADDR = i2s_tx_buffer;
-	dma.TCD->SOFF = 2;
-	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
-	dma.TCD->NBYTES_MLNO = 2;
+	dma.TCD->SOFF = xfer_bytes;
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
+	dma.TCD->NBYTES_MLNO = xfer_bytes;
 	//dma.TCD->SLAST = -sizeof(i2s_tx_buffer);//orig from Teensy Audio Library 2020-10-31
 	dma.TCD->SLAST = -I2S_BUFFER_TO_USE_BYTES;
-	dma.TCD->DADDR = (void *)((uint32_t)&I2S0_TDR0 + 2);
+	dma.TCD->DADDR = (void *)((uint32_t)&I2S0_TDR0 + (transfer_32bit ? 0 : 2));
 	dma.TCD->DOFF = 0;
 	//dma.TCD->CITER_ELINKNO = sizeof(i2s_tx_buffer) / 2; //orig from Teensy Audio Library 2020-10-31
-	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	dma.TCD->DLASTSGA = 0;
 	//dma.TCD->BITER_ELINKNO = sizeof(i2s_tx_buffer) / 2;//orig from Teensy Audio Library 2020-10-31
-	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
 	dma.triggerAtHardwareEvent(DMAMUX_SOURCE_I2S0_TX);
 	dma.enable();  //newer location of this line in Teensy Audio library
@@ -256,20 +257,23 @@ void AudioOutputI2S_F32::begin(bool transferUsing32bit) {
 #elif defined(__IMXRT1062__)
 	CORE_PIN7_CONFIG  = 3;  //1:TX_DATA0
 
+	//The I2S slots are 32 bits.  For 16-bit transfers, only write the upper half of each slot (hence the "+ 2").
+	const int xfer_bytes = transfer_32bit ? 4 : 2;  //bytes per sample
+	const int xfer_size = transfer_32bit ? 2 : 1;   //DMA size code: 1 = 16-bit, 2 = 32-bit
 	dma.TCD->SADDR = i2s_tx_buffer;
-	dma.TCD->SOFF = 2;
-	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
-	dma.TCD->NBYTES_MLNO = 2;
+	dma.TCD->SOFF = xfer_bytes;
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
+	dma.TCD->NBYTES_MLNO = xfer_bytes;
 	//dma.TCD->SLAST = -sizeof(i2s_tx_buffer);//orig from Teensy Audio Library 2020-10-31
 	dma.TCD->SLAST = -I2S_BUFFER_TO_USE_BYTES;
 	dma.TCD->DOFF = 0;
 	//dma.TCD->CITER_ELINKNO = sizeof(i2s_tx_buffer) / 2; //orig from Teensy Audio Library 2020-10-31
-	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->CITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	dma.TCD->DLASTSGA = 0;
 	//dma.TCD->BITER_ELINKNO = sizeof(i2s_tx_buffer) / 2;//orig from Teensy Audio Library 2020-10-31
-	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / 2;
+	dma.TCD->BITER_ELINKNO = I2S_BUFFER_TO_USE_BYTES / xfer_bytes;
 	dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
-	dma.TCD->DADDR = (void *)((uint32_t)&I2S1_TDR0 + 2);
+	dma.TCD->DADDR = (void *)((uint32_t)&I2S1_TDR0 + (transfer_32bit ? 0 : 2));
 	dma.triggerAtHardwareEvent(DMAMUX_SOURCE_SAI1_TX);
 	dma.enable();  //newer location of this line in Teensy Audio library
 
@@ -288,7 +292,7 @@ void AudioOutputI2S_F32::begin(bool transferUsing32bit) {
 void AudioOutputI2S_F32::isr(void)
 {
 #if defined(KINETISK) || defined(__IMXRT1062__)
-	int16_t *dest;
+	void *dest;
 	audio_block_f32_t *blockL, *blockR;
 	uint32_t saddr, offsetL, offsetR;
 
@@ -299,12 +303,12 @@ void AudioOutputI2S_F32::isr(void)
 		// DMA is transmitting the first half of the buffer
 		// so we must fill the second half
 		//dest = (int16_t *)&i2s_tx_buffer[AUDIO_BLOCK_SAMPLES/2]; //original Teensy Audio
-		dest = (int16_t *)&i2s_tx_buffer[audio_block_samples/2]; //this will be diff if we were to do 32-bit samples
+		dest = (void *)((uint32_t)i2s_tx_buffer + I2S_BUFFER_TO_USE_BYTES / 2);
 		if (AudioOutputI2S_F32::update_responsibility) AudioStream_F32::update_all();
 	} else {
 		// DMA is transmitting the second half of the buffer
 		// so we must fill the first half
-		dest = (int16_t *)i2s_tx_buffer;
+		dest = (void *)i2s_tx_buffer;
 	}
 
 	blockL = AudioOutputI2S_F32::block_left_1st;
@@ -312,33 +316,59 @@ void AudioOutputI2S_F32::isr(void)
 	offsetL = AudioOutputI2S_F32::block_left_offset;
 	offsetR = AudioOutputI2S_F32::block_right_offset;
 
-	int16_t *d = dest;
-	if (blockL && blockR) {
-		//memcpy_tointerleaveLR(dest, blockL->data + offsetL, blockR->data + offsetR);
-		//memcpy_tointerleaveLRwLen(dest, blockL->data + offsetL, blockR->data + offsetR, audio_block_samples/2);
-		float32_t *pL = blockL->data + offsetL;
-		float32_t *pR = blockR->data + offsetR;
-		for (int i=0; i < audio_block_samples/2; i++) {	
-			*d++ = (int16_t) *pL++; 
-			*d++ = (int16_t) *pR++; //interleave
-			//*d++ = 0;
-			//*d++ = 0;
-		} 
-		offsetL += audio_block_samples / 2;
-		offsetR += audio_block_samples / 2;
-	} else if (blockL) {
-		//memcpy_tointerleaveLR(dest, blockL->data + offsetL, blockR->data + offsetR);
-		float32_t *pL = blockL->data + offsetL;
-		for (int i=0; i < audio_block_samples / 2 * 2; i+=2) { *(d+i) = (int16_t) *pL++; } //interleave
-		offsetL += audio_block_samples / 2;
-	} else if (blockR) {
-		float32_t *pR = blockR->data + offsetR;
-		for (int i=0; i < audio_block_samples /2 * 2; i+=2) { *(d+i) = (int16_t) *pR++; } //interleave
-		offsetR += audio_block_samples / 2;
+	if (transfer_32bit) {
+		//update() has already converted the data to q31 (in place of the floats), so just interleave the words
+		int32_t *d = (int32_t *)dest;
+		if (blockL && blockR) {
+			const int32_t *pL = (const int32_t *)(blockL->data + offsetL);
+			const int32_t *pR = (const int32_t *)(blockR->data + offsetR);
+			for (int i=0; i < audio_block_samples/2; i++) {	
+				*d++ = *pL++; 
+				*d++ = *pR++; //interleave
+			} 
+			offsetL += audio_block_samples / 2;
+			offsetR += audio_block_samples / 2;
+		} else if (blockL) {
+			const int32_t *pL = (const int32_t *)(blockL->data + offsetL);
+			for (int i=0; i < audio_block_samples / 2 * 2; i+=2) { *(d+i) = *pL++; } //interleave
+			offsetL += audio_block_samples / 2;
+		} else if (blockR) {
+			const int32_t *pR = (const int32_t *)(blockR->data + offsetR);
+			for (int i=0; i < audio_block_samples / 2 * 2; i+=2) { *(d+i+1) = *pR++; } //interleave
+			offsetR += audio_block_samples / 2;
+		} else {
+			memset(dest,0,I2S_BUFFER_TO_USE_BYTES / 2);
+			return;
+		}
 	} else {
-		//memset(dest,0,AUDIO_BLOCK_SAMPLES * 2);
-		memset(dest,0,audio_block_samples * 2);
-		return;
+		int16_t *d = (int16_t *)dest;
+		if (blockL && blockR) {
+			//memcpy_tointerleaveLR(dest, blockL->data + offsetL, blockR->data + offsetR);
+			//memcpy_tointerleaveLRwLen(dest, blockL->data + offsetL, blockR->data + offsetR, audio_block_samples/2);
+			float32_t *pL = blockL->data + offsetL;
+			float32_t *pR = blockR->data + offsetR;
+			for (int i=0; i < audio_block_samples/2; i++) {	
+				*d++ = (int16_t) *pL++; 
+				*d++ = (int16_t) *pR++; //interleave
+				//*d++ = 0;
+				//*d++ = 0;
+			} 
+			offsetL += audio_block_samples / 2;
+			offsetR += audio_block_samples / 2;
+		} else if (blockL) {
+			//memcpy_tointerleaveLR(dest, blockL->data + offsetL, blockR->data + offsetR);
+			float32_t *pL = blockL->data + offsetL;
+			for (int i=0; i < audio_block_samples / 2 * 2; i+=2) { *(d+i) = (int16_t) *pL++; } //interleave
+			offsetL += audio_block_samples / 2;
+		} else if (blockR) {
+			float32_t *pR = blockR->data + offsetR;
+			for (int i=0; i < audio_block_samples /2 * 2; i+=2) { *(d+i) = (int16_t) *pR++; } //interleave
+			offsetR += audio_block_samples / 2;
+		} else {
+			//memset(dest,0,AUDIO_BLOCK_SAMPLES * 2);
+			memset(dest,0,I2S_BUFFER_TO_USE_BYTES / 2);
+			return;
+		}
 	}
 	
 	
@@ -692,6 +722,85 @@ void AudioOutputI2S_F32::scale_f32_to_i32( float32_t *p_f32, float32_t *p_i32, i
 	arm_scale_f32(p_f32, F32_TO_I32_NORM_FACTOR, p_i32, len);  // we just need to scale the data	
 }
 
+//For 32-bit transfers: convert to q31 (vectorized and saturating) and store the integers in the float
+//block itself, which the ISR then copies directly to the DMA buffer.  Note that 0.0f and (q31)0 are
+//both all-zero bits, so a zero-filled block is silence either way.
+void AudioOutputI2S_F32::convert_f32_to_q31(float32_t *p_f32, float32_t *p_q31, int len) {
+	arm_float_to_q31(p_f32, (q31_t *)p_q31, len);
+}
+
+//xorshift32 (Marsaglia).  One call gives the two uniform values needed for one sample of TPDF dither.
+static inline uint32_t dither_xorshift32(uint32_t &s) { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+
+//Scale to int16 full-scale, add the dither and the noise-shaping feedback, round, and saturate.  The choices
+//are template parameters so that the per-sample loop has no branches.  The output is still float32, but
+//it holds exact integers, so the ISR's cast to int16 is exact.
+template <int ORDER, bool DITHER>
+static void quantize_f32_to_i16(const float32_t *p_f32, float32_t *p_i16, const int len, float32_t *err, uint32_t &rand_state) {
+	float32_t e1 = err[0], e2 = err[1];  //previous two quantization errors
+	uint32_t s = rand_state;
+	for (int i=0; i < len; i++) {
+		float32_t w = p_f32[i] * F32_TO_I16_NORM_FACTOR;   //the desired value (in LSBs)
+		if (ORDER == 1) w -= e1;                 //error feedback: the noise is shaped by (1 - z^-1)
+		if (ORDER == 2) w -= (2.0f*e1 - e2);     //error feedback: the noise is shaped by (1 - z^-1)^2
+		float32_t v = w;
+		if (DITHER) {
+			const uint32_t r = dither_xorshift32(s);
+			v += ((float32_t)(r & 0xFFFF) - (float32_t)(r >> 16)) * (1.0f/65536.0f);  //difference of two uniforms: TPDF, +/-1 LSB
+		}
+		const float32_t q = roundf(v);
+		if (ORDER > 0) { e2 = e1; e1 = q - w; }  //error before saturation, so clipping cannot make the feedback run away
+		p_i16[i] = max(-32767.0f, min(32767.0f, q));
+	}
+	err[0] = e1; err[1] = e2;
+	rand_state = s;
+}
+
+void AudioOutputDither_F32::scale_f32_to_i16_dither(float32_t *p_f32, float32_t *p_i16, int len, int chan) {
+	float32_t *e = err[max(0, min(max_chan-1, chan))];
+	if (dither_type == DITHER_TPDF) {
+		switch (noise_shaping_order) {
+			case 0: quantize_f32_to_i16<0,true>(p_f32, p_i16, len, e, rand_state); break;
+			case 1: quantize_f32_to_i16<1,true>(p_f32, p_i16, len, e, rand_state); break;
+			default: quantize_f32_to_i16<2,true>(p_f32, p_i16, len, e, rand_state); break;
+		}
+	} else {
+		switch (noise_shaping_order) {
+			case 0: quantize_f32_to_i16<0,false>(p_f32, p_i16, len, e, rand_state); break;
+			case 1: quantize_f32_to_i16<1,false>(p_f32, p_i16, len, e, rand_state); break;
+			default: quantize_f32_to_i16<2,false>(p_f32, p_i16, len, e, rand_state); break;
+		}
+	}
+}
+
+void AudioOutputDither_F32::scale_f32_to_i16_auto(float32_t *p_f32, float32_t *p_i16, int len, int chan) {
+	if (isActive()) { scale_f32_to_i16_dither(p_f32, p_i16, len, chan); } else { AudioOutputI2S_F32::scale_f32_to_i16(p_f32, p_i16, len); }
+}
+
+//The settings and the states change together with the interrupts masked, so update() (which runs in the
+//audio interrupt) never shapes with a new setting using the error history from the old one.
+int AudioOutputDither_F32::setDither(int type) {
+	__disable_irq();
+	dither_type = ((type == DITHER_TPDF) ? DITHER_TPDF : DITHER_NONE);
+	for (int c=0; c < max_chan; c++) { err[c][0] = 0.0f; err[c][1] = 0.0f; }
+	__enable_irq();
+	return dither_type;
+}
+
+int AudioOutputDither_F32::setNoiseShaping(int order) {
+	__disable_irq();
+	noise_shaping_order = max(0, min(2, order));
+	for (int c=0; c < max_chan; c++) { err[c][0] = 0.0f; err[c][1] = 0.0f; }
+	__enable_irq();
+	return noise_shaping_order;
+}
+
+void AudioOutputDither_F32::reset(void) {
+	__disable_irq();
+	for (int c=0; c < max_chan; c++) { err[c][0] = 0.0f; err[c][1] = 0.0f; }
+	__enable_irq();
+}
+
 //update has to be carefully coded so that, if audio_blocks are not available, the code exits
 //gracefully and won't hang.  That'll cause the whole system to hang, which would be very bad.
 //static int count = 0;
@@ -727,7 +836,11 @@ void AudioOutputI2S_F32::update(void)
 		//scale F32 to Int32
 		//block_f32_scaled = AudioStream_F32::allocate_f32();
 		//scale_f32_to_i32(block_f32->data, block_f32_scaled->data, audio_block_samples);
-		scale_f32_to_i16(block_f32->data, block_f32_scaled->data, audio_block_samples);
+		if (transfer_32bit) {
+			convert_f32_to_q31(block_f32->data, block_f32_scaled->data, audio_block_samples);
+		} else {
+			dither.scale_f32_to_i16_auto(block_f32->data, block_f32_scaled->data, audio_block_samples, 0);
+		}
 		
 		//count++;
 		//if (count > 100) {
@@ -769,7 +882,11 @@ void AudioOutputI2S_F32::update(void)
 		//scale F32 to Int32
 		//block_f32_scaled = AudioStream_F32::allocate_f32();
 		//scale_f32_to_i32(block_f32->data, block_f32_scaled->data, audio_block_samples);
-		scale_f32_to_i16(block_f32->data, block_f32_scaled->data, audio_block_samples);
+		if (transfer_32bit) {
+			convert_f32_to_q31(block_f32->data, block_f32_scaled->data, audio_block_samples);
+		} else {
+			dither.scale_f32_to_i16_auto(block_f32->data, block_f32_scaled->data, audio_block_samples, 1);
+		}
 		AudioStream_F32::transmit(block_f32,1);//echo the incoming audio out the outputs
 	} else {
 		//fill with zeros
@@ -1005,6 +1122,7 @@ void AudioOutputI2Sslave_F32::begin(void)
 	//pinMode(2, OUTPUT);
 	block_left_1st = NULL;
 	block_right_1st = NULL;
+	transfer_32bit = false;  //the slave is only set up for 16-bit transfers
 
 	AudioOutputI2Sslave_F32::config_i2s();
 
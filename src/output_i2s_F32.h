@@ -41,6 +41,32 @@
 #include "input_i2s_F32.h" //for AudioInputI2S_F32
 
 
+//Dither and noise shaping for 16-bit transfers.  Done in update() (not in the ISR).  With both off (the
+//default), the output is simply scaled, as before.  TPDF dither adds +/-1 LSB of triangular noise so that
+//quiet signals are not distorted by the truncation.  Noise shaping (1st or 2nd order error feedback) pushes
+//the quantization noise (including the dither) up in frequency.  Each output owns one of these, so each
+//output has its own settings and its own error and random-number states.
+class AudioOutputDither_F32 {
+	public:
+		enum DITHER_TYPE { DITHER_NONE=0, DITHER_TPDF };
+		static const int max_chan = 4;
+
+		int setDither(int type);         //also resets the states
+		int getDither(void) const { return dither_type; }
+		int setNoiseShaping(int order);  //0 (off), 1, or 2.  Also resets the states
+		int getNoiseShaping(void) const { return noise_shaping_order; }
+		bool isActive(void) const { return (dither_type != DITHER_NONE) || (noise_shaping_order > 0); }
+		void reset(void);
+		void scale_f32_to_i16_dither(float32_t *p_f32, float32_t *p_i16, int len, int chan);  //output is rounded and saturated, but still float32.  chan is 0-3.
+		void scale_f32_to_i16_auto(float32_t *p_f32, float32_t *p_i16, int len, int chan);    //uses the dither routine only if it is active
+
+	protected:
+		int dither_type = DITHER_NONE;
+		int noise_shaping_order = 0;
+		uint32_t rand_state = 0x12345678;   //xorshift32 state (any non-zero seed)
+		float32_t err[max_chan][2] = {};    //previous quantization errors, per channel (for the noise shaping)
+};
+
 class AudioOutputI2S_F32 : public AudioStream_F32
 {
 //GUI: inputs:2, outputs:0  //this line used for automatic generation of GUI node
@@ -56,14 +82,16 @@ public:
 		setInstanceName();
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples; //set size to given value
+		transfer_32bit = (settings.i2s_bits > 16);
 		if (flag_callBegin) begin(); 	
 	}
 	
 	AudioOutputI2S_F32(const AudioSettings_F32 &settings, uint32_t *tx_buff) : AudioOutputI2S_F32(settings, tx_buff, true) {setInstanceName(); }
-	AudioOutputI2S_F32(const AudioSettings_F32 &settings, uint32_t *tx_buff, bool flag_callBegin) : AudioStream_F32(2, inputQueueArray) { 
+	AudioOutputI2S_F32(const AudioSettings_F32 &settings, uint32_t *tx_buff, bool flag_callBegin) : AudioStream_F32(2, inputQueueArray) { //tx_buff must hold audio_block_samples uint32s (16-bit) or 2*audio_block_samples (32-bit)
 		setInstanceName();
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		i2s_tx_buffer = tx_buff;
 		if (flag_callBegin) begin();  
 	}
@@ -90,8 +118,20 @@ public:
 	static void scale_f32_to_i16( float32_t *p_f32, float32_t *p_i16, int len) ;
 	static void scale_f32_to_i24( float32_t *p_f32, float32_t *p_i16, int len) ;
 	static void scale_f32_to_i32( float32_t *p_f32, float32_t *p_i32, int len) ;
+	static void convert_f32_to_q31( float32_t *p_f32, float32_t *p_q31, int len) ;  //for 32-bit transfers.  Output is q31_t stored in the float array
+
+	//dither and noise shaping for 16-bit transfers (see AudioOutputDither_F32).  The settings are per output.
+	enum DITHER_TYPE { DITHER_NONE=AudioOutputDither_F32::DITHER_NONE, DITHER_TPDF=AudioOutputDither_F32::DITHER_TPDF };
+	int setDither(int type) { return dither.setDither(type); }
+	int getDither(void) const { return dither.getDither(); }
+	int setNoiseShaping(int order) { return dither.setNoiseShaping(order); } //0 (off), 1, or 2
+	int getNoiseShaping(void) const { return dither.getNoiseShaping(); }
+	bool get_isDitherActive(void) const { return dither.isActive(); }
+	void resetDitherStates(void) { dither.reset(); }
+
 	static float setI2SFreq_T3(const float);
 	static uint32_t *i2s_tx_buffer;
+	static bool get_isTransfer32bit(void) { return transfer_32bit; }
 protected:
 	AudioOutputI2S_F32(int dummy): AudioStream_F32(2, inputQueueArray) {} // to be used only inside AudioOutputI2Sslave !!
 	static void config_i2s(void);
@@ -104,9 +144,11 @@ protected:
 	static audio_block_f32_t *block_right_1st;
 	static bool update_responsibility;
 	static DMAChannel dma;
+	static bool transfer_32bit;  //if true, the samples are sent as full 32-bit words (as q31) instead of 16-bit
 	static void isr_16(void);
 	static void isr_32(void);
 	static void isr(void);
+	AudioOutputDither_F32 dither;
 private:
 	static audio_block_f32_t *block_left_2nd;
 	static audio_block_f32_t *block_right_2nd;
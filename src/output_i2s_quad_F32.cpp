@@ -65,7 +65,7 @@ uint32_t  AudioOutputI2SQuad_F32::ch4_offset = 0;
 bool AudioOutputI2SQuad_F32::update_responsibility = false;
 //DMAMEM __attribute__((aligned(32))) static uint32_t i2s_tx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32/2*4];  //pack 2 int16s into 1 int32 to make dense, so that 4 channels = 4*(audio_block_samples/2)
 //DMAMEM static uint32_t i2s_tx_buffer[AUDIO_BLOCK_SAMPLES*4];  //pack 1 int32 into 1 int32 to make dense, so that 4 channels = 4*(audio_block_samples)
-DMAMEM __attribute__((aligned(32))) static uint32_t i2s_default_tx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32/2*4];  //pack 2 int16s into 1 int32 to make dense, so that 4 channels = 4*(audio_block_samples/2)
+DMAMEM __attribute__((aligned(32))) static uint32_t i2s_default_tx_buffer[MAX_AUDIO_BLOCK_SAMPLES_F32*4];  //big enough for 32-bit transfers.  For 16-bit, 2 int16s get packed into each int32
 uint32_t * AudioOutputI2SQuad_F32::i2s_tx_buffer = i2s_default_tx_buffer;
 DMAChannel AudioOutputI2SQuad_F32::dma(false);
 
@@ -77,13 +77,10 @@ float32_t * AudioOutputI2SQuad_F32::zerodata = default_zerodata;
 //initialize some static variables.  Likely get overwritten by constructor.
 float AudioOutputI2SQuad_F32::sample_rate_Hz = AUDIO_SAMPLE_RATE;
 int AudioOutputI2SQuad_F32::audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32;
+bool AudioOutputI2SQuad_F32::transfer_32bit = false;
 
-//for 16-bit transfers (into a 32-bit data type) multiplied by 4 channels
-#define I2S_BUFFER_TO_USE_BYTES ((AudioOutputI2SQuad_F32::audio_block_samples)*4*sizeof(i2s_tx_buffer[0])/2)
-
-
-//for 32-bit transfers (into a 32-bit data type) multiplied by 4 channels
-//#define I2S_BUFFER_TO_USE_BYTES ((AudioOutputI2SQuad_F32::audio_block_samples)*4*sizeof(i2s_tx_buffer[0]))
+//for 16-bit transfers (into a 32-bit data type) multiplied by 4 channels.  For 32-bit transfers, it's twice as big.
+#define I2S_BUFFER_TO_USE_BYTES ((AudioOutputI2SQuad_F32::audio_block_samples)*4*sizeof(i2s_tx_buffer[0])/2*(AudioOutputI2SQuad_F32::transfer_32bit ? 2 : 1))
 
 void AudioOutputI2SQuad_F32::begin(void)
 {
@@ -96,6 +93,11 @@ void AudioOutputI2SQuad_F32::begin(void)
 	block_ch4_1st = NULL;
 
 	#if defined(KINETISK) //this code is for Teensy 3.x, not Teensy 4
+		if (transfer_32bit) {
+			//the Teensy 3.x quad I2S is set up with 16-bit slots
+			Serial.println(F("AudioOutputI2SQuad_F32: begin: *** WARNING ***: 32-bit transfers are not supported on Teensy 3.x.  Using 16-bit."));
+			transfer_32bit = false;
+		}
 		// TODO: can we call normal config_i2s, and then just enable the extra output?
 		config_i2s();  //this is the local config_i2s(), not the one in the non-quad version of output_i2s.  does it know about block size?  (sample rate is defined is set ~25 rows below here)
 		CORE_PIN22_CONFIG = PORT_PCR_MUX(6); // pin 22, PTC1, I2S0_TXD0 -> ch1 & ch2
@@ -130,8 +132,7 @@ void AudioOutputI2SQuad_F32::begin(void)
 	
 		const int pinoffset = 0; // TODO: make this configurable...
 		//memset(i2s_tx_buffer, 0, sizeof(i2s_tx_buffer)); //WEA 2023-09-28: commented out because we've already initialized the array to zero when we created the array 
-		bool transferUsing32bit = false;  //32 bit from AIC doesn't work with quad?  so don't change this?
-		AudioOutputI2S_F32::config_i2s(transferUsing32bit,AudioOutputI2SQuad_F32::sample_rate_Hz);
+		AudioOutputI2S_F32::config_i2s(transfer_32bit,AudioOutputI2SQuad_F32::sample_rate_Hz); //the slots are 32 bits either way
 		I2S1_TCR3 = I2S_TCR3_TCE_2CH << pinoffset;
 		switch (pinoffset) {
 		  case 0:
@@ -146,21 +147,25 @@ void AudioOutputI2SQuad_F32::begin(void)
 			CORE_PIN9_CONFIG  = 3;
 			CORE_PIN6_CONFIG  = 3;
 		}
+		//Each minor loop writes one sample to each of the two data lines (TDR0 and TDR1).  For 16-bit
+		//transfers, only write the upper half of each 32-bit slot (hence the "+ 2").
+		const int xfer_bytes = transfer_32bit ? 4 : 2;  //bytes per sample
+		const int xfer_size = transfer_32bit ? 2 : 1;   //DMA size code: 1 = 16-bit, 2 = 32-bit
 		dma.TCD->SADDR = i2s_tx_buffer;
-		dma.TCD->SOFF = 2;  //is 2 in Teensy 
-		dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(1) | DMA_TCD_ATTR_DSIZE(1);
+		dma.TCD->SOFF = xfer_bytes;  //is 2 in Teensy 
+		dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
 		dma.TCD->NBYTES_MLOFFYES = DMA_TCD_NBYTES_DMLOE |
 			DMA_TCD_NBYTES_MLOFFYES_MLOFF(-8) |
-			DMA_TCD_NBYTES_MLOFFYES_NBYTES(4);
+			DMA_TCD_NBYTES_MLOFFYES_NBYTES(2*xfer_bytes);
 		//dma.TCD->SLAST = -sizeof(i2s_tx_buffer); //original from Teensy Audio Library
 		dma.TCD->SLAST = -I2S_BUFFER_TO_USE_BYTES; //allows for variable audio block length
-		dma.TCD->DADDR = (void *)((uint32_t)&I2S1_TDR0 + 2 + pinoffset * 4);
+		dma.TCD->DADDR = (void *)((uint32_t)&I2S1_TDR0 + (transfer_32bit ? 0 : 2) + pinoffset * 4);
 		dma.TCD->DOFF = 4;
 		//dma.TCD->CITER_ELINKNO = AUDIO_BLOCK_SAMPLES * 2; //original from Teensy Audio Library (16-bit)
-		dma.TCD->CITER_ELINKNO = audio_block_samples * 2; //allows for variable audio block length (assumes 16-bit?)
+		dma.TCD->CITER_ELINKNO = audio_block_samples * 2; //allows for variable audio block length (same for 16-bit or 32-bit)
 		dma.TCD->DLASTSGA = -8;
 		//dma.TCD->BITER_ELINKNO = AUDIO_BLOCK_SAMPLES * 2; //original from Teensy Audio Library (16-bit)
-		dma.TCD->BITER_ELINKNO = audio_block_samples * 2; //allows for variable audio block length (assumes 16-bit?)
+		dma.TCD->BITER_ELINKNO = audio_block_samples * 2; //allows for variable audio block length (same for 16-bit or 32-bit)
 		dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
 		dma.triggerAtHardwareEvent(DMAMUX_SOURCE_SAI1_TX);
 		dma.enable();
@@ -200,7 +205,7 @@ void AudioOutputI2SQuad_F32::isr_shuffleDataBlocks(audio_block_f32_t *&block_1st
 	uint32_t saddr;
 	float32_t *src1, *src2, *src3, *src4;
 	float32_t *zeros = (float32_t *)zerodata;
-	int16_t *dest;
+	void *dest;
 	
 	//update the dma and get pointer for the destination tx buffer
 	saddr = (uint32_t)(dma.TCD->SADDR);
@@ -209,10 +214,10 @@ void AudioOutputI2SQuad_F32::isr_shuffleDataBlocks(audio_block_f32_t *&block_1st
 	if (saddr < (uint32_t)i2s_tx_buffer + I2S_BUFFER_TO_USE_BYTES / 2) { //variable audio block length
 		// DMA is transmitting the first half of the buffer so we must fill the second half
 		//dest = (int16_t *)&i2s_tx_buffer[AUDIO_BLOCK_SAMPLES]; //orig
-		dest = (int16_t *)&i2s_tx_buffer[audio_block_samples]; //new
+		dest = (void *)((uint32_t)i2s_tx_buffer + I2S_BUFFER_TO_USE_BYTES / 2); //new
 		if (AudioOutputI2SQuad_F32::update_responsibility) AudioStream_F32::update_all();
 	} else {
-		dest = (int16_t *)i2s_tx_buffer;  //start of the TX buffer
+		dest = (void *)i2s_tx_buffer;  //start of the TX buffer
 	}
 
 	//get pointers for source data that we will copy into the tx buffer
@@ -251,15 +256,27 @@ void AudioOutputI2SQuad_F32::isr_shuffleDataBlocks(audio_block_f32_t *&block_1st
 //		*d++ = (int16_t)((q15_t)(*src4++ * 32768)); //right 2...does the q15_t ensure saturating math?
 //	}
 	
-	//This block of code assumes that the audio data HAS ALREADY been scaled to +/-32767.0
-	//interleave the given source data into the output array
-	int16_t *d = dest;
-	for (int i=0; i < audio_block_samples / 2; i++) {
-		*d++ = (int16_t)(*src1++); //left 1
-		*d++ = (int16_t)(*src3++); //left 2  (note it is src3, not src2!!!)
-		*d++ = (int16_t)(*src2++); //right 1 (note it is src2, not src3!!!
-		*d++ = (int16_t)(*src4++); //right 2
-	}	
+	if (transfer_32bit) {
+		//update() has already converted the data to q31 (in place of the floats), so just interleave the words
+		const int32_t *s1 = (const int32_t *)src1, *s2 = (const int32_t *)src2, *s3 = (const int32_t *)src3, *s4 = (const int32_t *)src4;
+		int32_t *d = (int32_t *)dest;
+		for (int i=0; i < audio_block_samples / 2; i++) {
+			*d++ = *s1++; //left 1
+			*d++ = *s3++; //left 2  (note it is src3, not src2!!!)
+			*d++ = *s2++; //right 1 (note it is src2, not src3!!!
+			*d++ = *s4++; //right 2
+		}
+	} else {
+		//This block of code assumes that the audio data HAS ALREADY been scaled to +/-32767.0
+		//interleave the given source data into the output array
+		int16_t *d = (int16_t *)dest;
+		for (int i=0; i < audio_block_samples / 2; i++) {
+			*d++ = (int16_t)(*src1++); //left 1
+			*d++ = (int16_t)(*src3++); //left 2  (note it is src3, not src2!!!)
+			*d++ = (int16_t)(*src2++); //right 1 (note it is src2, not src3!!!
+			*d++ = (int16_t)(*src4++); //right 2
+		}	
+	}
 
 #endif
 	//arm_dcache_flush_delete(dest, sizeof(i2s_tx_buffer) / 2 );  //clear out this number of bytes..which should equal AUDIO_BLOCK_SAMPLES/2 * 4chan * 2bytes/samp
@@ -320,8 +337,13 @@ void AudioOutputI2SQuad_F32::update_1chan(const int chan,  //this is not changed
 			}
 		} 
 		
-		//scale the F32 data (+/- 1.0) to fit within Int16 (+/- 32767.0), though we're still float32 data type
-		AudioOutputI2S_F32::scale_f32_to_i16(block_f32->data, block_f32_scaled->data, audio_block_samples);
+		if (transfer_32bit) {
+			//convert the F32 data to q31, stored in place of the floats.  The isr() copies the words directly.
+			AudioOutputI2S_F32::convert_f32_to_q31(block_f32->data, block_f32_scaled->data, audio_block_samples);
+		} else {
+			//scale the F32 data (+/- 1.0) to fit within Int16 (+/- 32767.0), though we're still float32 data type
+			dither.scale_f32_to_i16_auto(block_f32->data, block_f32_scaled->data, audio_block_samples, chan); //with dither, if enabled
+		}
 		
 		//set the metadaa
 		block_f32_scaled->length = block_f32->length;
@@ -58,13 +58,15 @@ public:
 		setInstanceName(); 
 		sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		if (flag_callBegin) begin(); 	
 	}
 	AudioOutputI2SQuad_F32(const AudioSettings_F32 &settings, uint32_t *tx_buff) : AudioOutputI2SQuad_F32(settings, tx_buff, true) { setInstanceName(); } 
-	AudioOutputI2SQuad_F32(const AudioSettings_F32 &settings, uint32_t *tx_buff, bool flag_callBegin) : AudioStream_F32(4, inputQueueArray) { 
+	AudioOutputI2SQuad_F32(const AudioSettings_F32 &settings, uint32_t *tx_buff, bool flag_callBegin) : AudioStream_F32(4, inputQueueArray) { //tx_buff must hold 2*audio_block_samples uint32s (16-bit) or 4*audio_block_samples (32-bit)
 		 setInstanceName(); 
 		 sample_rate_Hz = settings.sample_rate_Hz;
 		audio_block_samples = settings.audio_block_samples;
+		transfer_32bit = (settings.i2s_bits > 16);
 		i2s_tx_buffer = tx_buff;
 		zerodata = new float32_t[settings.audio_block_samples/2]{0}; //Need zeros for half an audio block, just 1 channel, init to zero
 		if (flag_callBegin) begin(); 
@@ -82,8 +84,18 @@ public:
 	//static void scale_f32_to_i24( float32_t *p_f32, float32_t *p_i16, int len) ;
 	//static void scale_f32_to_i32( float32_t *p_f32, float32_t *p_i32, int len) ;
 	static uint32_t *i2s_tx_buffer;
+	static bool get_isTransfer32bit(void) { return transfer_32bit; }
+
+	//dither and noise shaping for 16-bit transfers (see AudioOutputDither_F32).  The settings are per output.
+	int setDither(int type) { return dither.setDither(type); }
+	int getDither(void) const { return dither.getDither(); }
+	int setNoiseShaping(int order) { return dither.setNoiseShaping(order); } //0 (off), 1, or 2
+	int getNoiseShaping(void) const { return dither.getNoiseShaping(); }
+	bool get_isDitherActive(void) const { return dither.isActive(); }
+	void resetDitherStates(void) { dither.reset(); }
 protected: 
 	static void config_i2s(void);
+	static bool transfer_32bit;  //if true, the samples are sent as full 32-bit words (as q31) instead of 16-bit
 	static audio_block_f32_t *block_ch1_1st;
 	static audio_block_f32_t *block_ch2_1st;
 	static audio_block_f32_t *block_ch3_1st;
@@ -93,6 +105,7 @@ protected:
 	static void isr(void);
 	static void isr_shuffleDataBlocks(audio_block_f32_t *&, audio_block_f32_t *&, uint32_t &);
 	void update_1chan(const int, audio_block_f32_t *&, audio_block_f32_t *&, uint32_t &);
+	AudioOutputDither_F32 dither;
 private:
 	static audio_block_f32_t *block_ch1_2nd;
 	static audio_block_f32_t *block_ch2_2nd;
@@ -0,0 +1,101 @@
+/*
+ * AudioOutputTDM_F32 / AudioInputTDM_F32 (the non-templated parts)
+ *
+ * Created: 2026
+ * Purpose: Configure SAI1 for TDM.  Based on AudioOutputI2S_F32::config_i2s() and on the Teensy
+ *     Audio library's AudioOutputTDM::config_tdm().
+ *
+ * MIT License.  use at your own risk.
+*/
+
+#include "output_tdm_F32.h"
+
+#if defined(__IMXRT1062__)
+//defined in output_i2s_F32.cpp
+extern void set_audioClock_tympan(int nfact, int32_t nmult, uint32_t ndiv, bool force);
+#endif
+
+void *AudioTDMBase_F32::allocateDMABuffer(const int n_bytes) {
+	//pad to whole 32-byte cache lines so that the cache operations never touch neighboring memory.
+	//The buffers live for the life of the program, so the raw allocation is never freed.
+	const int n_bytes_padded = ((n_bytes + 31) / 32) * 32;
+	uint8_t *raw = new uint8_t[n_bytes_padded + 32];
+	if (raw == NULL) return NULL;
+	uint8_t *aligned = (uint8_t *)((((uint32_t)raw) + 31) & ~((uint32_t)31));
+	memset(aligned, 0, n_bytes_padded);
+	return (void *)aligned;
+}
+
+void AudioTDMBase_F32::config_tdm(const int n_slots, const float fs_Hz)
+{
+#if defined(__IMXRT1062__)
+	if (!isValidSlotCount(n_slots)) {
+		Serial.print(F("AudioTDMBase_F32: config_tdm: *** ERROR ***: n_slots must be 2, 4, 8, or 16, not ")); Serial.println(n_slots);
+		return;
+	}
+
+	CCM_CCGR5 |= CCM_CCGR5_SAI1(CCM_CCGR_ON);
+
+	// if either transmitter or receiver is enabled, do nothing
+	if ((I2S1_TCSR & I2S_TCSR_TE) != 0 || (I2S1_RCSR & I2S_RCSR_RE) != 0) return;
+
+	//Each frame is n_slots slots of 32 bits, so BCLK = 32 * n_slots * fs.  The SAI divides MCLK by an even
+	//number to get BCLK, so MCLK must be at least 64 * n_slots * fs.  Use 256 * fs (like I2S) when possible.
+	const int mclk_mult = max(256, 64*n_slots);
+	const int bclk_div = mclk_mult / (64*n_slots) - 1;  //BCLK = MCLK / ((bclk_div+1)*2)
+
+	//PLL (see AudioOutputI2S_F32::config_i2s()):
+	int fs = fs_Hz;
+	int n1 = 4; //SAI prescaler 4 => (n1*n2) = multiple of 4
+	int n2;
+	while ((n2 = 1 + (24000000.f * 27.f) / (fs * (float)mclk_mult * n1)) > 64) { //do not allow n2 to be greater than 64
+		n1 *= 2;
+	}
+
+	double C = ((double)fs * mclk_mult * n1 * n2) / 24000000.f;
+	int c0 = C;
+	int c2 = 10000;
+	int c1 = C * c2 - (c0 * c2);
+	set_audioClock_tympan(c0, c1, c2, false);
+
+	// clear SAI1_CLK register locations
+	CCM_CSCMR1 = (CCM_CSCMR1 & ~(CCM_CSCMR1_SAI1_CLK_SEL_MASK))
+		   | CCM_CSCMR1_SAI1_CLK_SEL(2); // &0x03 // (0,1,2): PLL3PFD0, PLL5, PLL4
+	CCM_CS1CDR = (CCM_CS1CDR & ~(CCM_CS1CDR_SAI1_CLK_PRED_MASK | CCM_CS1CDR_SAI1_CLK_PODF_MASK))
+		   | CCM_CS1CDR_SAI1_CLK_PRED(n1-1)
+		   | CCM_CS1CDR_SAI1_CLK_PODF(n2-1);
+
+	// Select MCLK
+	IOMUXC_GPR_GPR1 = (IOMUXC_GPR_GPR1
+		& ~(IOMUXC_GPR_GPR1_SAI1_MCLK1_SEL_MASK))
+		| (IOMUXC_GPR_GPR1_SAI1_MCLK_DIR | IOMUXC_GPR_GPR1_SAI1_MCLK1_SEL(0));
+
+	CORE_PIN23_CONFIG = 3;  //1:MCLK
+	CORE_PIN21_CONFIG = 3;  //1:RX_BCLK
+	CORE_PIN20_CONFIG = 3;  //1:RX_SYNC  (frame sync)
+
+	int rsync = 0;
+	int tsync = 1;
+
+	//TDM: a one-bit frame sync (active high, one bit early), then n_slots slots of 32 bits
+	I2S1_TMR = 0;
+	I2S1_TCR1 = I2S_TCR1_RFW(4);
+	I2S1_TCR2 = I2S_TCR2_SYNC(tsync) | I2S_TCR2_BCP
+		    | (I2S_TCR2_BCD | I2S_TCR2_DIV(bclk_div) | I2S_TCR2_MSEL(1));
+	I2S1_TCR3 = I2S_TCR3_TCE;
+	I2S1_TCR4 = I2S_TCR4_FRSZ((n_slots-1)) | I2S_TCR4_SYWD(0) | I2S_TCR4_MF
+		    | I2S_TCR4_FSD | I2S_TCR4_FSE;
+	I2S1_TCR5 = I2S_TCR5_WNW((32-1)) | I2S_TCR5_W0W((32-1)) | I2S_TCR5_FBT((32-1));
+
+	I2S1_RMR = 0;
+	I2S1_RCR1 = I2S_RCR1_RFW(4);
+	I2S1_RCR2 = I2S_RCR2_SYNC(rsync) | I2S_RCR2_BCP
+		    | (I2S_RCR2_BCD | I2S_RCR2_DIV(bclk_div) | I2S_RCR2_MSEL(1));
+	I2S1_RCR3 = I2S_RCR3_RCE;
+	I2S1_RCR4 = I2S_RCR4_FRSZ((n_slots-1)) | I2S_RCR4_SYWD(0) | I2S_RCR4_MF
+		    | I2S_RCR4_FSE | I2S_RCR4_FSD;
+	I2S1_RCR5 = I2S_RCR5_WNW((32-1)) | I2S_RCR5_W0W((32-1)) | I2S_RCR5_FBT((32-1));
+#else
+	Serial.println(F("AudioTDMBase_F32: config_tdm: *** ERROR ***: TDM is only supported on Teensy 4 (Tympan RevE and later)."));
+#endif
+}
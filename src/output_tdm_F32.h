@@ -0,0 +1,249 @@
+/*
+ * AudioOutputTDM_F32
+ *
+ * Created: 2026
+ * Purpose: Send N_SLOTS channels of audio over TDM (one data line, N_SLOTS 32-bit slots per frame)
+ *     to a multi-channel codec.  Modeled on AudioOutputI2SQuad_F32 and on the Teensy Audio library's
+ *     AudioOutputTDM, but the number of slots (2, 4, 8, or 16) and the bit depth (16 or 32) are
+ *     template parameters, so one class covers every TDM codec.  Individual slots can be disabled,
+ *     in which case they send silence and cost no CPU.
+ *
+ *     Example: AudioOutputTDM_F32<8> tdm_out(audio_settings);  //8 slots, 16-bit data
+ *              AudioOutputTDM_F32<16,32> tdm_out(audio_settings); //16 slots, full 32-bit data
+ *
+ *     Only for Teensy 4 (Tympan RevE and later).  The TDM classes use SAI1, so they cannot be used
+ *     alongside AudioInputI2S_F32 / AudioOutputI2S_F32.
+ *
+ * MIT License.  use at your own risk.
+*/
+
+#ifndef _output_tdm_f32_h_
+#define _output_tdm_f32_h_
+
+#include <Arduino.h>
+#include <arm_math.h>
+#include <type_traits>  //for std::conditional
+#include "AudioStream_F32.h"
+#include "DMAChannel.h"
+
+// Non-templated pieces shared by all of the TDM inputs and outputs (there is only one SAI1 to configure)
+class AudioTDMBase_F32 {
+	public:
+		static const int max_slots = 16;
+		static bool isValidSlotCount(const int n_slots) { return (n_slots >= 2) && (n_slots <= max_slots) && ((n_slots & (n_slots-1)) == 0); }
+		static void config_tdm(const int n_slots, const float fs_Hz); //set up the SAI1 clocks for n_slots 32-bit slots per frame
+		static void *allocateDMABuffer(const int n_bytes);             //zeroed and 32-byte aligned (for the cache operations)
+};
+
+// Which slots (channels) are in use.  Disabled slots are skipped entirely by update().
+template <int N_SLOTS>
+class AudioTDMSlots_F32 {
+	public:
+		AudioTDMSlots_F32(void) { setAllSlotsEnabled(true); }
+		bool setSlotEnabled(const int slot, const bool enable) {
+			if ((slot < 0) || (slot >= N_SLOTS)) return false;
+
+			//build the new list here, then swap it in all at once so that update() never sees a half-built list
+			uint8_t new_slots[N_SLOTS];
+			int n_new = 0;
+			for (int i=0; i < N_SLOTS; i++) if ((i == slot) ? enable : slot_enabled[i]) new_slots[n_new++] = i;
+			__disable_irq();
+			slot_enabled[slot] = enable;
+			for (int k=0; k < n_new; k++) active_slots[k] = new_slots[k];
+			n_active_slots = n_new;
+			__enable_irq();
+			return enable;
+		}
+		bool getSlotEnabled(const int slot) const { return ((slot >= 0) && (slot < N_SLOTS)) ? slot_enabled[slot] : false; }
+		void setAllSlotsEnabled(const bool enable) { for (int i=0; i < N_SLOTS; i++) setSlotEnabled(i, enable); }
+		int getNumSlots(void) const { return N_SLOTS; }
+		int getNumEnabledSlots(void) const { return n_active_slots; }
+	protected:
+		bool slot_enabled[N_SLOTS] = {};
+		uint8_t active_slots[N_SLOTS];  //the enabled slots, in order
+		int n_active_slots = 0;
+};
+
+template <int N_SLOTS, int BITS = 16>
+class AudioOutputTDM_F32 : public AudioStream_F32, public AudioTDMSlots_F32<N_SLOTS>
+{
+	static_assert((N_SLOTS == 2) || (N_SLOTS == 4) || (N_SLOTS == 8) || (N_SLOTS == 16), "AudioOutputTDM_F32: N_SLOTS must be 2, 4, 8, or 16");
+	static_assert((BITS == 16) || (BITS == 24) || (BITS == 32), "AudioOutputTDM_F32: BITS must be 16, 24, or 32");
+	public:
+		typedef typename std::conditional<(BITS > 16), int32_t, int16_t>::type sample_t; //how each sample is sent over the DMA
+
+		AudioOutputTDM_F32(void) : AudioStream_F32(N_SLOTS, inputQueueArray) {
+			setInstanceName();
+			audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32; //use the default size
+			begin();
+		}
+		AudioOutputTDM_F32(const AudioSettings_F32 &settings) : AudioOutputTDM_F32(settings, true) {}
+		AudioOutputTDM_F32(const AudioSettings_F32 &settings, bool flag_callBegin) : AudioStream_F32(N_SLOTS, inputQueueArray) {
+			setInstanceName();
+			sample_rate_Hz = settings.sample_rate_Hz;
+			audio_block_samples = settings.audio_block_samples;
+			if (flag_callBegin) begin();
+		}
+		void setInstanceName(void) { instanceName = "AudioOutputTDM_F32"; }
+
+		void begin(void);
+		void update(void) override;
+
+		//disable a slot to send silence on it (and to skip its processing).  Its input is then ignored.
+		bool setSlotEnabled(const int slot, const bool enable) {
+			if (this->getSlotEnabled(slot) && !enable) clear_count[slot] = 2;  //zero this slot in both staging blocks (set before disabling, so update() sees it)
+			return AudioTDMSlots_F32<N_SLOTS>::setSlotEnabled(slot, enable);
+		}
+
+		//convert one channel from float (+/-1.0) to saturated integers, writing every N_SLOTS-th sample of dest
+		static void interleave_from_f32(const float32_t *src, sample_t *dest, const int n_frames) {
+			for (int i=0; i < n_frames; i++) { f32_to_sample(src[i], *dest);  dest += N_SLOTS; }
+		}
+
+	protected:
+		static inline void f32_to_sample(const float32_t x, int16_t &y) { y = (int16_t)(max(-32767.0f, min(32767.0f, x * 32767.0f))); }
+		static inline void f32_to_sample(const float32_t x, int32_t &y) {
+			if (x >= 1.0f) { y = 2147483647; } else if (x <= -1.0f) { y = -2147483647; } else { y = (int32_t)(x * 2147483648.0f); }
+		}
+		static void isr(void);
+		static DMAChannel dma;
+		static bool update_responsibility;
+		static float sample_rate_Hz;
+		static int audio_block_samples;
+		static sample_t *tdm_tx_buffer;         //the DMA buffer (two halves)
+		static int tdm_tx_buffer_len;
+		static sample_t *staging;               //two blocks of interleaved samples, filled alternately by update()
+		static int staging_len;
+		static sample_t * volatile play_block;  //the staging block that the ISR is sending, or NULL for silence
+		static sample_t * volatile ready_block; //the staging block that update() has finished, or NULL
+		static int play_half;                   //which half of play_block the ISR sends next
+		audio_block_f32_t *inputQueueArray[N_SLOTS];
+		uint8_t clear_count[N_SLOTS] = {0};     //number of staging blocks in which this (disabled) slot still needs zeroing
+};
+
+template <int N_SLOTS, int BITS> DMAChannel AudioOutputTDM_F32<N_SLOTS,BITS>::dma(false);
+template <int N_SLOTS, int BITS> bool AudioOutputTDM_F32<N_SLOTS,BITS>::update_responsibility = false;
+template <int N_SLOTS, int BITS> float AudioOutputTDM_F32<N_SLOTS,BITS>::sample_rate_Hz = AUDIO_SAMPLE_RATE;
+template <int N_SLOTS, int BITS> int AudioOutputTDM_F32<N_SLOTS,BITS>::audio_block_samples = MAX_AUDIO_BLOCK_SAMPLES_F32;
+template <int N_SLOTS, int BITS> typename AudioOutputTDM_F32<N_SLOTS,BITS>::sample_t * AudioOutputTDM_F32<N_SLOTS,BITS>::tdm_tx_buffer = NULL;
+template <int N_SLOTS, int BITS> int AudioOutputTDM_F32<N_SLOTS,BITS>::tdm_tx_buffer_len = 0;
+template <int N_SLOTS, int BITS> typename AudioOutputTDM_F32<N_SLOTS,BITS>::sample_t * AudioOutputTDM_F32<N_SLOTS,BITS>::staging = NULL;
+template <int N_SLOTS, int BITS> int AudioOutputTDM_F32<N_SLOTS,BITS>::staging_len = 0;
+template <int N_SLOTS, int BITS> typename AudioOutputTDM_F32<N_SLOTS,BITS>::sample_t * volatile AudioOutputTDM_F32<N_SLOTS,BITS>::play_block = NULL;
+template <int N_SLOTS, int BITS> typename AudioOutputTDM_F32<N_SLOTS,BITS>::sample_t * volatile AudioOutputTDM_F32<N_SLOTS,BITS>::ready_block = NULL;
+template <int N_SLOTS, int BITS> int AudioOutputTDM_F32<N_SLOTS,BITS>::play_half = 0;
+
+template <int N_SLOTS, int BITS>
+void AudioOutputTDM_F32<N_SLOTS,BITS>::begin(void)
+{
+#if defined(__IMXRT1062__)
+	//allocate the DMA buffer and the staging blocks (each is one full block of interleaved samples)
+	const int n_per_block = audio_block_samples * N_SLOTS;
+	if (tdm_tx_buffer_len < n_per_block) {
+		tdm_tx_buffer = (sample_t *)AudioTDMBase_F32::allocateDMABuffer(n_per_block * sizeof(sample_t));
+		tdm_tx_buffer_len = (tdm_tx_buffer == NULL) ? 0 : n_per_block;
+	}
+	if (staging_len < 2*n_per_block) {
+		delete[] staging;
+		staging = new sample_t[2*n_per_block]();  //zeroed
+		staging_len = (staging == NULL) ? 0 : 2*n_per_block;
+	}
+	if ((tdm_tx_buffer == NULL) || (staging == NULL)) {
+		Serial.println(F("AudioOutputTDM_F32: begin: *** ERROR ***: could not allocate the buffers."));
+		return;
+	}
+	play_block = NULL;  ready_block = NULL;  play_half = 0;
+
+	dma.begin(true); // Allocate the DMA channel first
+	AudioTDMBase_F32::config_tdm(N_SLOTS, sample_rate_Hz);
+	CORE_PIN7_CONFIG  = 3;  //1:TX_DATA0
+
+	//One sample per minor loop.  The slots are 32 bits.  For 16-bit data, only write the upper half of each slot (hence the "+ 2").
+	const int xfer_bytes = sizeof(sample_t);
+	const int xfer_size = (xfer_bytes == 4) ? 2 : 1;  //DMA size code: 1 = 16-bit, 2 = 32-bit
+	dma.TCD->SADDR = tdm_tx_buffer;
+	dma.TCD->SOFF = xfer_bytes;
+	dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(xfer_size) | DMA_TCD_ATTR_DSIZE(xfer_size);
+	dma.TCD->NBYTES_MLNO = xfer_bytes;
+	dma.TCD->SLAST = -(n_per_block * xfer_bytes);
+	dma.TCD->DADDR = (void *)((uint32_t)&I2S1_TDR0 + ((xfer_bytes == 2) ? 2 : 0));
+	dma.TCD->DOFF = 0;
+	dma.TCD->CITER_ELINKNO = n_per_block;
+	dma.TCD->DLASTSGA = 0;
+	dma.TCD->BITER_ELINKNO = n_per_block;
+	dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
+	dma.triggerAtHardwareEvent(DMAMUX_SOURCE_SAI1_TX);
+	update_responsibility = update_setup();
+	dma.enable();
+
+	I2S1_RCSR |= I2S_RCSR_RE | I2S_RCSR_BCE;
+	I2S1_TCSR = I2S_TCSR_TE | I2S_TCSR_BCE | I2S_TCSR_FRDE;
+	dma.attachInterrupt(isr);
+#else
+	Serial.println(F("AudioOutputTDM_F32: begin: *** ERROR ***: TDM is only supported on Teensy 4 (Tympan RevE and later)."));
+#endif
+}
+
+template <int N_SLOTS, int BITS>
+void AudioOutputTDM_F32<N_SLOTS,BITS>::isr(void)
+{
+#if defined(__IMXRT1062__)
+	const int half_len = (audio_block_samples / 2) * N_SLOTS;  //samples in half of the DMA buffer
+	sample_t *dest;
+
+	uint32_t saddr = (uint32_t)(dma.TCD->SADDR);
+	dma.clearInterrupt();
+	if (saddr < (uint32_t)(tdm_tx_buffer + half_len)) {
+		// DMA is transmitting the first half of the buffer, so we must fill the second half
+		dest = tdm_tx_buffer + half_len;
+		if (update_responsibility) AudioStream_F32::update_all();
+	} else {
+		// DMA is transmitting the second half of the buffer, so we must fill the first half
+		dest = tdm_tx_buffer;
+	}
+
+	//at the start of each block, switch to the newest block from update() (or to silence, if there isn't one)
+	if (play_half == 0) { play_block = ready_block;  ready_block = NULL; }
+	if (play_block) {
+		memcpy(dest, play_block + play_half*half_len, half_len*sizeof(sample_t));
+	} else {
+		memset(dest, 0, half_len*sizeof(sample_t));
+	}
+	play_half = 1 - play_half;
+	arm_dcache_flush_delete(dest, half_len*sizeof(sample_t));
+#endif
+}
+
+template <int N_SLOTS, int BITS>
+void AudioOutputTDM_F32<N_SLOTS,BITS>::update(void)
+{
+	if (staging == NULL) return;  //begin() failed
+	const int n_per_block = audio_block_samples * N_SLOTS;
+
+	//fill whichever staging block the ISR is not sending
+	__disable_irq();
+	sample_t *dest = (play_block == staging) ? (staging + n_per_block) : staging;
+	if (ready_block == dest) ready_block = NULL;  //it was never sent, so we can overwrite it
+	__enable_irq();
+
+	for (int slot=0; slot < N_SLOTS; slot++) {
+		audio_block_f32_t *block = receiveReadOnly_f32(slot);
+		if (this->slot_enabled[slot]) {
+			if (block) {
+				interleave_from_f32(block->data, dest + slot, audio_block_samples);
+			} else {
+				for (int i=0; i < audio_block_samples; i++) dest[i*N_SLOTS + slot] = 0;
+			}
+		} else if (clear_count[slot] > 0) {
+			for (int i=0; i < audio_block_samples; i++) dest[i*N_SLOTS + slot] = 0;
+			clear_count[slot]--;
+		}
+		if (block) AudioStream_F32::release(block);
+	}
+
+	__disable_irq();
+	ready_block = dest;
+	__enable_irq();
+}
+
+#endif
@@ -10,6 +10,51 @@
 #include "play_queue_F32.h"
 #include "utility/dspinst.h"
 
+// The play and record queues are single-producer / single-consumer rings.  Each index has only one writer:
+// here, the main loop (playBuffer(), playAudioBlock(), writeBlocks()) writes "head" and update(), in the audio
+// interrupt, writes "tail".  Each side writes the block pointer before moving its index, and the pointers and
+// indices are all volatile, so the other side never sees a half-written entry.  No interrupt masking needed.
+
+bool AudioPlayQueue_F32::setQueueDepth(int n_blocks)
+{
+	if (n_blocks < 1) {
+		Serial.println(F("AudioPlayQueue_F32: setQueueDepth: *** ERROR ***: the depth must be at least 1."));
+		return false;
+	}
+	audio_block_f32_t * volatile *new_queue = new audio_block_f32_t *[n_blocks+1];
+	if (new_queue == NULL) {
+		Serial.println(F("AudioPlayQueue_F32: setQueueDepth: *** ERROR ***: could not allocate the queue."));
+		return false;
+	}
+
+	//swap in the new (empty) queue
+	__disable_irq();
+	audio_block_f32_t * volatile *old_queue = queue;
+	uint32_t old_len = queue_len, t = tail, h = head;
+	queue = new_queue;
+	queue_len = n_blocks+1;
+	head = 0; tail = 0;
+	flush_requested = false;  //the old queue is released below
+	__enable_irq();
+
+	//release anything that was still in the old queue
+	if (old_queue != NULL) {
+		while (t != h) {
+			if (++t >= old_len) t = 0;
+			AudioStream_F32::release(old_queue[t]);
+		}
+		delete[] old_queue;
+	}
+	return true;
+}
+
+int AudioPlayQueue_F32::availableToWrite(void)
+{
+	uint32_t h = head, t = tail;
+	uint32_t used = (h >= t) ? (h - t) : (queue_len + h - t);
+	return (int)queue_len - 1 - (int)used;
+}
+
 bool AudioPlayQueue_F32::available(void)
 {
         if (userblock) return true;
@@ -34,10 +79,9 @@ void AudioPlayQueue_F32::playBuffer(void)
 
 	if (!userblock) return;
 	h = head + 1;
-	if (h >= 32) h = 0;
+	if (h >= queue_len) h = 0;
 	while (tail == h) ; // wait until space in the queue
-	queue[h] = userblock;
-	head = h;
+	push(userblock, h);
 	userblock = NULL;
 }
 
@@ -46,14 +90,63 @@ void AudioPlayQueue_F32::update(void)
 	audio_block_f32_t *block;
 	uint32_t t;
 
+	if (queue == NULL) return;
 	t = tail;
+	if (flush_requested) {
+		//stop() was called, so discard what was in the queue at that time.  Anything queued since then is kept.
+		const uint32_t h = flush_head;
+		while (t != h) {
+			if (++t >= queue_len) t = 0;
+			AudioStream_F32::release(queue[t]);
+		}
+		tail = t;
+		flush_requested = false;
+		return;
+	}
 	if (t != head) {
-		if (++t >= 32) t = 0;
+		if (++t >= queue_len) t = 0;
 		block = queue[t];
 		tail = t;
 		AudioStream_F32::transmit(block);
 		AudioStream_F32::release(block);
+	} else if (playing) {
+		//caught up with the main loop.  If it queues more, that was an underrun.  If not, playback simply ended.
+		playing = false;
+		ran_dry = true;
+	}
+}
+
+void AudioPlayQueue_F32::stop(void)
+{
+	playing = false;
+	ran_dry = false;
+	flush_head = head;  //snapshot first, so that update() never chases blocks queued after this call
+	flush_requested = true;
+	if (userblock) {
+		AudioStream_F32::release(userblock);
+		userblock = NULL;
+	}
+}
+
+int AudioPlayQueue_F32::writeBlocks(audio_block_f32_t *blocks[], int n)
+{
+	if ((queue == NULL) || (blocks == NULL)) return 0;
+	const uint32_t t = tail;  //read once.  Space freed after this is used by the next call.
+	uint32_t h = head;
+	int n_written = 0;
+	while (n_written < n) {
+		uint32_t h_next = h + 1;
+		if (h_next >= queue_len) h_next = 0;
+		if (h_next == t) break;  //full
+		audio_block_f32_t *block = blocks[n_written++];
+		if (block == NULL) continue;
+		__disable_irq(); block->ref_count++; __enable_irq(); //take our own reference to this block
+		queue[h_next] = block;
+		h = h_next;
 	}
+	if (h != head) { head = h; startPlaying(); }  //hand all of the new blocks to update() at once
+	if (n_written < n) overrun_count += (n - n_written);
+	return n_written;
 }
 
 //assume user already has an audio_block that was NOT allocated by this
@@ -64,11 +157,10 @@ void AudioPlayQueue_F32::playAudioBlock(audio_block_f32_t *audio_block) {
 
 	if (!audio_block) return;
 	h = head + 1;
-	if (h >= 32) h = 0;
+	if (h >= queue_len) h = 0;
 	while (tail == h) ; // wait until space in the queue
-	queue[h] = audio_block;
 	audio_block->ref_count++; //take ownership of this block
-	head = h;
+	push(audio_block, h);
 	//userblock = NULL;	
 	
 }
@@ -1,9 +1,12 @@
-/* 
+/*
 *	AudioPlayQueue_F32
 *
 *	Created: Chip Audette (OpenAudio), Feb 2017
 *       Extended from on Teensy Audio Library
 *
+*	2026: Re-done as a lock-free ring (see play_queue_F32.cpp).  The depth can be set via the constructor
+*	      or setQueueDepth(), and the main loop can queue many blocks per call via writeBlocks().
+*
 *	License: MIT License.  Use at your own risk.
 */
 
@@ -13,14 +16,16 @@
 #include <Arduino.h>
 #include "AudioStream_F32.h"
 
+#define MAX_PLAY_QUEUE 32  //default queue depth (blocks)
 class AudioPlayQueue_F32 : public AudioStream_F32
 {
 //GUI: inputs:0, outputs:1 //this line used for automatic generation of GUI node
 public:
-	AudioPlayQueue_F32(void) : AudioStream_F32(0, NULL),
-		userblock(NULL), head(0), tail(0) { }
-	AudioPlayQueue_F32(const AudioSettings_F32 &settings) : AudioStream_F32(0, NULL),
-		userblock(NULL), head(0), tail(0) { }	
+	AudioPlayQueue_F32(void) : AudioStream_F32(0, NULL) { setQueueDepth(MAX_PLAY_QUEUE); }
+	AudioPlayQueue_F32(const AudioSettings_F32 &settings) : AudioStream_F32(0, NULL) { setQueueDepth(MAX_PLAY_QUEUE); }
+	AudioPlayQueue_F32(const AudioSettings_F32 &settings, int queue_depth) : AudioStream_F32(0, NULL) { setQueueDepth(queue_depth); }
+	virtual ~AudioPlayQueue_F32(void) { delete[] queue; }
+
 	//void play(int16_t data);
 	//void play(const int16_t *data, uint32_t len);
 	//void play(float32_t data);
@@ -29,13 +34,36 @@ public:
 	bool available(void);
 	float32_t * getBuffer(void);
 	void playBuffer(void);
-	void stop(void);
+	void stop(void);  //discard everything in the queue (done by the next update())
 	//bool isPlaying(void) { return playing; }
+
+	//Batch write: queue up to n blocks without waiting.  Returns the number queued; any that did not fit are
+	//counted as overruns.  Like playAudioBlock(), the queue takes its own reference to each block, so the
+	//caller still releases its own.
+	int writeBlocks(audio_block_f32_t *blocks[], int n);
+	int availableToWrite(void);  //number of blocks that can be queued right now
+
+	//Set the maximum number of blocks held in the queue.  Anything already in the queue is released.
+	bool setQueueDepth(int n_blocks);
+	int getQueueDepth(void) { return (int)queue_len - 1; }
+
+	unsigned long getOverrunCount(void) { return overrun_count; }   //blocks rejected by writeBlocks() because the queue was full
+	unsigned long getUnderrunCount(void) { return underrun_count; } //times the queue ran dry and then more blocks were queued (running dry at the end is not counted)
+	void clearOverrun(void) { overrun_count = 0; underrun_count = 0; }
 	virtual void update(void);
 private:
-	audio_block_f32_t *queue[32];
-	audio_block_f32_t *userblock;
-	volatile uint8_t head, tail;
+	//audio_block_f32_t *queue[32];
+	audio_block_f32_t * volatile *queue = NULL;  //the ring.  One slot is always left empty.
+	uint32_t queue_len = 0;                      //number of slots in the ring (queue depth + 1)
+	audio_block_f32_t *userblock = NULL;
+	volatile uint32_t head = 0, tail = 0;        //head is only written by the main loop, tail only by update()
+	volatile bool playing = false;               //set when something is queued, cleared by update() when the queue runs dry
+	volatile bool ran_dry = false;               //update() found the queue empty while playing.  Counted as an underrun only if more blocks follow.
+	volatile bool flush_requested = false;       //set by stop(), done by update()
+	volatile uint32_t flush_head = 0;            //the head when stop() was called.  update() flushes only up to here.
+	volatile unsigned long overrun_count = 0, underrun_count = 0;
+	void startPlaying(void) { if (ran_dry) { ran_dry = false; underrun_count++; } playing = true; }  //main loop only, after moving head
+	void push(audio_block_f32_t *block, uint32_t h) { queue[h] = block; head = h; startPlaying(); }
 };
 
 #endif
@@ -28,6 +28,36 @@
 #include "utility/dspinst.h"
 
 
+// Same lock-free ring as AudioPlayQueue_F32 (see play_queue_F32.cpp), but here update() writes "head" and
+// the main loop (available(), clear(), getAudioBlock(), readBlocks()) writes "tail".
+
+bool AudioRecordQueue_F32::setQueueDepth(int n_blocks)
+{
+	if (n_blocks < 1) {
+		Serial.println(F("AudioRecordQueue_F32: setQueueDepth: *** ERROR ***: the depth must be at least 1."));
+		return false;
+	}
+	audio_block_f32_t * volatile *new_queue = new audio_block_f32_t *[n_blocks+1];
+	if (new_queue == NULL) {
+		Serial.println(F("AudioRecordQueue_F32: setQueueDepth: *** ERROR ***: could not allocate the queue."));
+		return false;
+	}
+
+	//stop update() from touching the old queue while it is swapped out
+	uint8_t prev_enabled = enabled;
+	enabled = 0;
+	clear();
+	__disable_irq();
+	audio_block_f32_t * volatile *old_queue = queue;
+	queue = new_queue;
+	queue_len = n_blocks+1;
+	head = 0; tail = 0;
+	__enable_irq();
+	delete[] old_queue;
+	enabled = prev_enabled;
+	return true;
+}
+
 int AudioRecordQueue_F32::available(void)
 {
 	uint32_t h, t;
@@ -35,7 +65,7 @@ int AudioRecordQueue_F32::available(void)
 	h = head;
 	t = tail;
 	if (h >= t) return h - t;
-	return MAX_RECORD_QUEUE + h - t;
+	return queue_len + h - t;
 }
 
 void AudioRecordQueue_F32::clear(void)
@@ -46,12 +76,13 @@ void AudioRecordQueue_F32::clear(void)
 		AudioStream_F32::release(userblock);
 		userblock = NULL;
 	}
+	if (queue == NULL) return;
 	t = tail;
 	while (t != head) {
-		if (++t >= MAX_RECORD_QUEUE) t = 0;
+		if (++t >= queue_len) t = 0;
 		AudioStream_F32::release(queue[t]);
+		tail = t;
 	}
-	tail = t;
 }
 
 float32_t * AudioRecordQueue_F32::readBuffer(void)
@@ -65,7 +96,9 @@ float32_t * AudioRecordQueue_F32::readBuffer(void)
 //	userblock = queue[t];
 //	tail = t;
 //	return userblock->data;
-	return getAudioBlock()->data;
+	audio_block_f32_t *block = getAudioBlock();
+	if (block == NULL) return NULL;
+	return block->data;
 }
 
 audio_block_f32_t * AudioRecordQueue_F32::getAudioBlock(void)
@@ -73,14 +106,29 @@ audio_block_f32_t * AudioRecordQueue_F32::getAudioBlock(void)
 	uint32_t t;
 
 	if (userblock != NULL) return NULL;
+	if (queue == NULL) return NULL;
 	t = tail;
 	if (t == head) return NULL;
-	if (++t >= MAX_RECORD_QUEUE) t = 0;
+	if (++t >= queue_len) t = 0;
 	userblock = queue[t];
 	tail = t;
 	return userblock;
 }
 
+int AudioRecordQueue_F32::readBlocks(audio_block_f32_t *blocks[], int n_max)
+{
+	if ((queue == NULL) || (blocks == NULL)) return 0;
+	const uint32_t h = head;  //read once.  Blocks that arrive after this wait for the next call.
+	uint32_t t = tail;
+	int n = 0;
+	while ((n < n_max) && (t != h)) {
+		if (++t >= queue_len) t = 0;
+		blocks[n++] = queue[t];
+	}
+	tail = t;  //hand all of the slots back to update() at once
+	return n;
+}
+
 void AudioRecordQueue_F32::freeBuffer(void)
 {
 	if (userblock == NULL) return;
@@ -104,19 +152,18 @@ void AudioRecordQueue_F32::update(audio_block_f32_t *block)
 	if (block==NULL) return;
 	uint32_t h;
 
-	if (!enabled) {
+	if (!enabled || (queue == NULL)) {
 		AudioStream_F32::release(block);
 		return;
 	}
 	h = head + 1;
-	if (h >= MAX_RECORD_QUEUE) h = 0;
+	if (h >= queue_len) h = 0;
 	if (h == tail) {
 		overrun = true;
+		overrun_count++;
 		AudioStream_F32::release(block);
 	} else {
 		queue[h] = block;
 		head = h;
 	}
 }
-
-
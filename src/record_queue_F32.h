@@ -1,9 +1,12 @@
-/* 
+/*
 *	AudioRecordQueue_F32
 *
 *	Created: Chip Audette (OpenAudio), Feb 2017
 *       Extended from on Teensy Audio Library
 *
+*	2026: Re-done as a lock-free ring (see play_queue_F32.cpp).  The depth can be set via the constructor
+*	      or setQueueDepth(), and the main loop can drain many blocks per call via readBlocks().
+*
 *	License: MIT License.  Use at your own risk.
 */
 
@@ -14,15 +17,16 @@
 #include <Arduino.h>
 #include "AudioStream_F32.h"
 
-#define MAX_RECORD_QUEUE 200
+#define MAX_RECORD_QUEUE 200  //default queue depth (blocks)
 class AudioRecordQueue_F32 : public AudioStream_F32
 {
 //GUI: inputs:1, outputs:0 //this line used for automatic generation of GUI node
 public:
-	AudioRecordQueue_F32(void) : AudioStream_F32(1, inputQueueArray),
-		userblock(NULL), head(0), tail(0), enabled(0) { }
-	AudioRecordQueue_F32(const AudioSettings_F32 &settings) : AudioStream_F32(1, inputQueueArray),
-		userblock(NULL), head(0), tail(0), enabled(0) { }
+	AudioRecordQueue_F32(void) : AudioStream_F32(1, inputQueueArray) { setQueueDepth(MAX_RECORD_QUEUE); }
+	AudioRecordQueue_F32(const AudioSettings_F32 &settings) : AudioStream_F32(1, inputQueueArray) { setQueueDepth(MAX_RECORD_QUEUE); }
+	AudioRecordQueue_F32(const AudioSettings_F32 &settings, int queue_depth) : AudioStream_F32(1, inputQueueArray) { setQueueDepth(queue_depth); }
+	virtual ~AudioRecordQueue_F32(void) { end(); clear(); delete[] queue; }
+
 	void begin(void) {
 		clear();
 		enabled = 1;
@@ -34,19 +38,34 @@ public:
 	audio_block_f32_t *getAudioBlock(void);
 	void freeBuffer(void);
 	void freeAudioBlock(void);
+
+	//Batch read: pop up to n_max blocks into blocks[].  Returns the number of blocks.  The caller then owns
+	//them and must release each one (see releaseBlocks()).  Can be used alongside getAudioBlock().
+	int readBlocks(audio_block_f32_t *blocks[], int n_max);
+	static void releaseBlocks(audio_block_f32_t *blocks[], int n) { for (int i=0; i < n; i++) AudioStream_F32::release(blocks[i]); }
+
+	//Set the maximum number of blocks held in the queue.  Anything already in the queue is released.
+	bool setQueueDepth(int n_blocks);
+	int getQueueDepth(void) { return (int)queue_len - 1; }
+
 	void end(void) {
 		enabled = 0;
 	}
 	virtual void update(void);
 	virtual void update(audio_block_f32_t *);
 	bool getOverrun(void) { return overrun; }
-	void clearOverrun(void) { overrun = false; }
+	unsigned long getOverrunCount(void) { return overrun_count; }  //number of blocks dropped because the queue was full
+	void clearOverrun(void) { overrun = false; overrun_count = 0; }
 private:
 	audio_block_f32_t *inputQueueArray[1];
-	audio_block_f32_t * volatile queue[MAX_RECORD_QUEUE]; //was 53.  Increased to MAX_RECORD_QUEUE to provide deeper buffering for handling slower SD cards
-	audio_block_f32_t *userblock;
-	volatile uint8_t head, tail, enabled;
+	//audio_block_f32_t * volatile queue[MAX_RECORD_QUEUE]; //was 53.  Increased to MAX_RECORD_QUEUE to provide deeper buffering for handling slower SD cards
+	audio_block_f32_t * volatile *queue = NULL;  //the ring.  One slot is always left empty.
+	uint32_t queue_len = 0;                      //number of slots in the ring (queue depth + 1)
+	audio_block_f32_t *userblock = NULL;
+	volatile uint32_t head = 0, tail = 0;        //head is only written by update(), tail only by the main loop
+	volatile uint8_t enabled = 0;
 	volatile bool overrun = false;
+	volatile unsigned long overrun_count = 0;
 };
 
 #endif
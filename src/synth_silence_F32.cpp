@@ -25,6 +25,7 @@ void AudioSynthSilence_F32::update(void)
 				block->data[i]=0.0;
 			}
 			
+			block->is_silent = true;  //so that downstream classes can skip their processing
 			block_counter++;
 			block->id = block_counter;
 			
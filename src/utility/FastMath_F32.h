@@ -0,0 +1,202 @@
+/*
+ * FastMath_F32.h
+ *
+ * Created: 2026
+ * Purpose: One shared place for the fast dB, log, and exp conversions that are used throughout the
+ *     Tympan Library.  Previously, each class carried its own copy (db2()/undb2() in the BTNRH WDRC
+ *     classes, log10f_approx() in AudioEffectCompressor_F32, plus calls to log10f() and powf()
+ *     elsewhere).  Now, everyone can use these.
+ *
+ * Each conversion is available as a scalar function and as a block function that processes a whole
+ * array at once.  The block functions are unrolled by four so that the Cortex-M7 can overlap the
+ * (independent) calculations of neighboring samples.
+ *
+ * Precision: Each function is a template that takes the precision as its parameter.  If you don't
+ * specify a precision, you get FASTMATH_DEFAULT_PRECISION, which you can override (via #define) before
+ * including this file.  The maximum errors below were measured across the full range of (normal) floats.
+ *
+ *     PREC_FAST:     log2(): 3rd-order polynomial, abs error < 6.5e-4  (dB error < 0.004 dB)
+ *                    exp2(): 3rd-order polynomial, rel error < 7.5e-5  (dB error < 0.001 dB)
+ *                    sqrt(): bit-trick + 1 Newton step, rel error < 1.8e-3
+ *                    tanh(): Pade approximation, abs error < 2.5e-2  (clipped to +/-1 beyond +/-3)
+ *     PREC_ACCURATE: log2(): 5th-order polynomial, abs error < 2e-5    (dB error < 1.5e-4 dB)
+ *                    exp2(): 5th-order polynomial, rel error < 2e-7    (ie, near full float precision)
+ *                    sqrt(): bit-trick + 2 Newton steps, rel error < 5e-6
+ *                    tanh(): built from exp2(), abs error < 5e-7
+ *     PREC_EXACT:    the standard library functions (log2f, exp2f, sqrtf, tanhf).  Slowest.
+ *
+ * Inputs to log2() (and, hence, to the db_from_ functions) are treated as magnitudes: the sign is
+ * ignored, and zero returns a large negative number (about -127 for log2) rather than -infinity.
+ *
+ * To see the speed and accuracy on your own hardware, see the example "02-Utility/BenchmarkFastMath".
+ *
+ * MIT License.  Use at your own risk.
+ */
+
+#ifndef _FastMath_F32_h
+#define _FastMath_F32_h
+
+#include <stdint.h>
+#include <math.h>
+#include <arm_math.h>  //simply to define float32_t
+
+namespace FastMath {
+
+	enum PRECISION { PREC_FAST=0, PREC_ACCURATE=1, PREC_EXACT=2 };
+
+	#ifndef FASTMATH_DEFAULT_PRECISION
+	#define FASTMATH_DEFAULT_PRECISION (FastMath::PREC_ACCURATE)
+	#endif
+
+	//conversion constants
+	constexpr float32_t DB10_PER_LOG2 = 3.0102999566398120f;   // 10*log10(2)
+	constexpr float32_t DB20_PER_LOG2 = 6.0205999132796240f;   // 20*log10(2)
+	constexpr float32_t LOG2_PER_DB10 = 0.3321928094887362f;   // log2(10)/10
+	constexpr float32_t LOG2_PER_DB20 = 0.1660964047443681f;   // log2(10)/20
+	constexpr float32_t LOG2_E        = 1.4426950408889634f;   // log2(e)
+
+	union float_bits_t { float32_t f; int32_t i; };
+
+	// ///////////////////////////////////////////// scalar kernels
+
+	// log2(|x|)
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t log2(float32_t x) {
+		if (P == PREC_EXACT) return log2f(fabsf(x));
+
+		//split the float into its exponent E and its mantissa M (where 1.0 <= M < 2.0)
+		float_bits_t u; u.f = x;
+		int32_t E = ((u.i >> 23) & 0xFF) - 127;
+		u.i = (u.i & 0x007FFFFF) | 0x3F800000;
+		float32_t M = u.f, Y;
+
+		//polynomial approximation for log2(M), minimax fit over 1.0 <= M < 2.0
+		if (P == PREC_FAST) {
+			Y = 0.15824864f;
+			Y = Y*M - 1.0518747f;
+			Y = Y*M + 3.0478837f;
+			Y = Y*M - 2.1536205f;
+		} else {
+			Y = 0.044873589f;
+			Y = Y*M - 0.41656353f;
+			Y = Y*M + 1.6311483f;
+			Y = Y*M - 3.5507922f;
+			Y = Y*M + 5.0917103f;
+			Y = Y*M - 2.8003639f;
+		}
+		return Y + (float32_t)E;
+	}
+
+	// 2^x
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t exp2(float32_t x) {
+		if (P == PREC_EXACT) return exp2f(x);
+
+		//keep the result within the range of normal floats
+		if (x < -126.0f) x = -126.0f;
+		if (x > 127.99f) x = 127.99f;
+
+		//split into an integer part (which goes straight into the exponent) and fractional part
+		int32_t I = (int32_t)x;
+		if (x < (float32_t)I) I--;   //floor() for negative numbers
+		float32_t F = x - (float32_t)I, Y;
+
+		//polynomial approximation for 2^F, minimax (relative error) fit over 0.0 <= F < 1.0
+		if (P == PREC_FAST) {
+			Y = 0.078024520f;
+			Y = Y*F + 0.22606716f;
+			Y = Y*F + 0.69583354f;
+			Y = Y*F + 0.99992522f;
+		} else {
+			Y = 0.0018775766f;
+			Y = Y*F + 0.0089893402f;
+			Y = Y*F + 0.055826318f;
+			Y = Y*F + 0.24015362f;
+			Y = Y*F + 0.69315307f;
+			Y = Y*F + 0.99999993f;
+		}
+
+		//scale by 2^I by adding I to the exponent
+		float_bits_t u; u.f = Y;
+		u.i += (I << 23);
+		return u.f;
+	}
+
+	// sqrt(x), for x >= 0
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t sqrt(float32_t x) {
+		if (x <= 0.0f) return 0.0f;
+		if (P == PREC_EXACT) return sqrtf(x);
+
+		//initial guess of 1/sqrt(x) from the bits of the float, then refine with Newton steps
+		float_bits_t u; u.f = x;
+		u.i = 0x5F375A86 - (u.i >> 1);
+		float32_t r = u.f, half_x = 0.5f*x;
+		r = r * (1.5f - half_x*r*r);
+		if (P != PREC_FAST) r = r * (1.5f - half_x*r*r);
+		return x*r;
+	}
+
+	// tanh(x)
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t tanh(float32_t x) {
+		if (P == PREC_EXACT) return tanhf(x);
+		if (P == PREC_FAST) {
+			if (x >= 3.0f) return 1.0f;
+			if (x <= -3.0f) return -1.0f;
+			float32_t x2 = x*x;
+			return x * (27.0f + x2) / (27.0f + 9.0f*x2);
+		}
+		//tanh(|x|) = (1 - e^(-2|x|)) / (1 + e^(-2|x|))
+		float32_t ax = fabsf(x);
+		if (ax > 9.0f) return (x > 0.0f) ? 1.0f : -1.0f;
+		float32_t t = exp2<P>(-2.0f*LOG2_E*ax);
+		float32_t y = (1.0f - t) / (1.0f + t);
+		return (x < 0.0f) ? -y : y;
+	}
+
+	// 10*log10(|x|), for power-like quantities (ie, signal squared)
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t db_from_pow(float32_t x) { return DB10_PER_LOG2 * log2<P>(x); }
+
+	// 20*log10(|x|), for amplitude-like quantities (ie, signal or envelope)
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t db_from_amp(float32_t x) { return DB20_PER_LOG2 * log2<P>(x); }
+
+	// 10^(x/20), returns an amplitude-like quantity
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t amp_from_db(float32_t x_dB) { return exp2<P>(LOG2_PER_DB20 * x_dB); }
+
+	// 10^(x/10), returns a power-like quantity
+	template <int P = FASTMATH_DEFAULT_PRECISION>
+	inline float32_t pow_from_db(float32_t x_dB) { return exp2<P>(LOG2_PER_DB10 * x_dB); }
+
+	// ///////////////////////////////////////////// block kernels
+	// Each processes n samples from x into y.  In-place operation (x == y) is fine.
+
+	#define _FASTMATH_BLOCK_KERNEL(NAME)                                               \
+	template <int P = FASTMATH_DEFAULT_PRECISION>                                      \
+	inline void NAME(const float32_t *x, float32_t *y, int n) {                        \
+		int i = 0;                                                                     \
+		for ( ; i <= n-4; i += 4) {                                                    \
+			float32_t y0 = NAME<P>(x[i]),   y1 = NAME<P>(x[i+1]);                      \
+			float32_t y2 = NAME<P>(x[i+2]), y3 = NAME<P>(x[i+3]);                      \
+			y[i] = y0; y[i+1] = y1; y[i+2] = y2; y[i+3] = y3;                          \
+		}                                                                              \
+		for ( ; i < n; i++) y[i] = NAME<P>(x[i]);                                      \
+	}
+
+	_FASTMATH_BLOCK_KERNEL(log2)
+	_FASTMATH_BLOCK_KERNEL(exp2)
+	_FASTMATH_BLOCK_KERNEL(sqrt)
+	_FASTMATH_BLOCK_KERNEL(tanh)
+	_FASTMATH_BLOCK_KERNEL(db_from_pow)
+	_FASTMATH_BLOCK_KERNEL(db_from_amp)
+	_FASTMATH_BLOCK_KERNEL(amp_from_db)
+	_FASTMATH_BLOCK_KERNEL(pow_from_db)
+
+	#undef _FASTMATH_BLOCK_KERNEL
+
+} //end namespace FastMath
+
+#endif
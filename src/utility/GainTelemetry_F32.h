@@ -0,0 +1,118 @@
+/*
+ * GainTelemetry_F32.h
+ *
+ * Created: 2026
+ * Purpose: Log what a compressor is doing (its input level, its gain, and its output level) at a
+ *     fixed, decimated rate (such as 100 Hz) so that the main loop (or the BLE code) can retrieve
+ *     a complete history rather than just polling the most recent value.
+ *
+ * The audio processing (the writer) adds one entry per decimation period.  The main loop (the reader)
+ * pulls out entries in batches via read().  There is exactly one writer and one reader, so the ring
+ * buffer is lock-free: the writer only ever changes "head" and the reader only ever changes "tail".
+ * If the reader falls behind and the ring fills up, new entries are dropped (and counted) rather than
+ * overwriting entries that the reader might be in the middle of copying.
+ *
+ * Usage on the audio side (inside the compressor), once per audio block of n samples:
+ *
+ *    for (int k = telemetry.firstIndex(); k < n; k += telemetry.getDecimation()) telemetry.push(k, in_dB[k], gain_dB[k]);
+ *    telemetry.advance(n);
+ *
+ * MIT License.  Use at your own risk.
+ */
+
+#ifndef _GainTelemetry_F32_h
+#define _GainTelemetry_F32_h
+
+#include <Arduino.h>   //for __disable_irq() and __enable_irq()
+#include <stdint.h>
+#include <arm_math.h>  //simply to define float32_t
+
+typedef struct {
+	uint32_t sample_count;      //when this entry was logged, counted in audio samples since the telemetry was enabled
+	float32_t input_dB;         //input level (for the WDRC compressors, this is dB SPL.  For AudioEffectCompressor_F32, it is dBFS)
+	float32_t gain_dB;          //gain that was being applied
+	float32_t output_dB;        //output level (ie, input_dB + gain_dB)
+} gain_telemetry_t;
+
+class GainTelemetry_F32 {
+	public:
+		static const int RING_LEN = 64;               //number of entries in the ring.  Must be a power of two.
+		static const int MIN_DECIMATION = 16;         //fastest allowed logging is once every this many samples
+		static const int MAX_PER_BLOCK = 16;          //most entries in any MIN_DECIMATION*MAX_PER_BLOCK samples.  Longer blocks must be logged in segments
+
+		// ///////////////////////////////////  Configuration (call from the main loop)
+
+		//Start logging at the given rate.  This also empties the ring.  The audio interrupt is blocked while
+		//the writer's counters are reset so that it never sees them half-changed.
+		void enable(float32_t rate_Hz, float32_t sample_rate_Hz) {
+			int decim = (int)(sample_rate_Hz / rate_Hz + 0.5f);
+			if (decim < MIN_DECIMATION) decim = MIN_DECIMATION;
+			__disable_irq();
+			decimation = decim;
+			samples_until_next = 0;  sample_count = 0;
+			tail = head;  n_dropped = 0;
+			is_enabled = true;
+			__enable_irq();
+		}
+		void disable(void) { is_enabled = false; }
+		bool get_is_enabled(void) { return is_enabled; }
+		int getDecimation(void) { return decimation; }
+		float32_t getRate_Hz(float32_t sample_rate_Hz) { return sample_rate_Hz / (float32_t)decimation; }
+
+		// ///////////////////////////////////  Reading (call from the main loop)
+
+		//number of entries waiting to be read
+		int available(void) { return (int)(head - tail); }
+
+		//copy out up to max_n entries (oldest first).  Returns the number of entries copied.
+		int read(gain_telemetry_t *out, int max_n) {
+			uint32_t h = head;  //snapshot of where the writer is
+			__asm__ volatile ("" ::: "memory");  //read the entries only after reading head
+			int n = 0;
+			uint32_t t = tail;
+			while ((t != h) && (n < max_n)) out[n++] = ring[(t++) & (RING_LEN-1)];
+			__asm__ volatile ("" ::: "memory");  //finish reading the entries before releasing them to the writer
+			tail = t;
+			return n;
+		}
+
+		//number of entries that were lost because the ring was full
+		uint32_t getNumDropped(void) { return n_dropped; }
+
+		// ///////////////////////////////////  Writing (called from the audio processing)
+
+		//index (within the current audio block) of the first sample to be logged.  It might be beyond the end of the block.
+		int firstIndex(void) { return is_enabled ? samples_until_next : 0x7FFFFFFF; }
+
+		//log one entry.  k is the index of the sample within the current audio block.
+		void push(int k, float32_t input_dB, float32_t gain_dB) {
+			uint32_t h = head;
+			if ((h - tail) >= (uint32_t)RING_LEN) { n_dropped++; return; }  //full!  drop this entry
+			gain_telemetry_t *entry = &(ring[h & (RING_LEN-1)]);
+			entry->sample_count = sample_count + k;
+			entry->input_dB = input_dB;  entry->gain_dB = gain_dB;  entry->output_dB = input_dB + gain_dB;
+			__asm__ volatile ("" ::: "memory");  //fill in the entry before publishing it
+			head = h + 1;
+		}
+
+		//call once at the end of each audio block of n samples
+		void advance(int n) {
+			if (!is_enabled) return;
+			int k = samples_until_next - n;
+			while (k < 0) k += decimation;
+			samples_until_next = k;
+			sample_count += n;
+		}
+
+	protected:
+		gain_telemetry_t ring[RING_LEN];
+		volatile uint32_t head = 0;       //only changed by the writer
+		volatile uint32_t tail = 0;       //only changed by the reader
+		volatile uint32_t n_dropped = 0;
+		volatile bool is_enabled = false;
+		int decimation = 240;             //samples per entry.  Default is 100 Hz at 24 kHz
+		int samples_until_next = 0;
+		uint32_t sample_count = 0;
+};
+
+#endif